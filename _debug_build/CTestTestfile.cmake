@@ -0,0 +1,13 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_debug_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("src/median")
+subdirs("src/events")
+subdirs("src/output")
+subdirs("src/pipeline")
+subdirs("src/app")
+subdirs("tests")
+subdirs("performance")
@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/performance/AllocationCounter.cpp" "performance/CMakeFiles/running_median_benchmark.dir/AllocationCounter.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/AllocationCounter.cpp.o.d"
+  "/root/repo/performance/CountingMedianBenchmark.cpp" "performance/CMakeFiles/running_median_benchmark.dir/CountingMedianBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/CountingMedianBenchmark.cpp.o.d"
+  "/root/repo/performance/DistributionBenchmark.cpp" "performance/CMakeFiles/running_median_benchmark.dir/DistributionBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/DistributionBenchmark.cpp.o.d"
+  "/root/repo/performance/LargeHeapBenchmark.cpp" "performance/CMakeFiles/running_median_benchmark.dir/LargeHeapBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/LargeHeapBenchmark.cpp.o.d"
+  "/root/repo/performance/ParallelMedianBenchmark.cpp" "performance/CMakeFiles/running_median_benchmark.dir/ParallelMedianBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/ParallelMedianBenchmark.cpp.o.d"
+  "/root/repo/performance/RunningMedianBenchmarkMain.cpp" "performance/CMakeFiles/running_median_benchmark.dir/RunningMedianBenchmarkMain.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/RunningMedianBenchmarkMain.cpp.o.d"
+  "/root/repo/performance/SnapshotBenchmark.cpp" "performance/CMakeFiles/running_median_benchmark.dir/SnapshotBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_benchmark.dir/SnapshotBenchmark.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
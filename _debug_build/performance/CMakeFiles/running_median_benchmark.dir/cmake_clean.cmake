@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/running_median_benchmark.dir/AllocationCounter.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/AllocationCounter.cpp.o.d"
+  "CMakeFiles/running_median_benchmark.dir/CountingMedianBenchmark.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/CountingMedianBenchmark.cpp.o.d"
+  "CMakeFiles/running_median_benchmark.dir/DistributionBenchmark.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/DistributionBenchmark.cpp.o.d"
+  "CMakeFiles/running_median_benchmark.dir/LargeHeapBenchmark.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/LargeHeapBenchmark.cpp.o.d"
+  "CMakeFiles/running_median_benchmark.dir/ParallelMedianBenchmark.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/ParallelMedianBenchmark.cpp.o.d"
+  "CMakeFiles/running_median_benchmark.dir/RunningMedianBenchmarkMain.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/RunningMedianBenchmarkMain.cpp.o.d"
+  "CMakeFiles/running_median_benchmark.dir/SnapshotBenchmark.cpp.o"
+  "CMakeFiles/running_median_benchmark.dir/SnapshotBenchmark.cpp.o.d"
+  "running_median_benchmark"
+  "running_median_benchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/running_median_benchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/running_median_cli_benchmark.dir/CliBenchmarkMain.cpp.o"
+  "CMakeFiles/running_median_cli_benchmark.dir/CliBenchmarkMain.cpp.o.d"
+  "running_median_cli_benchmark"
+  "running_median_cli_benchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/running_median_cli_benchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
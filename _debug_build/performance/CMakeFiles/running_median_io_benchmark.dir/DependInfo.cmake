@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/performance/EventLoopBenchmarkMain.cpp" "performance/CMakeFiles/running_median_io_benchmark.dir/EventLoopBenchmarkMain.cpp.o" "gcc" "performance/CMakeFiles/running_median_io_benchmark.dir/EventLoopBenchmarkMain.cpp.o.d"
+  "/root/repo/performance/MedianOutputBenchmark.cpp" "performance/CMakeFiles/running_median_io_benchmark.dir/MedianOutputBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_io_benchmark.dir/MedianOutputBenchmark.cpp.o.d"
+  "/root/repo/performance/ShardedPipelineBenchmark.cpp" "performance/CMakeFiles/running_median_io_benchmark.dir/ShardedPipelineBenchmark.cpp.o" "gcc" "performance/CMakeFiles/running_median_io_benchmark.dir/ShardedPipelineBenchmark.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/running_median_io_benchmark.dir/EventLoopBenchmarkMain.cpp.o"
+  "CMakeFiles/running_median_io_benchmark.dir/EventLoopBenchmarkMain.cpp.o.d"
+  "CMakeFiles/running_median_io_benchmark.dir/MedianOutputBenchmark.cpp.o"
+  "CMakeFiles/running_median_io_benchmark.dir/MedianOutputBenchmark.cpp.o.d"
+  "CMakeFiles/running_median_io_benchmark.dir/ShardedPipelineBenchmark.cpp.o"
+  "CMakeFiles/running_median_io_benchmark.dir/ShardedPipelineBenchmark.cpp.o.d"
+  "running_median_io_benchmark"
+  "running_median_io_benchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/running_median_io_benchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,7 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/performance
+# Build directory: /root/repo/_debug_build/performance
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("../third_party/benchmark")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/running_median.dir/RunningMedianMain.cpp.o"
+  "CMakeFiles/running_median.dir/RunningMedianMain.cpp.o.d"
+  "running_median"
+  "running_median.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/running_median.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
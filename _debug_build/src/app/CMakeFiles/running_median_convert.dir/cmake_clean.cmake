@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/running_median_convert.dir/EventConverterMain.cpp.o"
+  "CMakeFiles/running_median_convert.dir/EventConverterMain.cpp.o.d"
+  "running_median_convert"
+  "running_median_convert.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/running_median_convert.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,48 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/events/BinaryEventLoopUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/events/BinaryEventLoopUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/events/BinaryEventLoopUnitTest.cpp.o.d"
+  "/root/repo/tests/events/BufferedEventLoopUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/events/BufferedEventLoopUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/events/BufferedEventLoopUnitTest.cpp.o.d"
+  "/root/repo/tests/events/EventLoopUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/events/EventLoopUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/events/EventLoopUnitTest.cpp.o.d"
+  "/root/repo/tests/median/AllocatorsUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/AllocatorsUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/AllocatorsUnitTest.cpp.o.d"
+  "/root/repo/tests/median/CountingMedianCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/CountingMedianCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/CountingMedianCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/HeapStorageTypeTraitsUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/HeapStorageTypeTraitsUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/HeapStorageTypeTraitsUnitTest.cpp.o.d"
+  "/root/repo/tests/median/HeapStorageUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/HeapStorageUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/HeapStorageUnitTest.cpp.o.d"
+  "/root/repo/tests/median/HeapUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/HeapUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/HeapUnitTest.cpp.o.d"
+  "/root/repo/tests/median/IndexedHeapUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/IndexedHeapUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/IndexedHeapUnitTest.cpp.o.d"
+  "/root/repo/tests/median/KeyedMedianEngineUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/KeyedMedianEngineUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/KeyedMedianEngineUnitTest.cpp.o.d"
+  "/root/repo/tests/median/LazyMedianCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/LazyMedianCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/LazyMedianCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/MappedAllocatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/MappedAllocatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/MappedAllocatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/MedianCalculatorRegressionTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/MedianCalculatorRegressionTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/MedianCalculatorRegressionTest.cpp.o.d"
+  "/root/repo/tests/median/MedianCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/MedianCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/MedianCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/MinMaxHeapUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/MinMaxHeapUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/MinMaxHeapUnitTest.cpp.o.d"
+  "/root/repo/tests/median/ParallelMedianUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/ParallelMedianUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/ParallelMedianUnitTest.cpp.o.d"
+  "/root/repo/tests/median/QuantileCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/QuantileCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/QuantileCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/RadixMedianUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/RadixMedianUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/RadixMedianUnitTest.cpp.o.d"
+  "/root/repo/tests/median/SketchMedianCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/SketchMedianCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/SketchMedianCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/SnapshotUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/SnapshotUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/SnapshotUnitTest.cpp.o.d"
+  "/root/repo/tests/median/StatsUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/StatsUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/StatsUnitTest.cpp.o.d"
+  "/root/repo/tests/median/TimeWindowMedianCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/TimeWindowMedianCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/TimeWindowMedianCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/median/WindowMedianCalculatorUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/median/WindowMedianCalculatorUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/median/WindowMedianCalculatorUnitTest.cpp.o.d"
+  "/root/repo/tests/output/BufferedWriterUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/output/BufferedWriterUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/output/BufferedWriterUnitTest.cpp.o.d"
+  "/root/repo/tests/output/DoubleFormatterUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/output/DoubleFormatterUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/output/DoubleFormatterUnitTest.cpp.o.d"
+  "/root/repo/tests/pipeline/ShardedMedianPipelineUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/pipeline/ShardedMedianPipelineUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/pipeline/ShardedMedianPipelineUnitTest.cpp.o.d"
+  "/root/repo/tests/pipeline/SpscQueueUnitTest.cpp" "tests/CMakeFiles/running_median_tests.dir/pipeline/SpscQueueUnitTest.cpp.o" "gcc" "tests/CMakeFiles/running_median_tests.dir/pipeline/SpscQueueUnitTest.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_debug_build/third_party/googletest/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  "/root/repo/_debug_build/third_party/googletest/googlemock/CMakeFiles/gmock.dir/DependInfo.cmake"
+  "/root/repo/_debug_build/third_party/googletest/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
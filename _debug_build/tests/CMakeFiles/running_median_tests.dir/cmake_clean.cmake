@@ -0,0 +1,63 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/running_median_tests.dir/events/BinaryEventLoopUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/events/BinaryEventLoopUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/events/BufferedEventLoopUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/events/BufferedEventLoopUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/events/EventLoopUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/events/EventLoopUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/AllocatorsUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/AllocatorsUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/CountingMedianCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/CountingMedianCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/HeapStorageTypeTraitsUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/HeapStorageTypeTraitsUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/HeapStorageUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/HeapStorageUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/HeapUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/HeapUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/IndexedHeapUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/IndexedHeapUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/KeyedMedianEngineUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/KeyedMedianEngineUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/LazyMedianCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/LazyMedianCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/MappedAllocatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/MappedAllocatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/MedianCalculatorRegressionTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/MedianCalculatorRegressionTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/MedianCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/MedianCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/MinMaxHeapUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/MinMaxHeapUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/ParallelMedianUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/ParallelMedianUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/QuantileCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/QuantileCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/RadixMedianUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/RadixMedianUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/SketchMedianCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/SketchMedianCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/SnapshotUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/SnapshotUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/StatsUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/StatsUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/TimeWindowMedianCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/TimeWindowMedianCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/median/WindowMedianCalculatorUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/median/WindowMedianCalculatorUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/output/BufferedWriterUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/output/BufferedWriterUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/output/DoubleFormatterUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/output/DoubleFormatterUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/pipeline/ShardedMedianPipelineUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/pipeline/ShardedMedianPipelineUnitTest.cpp.o.d"
+  "CMakeFiles/running_median_tests.dir/pipeline/SpscQueueUnitTest.cpp.o"
+  "CMakeFiles/running_median_tests.dir/pipeline/SpscQueueUnitTest.cpp.o.d"
+  "running_median_tests"
+  "running_median_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/running_median_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,102 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> bytes{0};
+
+void* allocate(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* allocated = std::malloc(size == 0 ? 1 : size))
+    {
+        return allocated;
+    }
+    throw std::bad_alloc{};
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* allocated) noexcept
+{
+    std::free(allocated);
+}
+
+void operator delete[](void* allocated) noexcept
+{
+    std::free(allocated);
+}
+
+void operator delete(void* allocated, std::size_t) noexcept
+{
+    std::free(allocated);
+}
+
+void operator delete[](void* allocated, std::size_t) noexcept
+{
+    std::free(allocated);
+}
+
+namespace tplx
+{
+namespace perf
+{
+
+std::size_t allocationCount() noexcept
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t allocatedBytes() noexcept
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+
+void resetPeakResidentBytes() noexcept
+{
+    // writing 5 to clear_refs resets the peak resident set size (VmHWM)
+    if (auto file = std::fopen("/proc/self/clear_refs", "w"))
+    {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+}
+
+std::size_t peakResidentBytes() noexcept
+{
+    std::size_t peak = 0;
+    if (auto file = std::fopen("/proc/self/status", "r"))
+    {
+        char line[256];
+        while (std::fgets(line, sizeof(line), file))
+        {
+            if (std::strncmp(line, "VmHWM:", 6) == 0)
+            {
+                peak = std::strtoull(line + 6, nullptr, 10) * 1024;
+                break;
+            }
+        }
+        std::fclose(file);
+    }
+    return peak;
+}
+
+} // namespace perf
+} // namespace tplx
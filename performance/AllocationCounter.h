@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace tplx
+{
+namespace perf
+{
+
+/**
+    \brief Number of dynamic allocations (operator new and new[]) made by the process so far.
+        Counted by the replacement of the global allocation functions linked into the benchmark application.
+        NOTE: Memory obtained by other means is invisible to the counter: mmap() mappings of MappedAllocator
+        (blocks above its threshold) and of ReservedAllocator are not counted at all, while for MonotonicArena
+        and SizeClassPool only their slabs (and blocks too big to be pooled) are counted, not the blocks they
+        serve from them.
+        Compare peakResidentBytes() when benchmarking calculators using those allocators.
+ */
+std::size_t allocationCount() noexcept;
+
+/// \brief Number of bytes requested by the dynamic allocations made by the process so far (see allocationCount()).
+std::size_t allocatedBytes() noexcept;
+
+/**
+    \brief Resets the peak resident set size of the process, so peakResidentBytes() reports the peak
+        reached since the call (Linux only).
+ */
+void resetPeakResidentBytes() noexcept;
+
+/// \brief Returns peak resident set size of the process in bytes (Linux only, 0 elsewhere).
+std::size_t peakResidentBytes() noexcept;
+
+} // namespace perf
+} // namespace tplx
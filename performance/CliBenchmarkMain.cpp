@@ -0,0 +1,223 @@
+#include "PerfCounters.h"
+#include "ValueGenerators.h"
+#include "app/MedianCalculatingEventListener.h"
+#include "events/BufferedEventLoop.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+
+namespace
+{
+
+using namespace tplx;
+using namespace tplx::perf;
+
+/// \brief Stream buffer discarding written characters, so the results do not depend on the output device.
+class NullStreamBuffer : public std::streambuf
+{
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        return count;
+    }
+    int_type overflow(int_type ch) override
+    {
+        return ch;
+    }
+};
+
+/// \brief Generates input sequence of the main application, e.g. "3 5 m 8 m 6 m q".
+class InputTextGenerator
+{
+public:
+    explicit InputTextGenerator(unsigned valuesPerQuery)
+        : generator_{default_seed}, values_{1, 1000000000}, valuesPerQuery_{valuesPerQuery}, events_{0}
+    {
+    }
+
+    /// \brief Appends events to \a out until it grows by at least \a bytes characters.
+    void append(std::string& out, std::size_t bytes)
+    {
+        const auto size = out.size() + bytes;
+        while (out.size() < size)
+        {
+            out += std::to_string(values_(generator_));
+            out += ' ';
+            ++events_;
+            if (generator_() % valuesPerQuery_ == 0)
+            {
+                out += "m ";
+                ++events_;
+            }
+        }
+    }
+
+    /// \brief Returns number of so far generated events.
+    std::size_t events() const
+    {
+        return events_;
+    }
+
+private:
+    std::mt19937 generator_;
+    std::uniform_int_distribution<int> values_;
+    unsigned valuesPerQuery_;
+    std::size_t events_;
+};
+
+struct Options
+{
+    std::size_t inputMegabytes = 64;
+    bool perfCounters = false;
+    const char* generatedFile = nullptr;
+    unsigned valuesPerQuery = 4;
+};
+
+Options options;
+
+/**
+    \brief Runs the listener of the main application over state.range(0) values per median request and
+        reports parsing throughput (bytes and events per second).
+ */
+void BM_Cli_throughput(benchmark::State& state)
+{
+    InputTextGenerator generator{static_cast<unsigned>(state.range(0))};
+    std::string input;
+    input.reserve(options.inputMegabytes * 1024 * 1024 + 32);
+    generator.append(input, options.inputMegabytes * 1024 * 1024);
+    input += 'q';
+    const auto events = generator.events() + 1;
+
+    PerfCounters counters;
+    const bool counting = options.perfCounters and counters.available();
+    std::uint64_t totals[PerfCounters::counters_count] = {};
+    for (auto _ : state)
+    {
+        NullStreamBuffer buffer;
+        std::ostream out{&buffer};
+        MedianCalculatingEventListener listener{out};
+        if (counting)
+        {
+            counters.start();
+        }
+        runEventLoop(input.data(), input.data() + input.size(), listener);
+        listener.flush();
+        if (counting)
+        {
+            counters.stop();
+            for (int i = 0; i < PerfCounters::counters_count; i++)
+            {
+                totals[i] += counters.read(static_cast<PerfCounters::Counter>(i));
+            }
+        }
+    }
+    const auto processedEvents = static_cast<double>(events) * static_cast<double>(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+    state.counters["events_per_second"] = benchmark::Counter(processedEvents, benchmark::Counter::kIsRate);
+    if (counting)
+    {
+        state.counters["cycles_per_event"] = static_cast<double>(totals[PerfCounters::cycles]) / processedEvents;
+        state.counters["instructions_per_event"] =
+            static_cast<double>(totals[PerfCounters::instructions]) / processedEvents;
+        state.counters["cache_misses_per_event"] =
+            static_cast<double>(totals[PerfCounters::cache_misses]) / processedEvents;
+        state.counters["branch_misses_per_event"] =
+            static_cast<double>(totals[PerfCounters::branch_misses]) / processedEvents;
+    }
+}
+
+/// \brief Writes generated input of the given size to the file in chunks, so it may exceed available memory.
+int generateInputFile(const char* path, std::size_t megabytes, unsigned valuesPerQuery)
+{
+    auto file = std::fopen(path, "wb");
+    if (not file)
+    {
+        std::perror(path);
+        return 1;
+    }
+    constexpr std::size_t chunk_megabytes = 16;
+    InputTextGenerator generator{valuesPerQuery};
+    std::string chunk;
+    for (std::size_t written = 0; written < megabytes; written += chunk_megabytes)
+    {
+        chunk.clear();
+        const auto remaining = megabytes - written;
+        generator.append(chunk, (remaining < chunk_megabytes ? remaining : chunk_megabytes) * 1024 * 1024);
+        std::fwrite(chunk.data(), 1, chunk.size(), file);
+    }
+    std::fputs("q\n", file);
+    std::fclose(file);
+    std::cout << "generated " << generator.events() + 1 << " events" << std::endl;
+    return 0;
+}
+
+const char* optionValue(const char* argument, const char* name)
+{
+    const auto length = std::strlen(name);
+    return std::strncmp(argument, name, length) == 0 and argument[length] == '=' ? argument + length + 1 : nullptr;
+}
+
+bool parseOptions(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (auto value = optionValue(argv[i], "--input_mb"))
+        {
+            options.inputMegabytes = std::strtoul(value, nullptr, 10);
+        }
+        else if (auto value = optionValue(argv[i], "--generate"))
+        {
+            options.generatedFile = value;
+        }
+        else if (auto value = optionValue(argv[i], "--values_per_query"))
+        {
+            options.valuesPerQuery = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--perf_counters") == 0)
+        {
+            options.perfCounters = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.inputMegabytes > 0 and options.valuesPerQuery > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (not parseOptions(argc, argv))
+    {
+        std::cerr << "usage: running_median_cli_benchmark [benchmark options] [--input_mb=N] [--perf_counters]\n"
+                     "       running_median_cli_benchmark --generate=FILE [--input_mb=N] [--values_per_query=N]"
+                  << std::endl;
+        return 1;
+    }
+    if (options.generatedFile)
+    {
+        return generateInputFile(options.generatedFile, options.inputMegabytes, options.valuesPerQuery);
+    }
+    if (options.perfCounters and not PerfCounters{}.available())
+    {
+        std::cerr << "perf counters are not available, only throughput is reported" << std::endl;
+    }
+    benchmark::RegisterBenchmark("BM_Cli_throughput", BM_Cli_throughput)
+        ->ArgName("values_per_query")
+        ->Arg(1)
+        ->Arg(4)
+        ->Arg(16)
+        ->Arg(64)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "median/CountingMedianCalculator.h"
+#include "median/MedianCalculator.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace tplx;
+
+/// \brief Upper bound of the declared value range (e.g. latencies in milliseconds).
+constexpr int max_value = 65535;
+
+std::vector<int> generateValues(std::size_t count)
+{
+    std::vector<int> values(count);
+    std::mt19937 generator{2019};
+    std::uniform_int_distribution<int> distribution{0, max_value};
+    for (auto& value : values)
+    {
+        value = distribution(generator);
+    }
+    return values;
+}
+
+/// \brief Adds state.range(0) values of the declared range to the calculator, queries the median at the end.
+template <typename Calculator, typename... Args>
+void BM_add(benchmark::State& state, Args... args)
+{
+    const auto values = generateValues(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        Calculator calculator{args...};
+        for (auto value : values)
+        {
+            calculator.add(value);
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief Queries the median of state.range(0) values after each added value.
+template <typename Calculator, typename... Args>
+void BM_add_and_calculate(benchmark::State& state, Args... args)
+{
+    const auto values = generateValues(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        Calculator calculator{args...};
+        for (auto value : values)
+        {
+            calculator.add(value);
+            benchmark::DoNotOptimize(calculator.calculate());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+void BM_MedianCalc_add(benchmark::State& state)
+{
+    BM_add<MedianCalculator<int>>(state);
+}
+
+void BM_CountingMedianCalc_add(benchmark::State& state)
+{
+    BM_add<CountingMedianCalculator<int>>(state, 0, max_value);
+}
+
+void BM_MedianCalc_add_and_calculate(benchmark::State& state)
+{
+    BM_add_and_calculate<MedianCalculator<int>>(state);
+}
+
+void BM_CountingMedianCalc_add_and_calculate(benchmark::State& state)
+{
+    BM_add_and_calculate<CountingMedianCalculator<int>>(state, 0, max_value);
+}
+
+BENCHMARK(BM_MedianCalc_add)->RangeMultiplier(100)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountingMedianCalc_add)->RangeMultiplier(100)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MedianCalc_add_and_calculate)
+    ->RangeMultiplier(100)
+    ->Range(10000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountingMedianCalc_add_and_calculate)
+    ->RangeMultiplier(100)
+    ->Range(10000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
@@ -0,0 +1,111 @@
+#include "AllocationCounter.h"
+#include "ValueGenerators.h"
+#include "median/MedianCalculator.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace tplx;
+using namespace tplx::perf;
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Values are generated in chunks outside of the measured time.
+constexpr std::size_t chunk_size = 64 * 1024;
+
+/// \brief Number of median requests following each chunk of values.
+constexpr std::size_t queries_per_chunk = 64;
+
+/**
+    \brief Streams state.range(0) values of the given distribution through MedianCalculator.
+        Reports time per added value and per median request, number of allocations and peak resident
+        memory of a single run.
+ */
+void BM_MedianCalc_distribution(benchmark::State& state, Distribution distribution)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<int> chunk(count < chunk_size ? count : chunk_size);
+    Clock::duration adding{};
+    Clock::duration querying{};
+    std::size_t queries = 0;
+    std::size_t allocations = 0;
+    std::size_t peakResident = 0;
+    for (auto _ : state)
+    {
+        ValueGenerator generator{distribution};
+        resetPeakResidentBytes();
+        const auto allocationsBefore = allocationCount();
+        Clock::duration iteration{};
+        {
+            MedianCalculator<int> calculator;
+            for (std::size_t done = 0; done < count; done += chunk.size())
+            {
+                if (count - done < chunk.size())
+                {
+                    chunk.resize(count - done);
+                }
+                generator.fill(chunk.data(), chunk.data() + chunk.size());
+                const auto start = Clock::now();
+                for (auto value : chunk)
+                {
+                    calculator.add(value);
+                }
+                const auto added = Clock::now();
+                for (std::size_t i = 0; i < queries_per_chunk; i++)
+                {
+                    benchmark::DoNotOptimize(calculator.calculate());
+                    benchmark::ClobberMemory();
+                }
+                const auto queried = Clock::now();
+                adding += added - start;
+                querying += queried - added;
+                iteration += queried - start;
+                queries += queries_per_chunk;
+            }
+        }
+        allocations = allocationCount() - allocationsBefore;
+        peakResident = peakResidentBytes();
+        chunk.resize(count < chunk_size ? count : chunk_size);
+        state.SetIterationTime(std::chrono::duration<double>(iteration).count());
+    }
+    const auto adds = static_cast<double>(state.iterations()) * static_cast<double>(count);
+    state.counters["ns_per_add"] = static_cast<double>(std::chrono::nanoseconds(adding).count()) / adds;
+    state.counters["ns_per_query"] =
+        static_cast<double>(std::chrono::nanoseconds(querying).count()) / static_cast<double>(queries);
+    state.counters["allocations"] = static_cast<double>(allocations);
+    state.counters["peak_rss_MB"] = static_cast<double>(peakResident) / (1024 * 1024);
+    state.SetItemsProcessed(static_cast<int64_t>(adds));
+}
+
+/**
+    \brief Registers the benchmark for each distribution and stream sizes from 1e3 up to the limit given by
+        RUNNING_MEDIAN_MAX_STREAM_SIZE environment variable (1e8 by default, 1e9 needs about 8 GB of memory).
+ */
+int registerDistributionBenchmarks()
+{
+    const auto limit = std::getenv("RUNNING_MEDIAN_MAX_STREAM_SIZE");
+    const auto maxStreamSize = limit ? std::strtoll(limit, nullptr, 10) : 100000000LL;
+    const Distribution distributions[] = {Distribution::sorted, Distribution::reverse_sorted,
+                                          Distribution::alternating, Distribution::zipf,
+                                          Distribution::duplicates, Distribution::normal,
+                                          Distribution::uniform};
+    for (auto distribution : distributions)
+    {
+        const auto name = std::string{"BM_MedianCalc_distribution/"} + toString(distribution);
+        benchmark::RegisterBenchmark(name.c_str(), BM_MedianCalc_distribution, distribution)
+            ->RangeMultiplier(10)
+            ->Range(1000, maxStreamSize)
+            ->UseManualTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    return 0;
+}
+
+const int registered = registerDistributionBenchmarks();
+
+} // anonymous namespace
@@ -0,0 +1,144 @@
+#include "events/BinaryEventLoop.h"
+#include "events/BufferedEventLoop.h"
+#include "events/EventLoop.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+using namespace tplx;
+
+/// \brief Counts received events, so the parser output is not optimized away.
+class CountingEventListener : public EventListener<int>
+{
+public:
+    bool newEvent(Event<int>&& event) override
+    {
+        sum_ += event.value;
+        ++count_;
+        return true;
+    }
+    long long sum() const
+    {
+        return sum_;
+    }
+
+private:
+    long long sum_ = 0;
+    long long count_ = 0;
+};
+
+/// \brief Generates about \a size bytes of valid input, values interleaved with median requests.
+std::string generateInput(std::size_t size)
+{
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(1, 1000000000);
+    std::string input;
+    input.reserve(size + 16);
+    while(input.size() < size)
+    {
+        input += std::to_string(distribution(generator));
+        input += (generator() % 4 == 0) ? " m " : " ";
+    }
+    input += 'q';
+    return input;
+}
+
+const std::string input = generateInput(16 * 1024 * 1024);
+
+void BM_EventLoop_istream(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        std::istringstream source{input};
+        CountingEventListener listener;
+        runEventLoop(source, listener);
+        benchmark::DoNotOptimize(listener.sum());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+void BM_EventLoop_memory(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        CountingEventListener listener;
+        runEventLoop(input.data(), input.data() + input.size(), listener);
+        benchmark::DoNotOptimize(listener.sum());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+/// \brief Feeds the parser with blocks of state.range(0) bytes, as runBufferedEventLoop does for pipes.
+void BM_EventLoop_blocks(benchmark::State& state)
+{
+    const auto blockSize = static_cast<std::size_t>(state.range(0));
+    for(auto _ : state)
+    {
+        CountingEventListener listener;
+        details::EventParser<int> parser{listener};
+        for(std::size_t offset = 0; offset < input.size(); offset += blockSize)
+        {
+            const auto length = std::min(blockSize, input.size() - offset);
+            parser.parse(input.data() + offset, input.data() + offset + length);
+        }
+        parser.finish();
+        benchmark::DoNotOptimize(listener.sum());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+/// \brief Parses the input from a memory mapped temporary file.
+void BM_EventLoop_mapped_file(benchmark::State& state)
+{
+    std::FILE* file = std::tmpfile();
+    std::fwrite(input.data(), 1, input.size(), file);
+    std::fflush(file);
+    for(auto _ : state)
+    {
+        CountingEventListener listener;
+        ::lseek(fileno(file), 0, SEEK_SET);
+        runBufferedEventLoop(fileno(file), listener);
+        benchmark::DoNotOptimize(listener.sum());
+    }
+    std::fclose(file);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+/**
+    \brief Reads the input converted to the binary format from a memory mapped temporary file.
+        Processed bytes are those of the text input, so the throughput compares directly with text parsing.
+ */
+void BM_EventLoop_binary_mapped_file(benchmark::State& state)
+{
+    std::FILE* file = std::tmpfile();
+    {
+        BinaryEventWriter<int> writer{fileno(file)};
+        runEventLoop(input.data(), input.data() + input.size(), writer);
+        writer.flush();
+    }
+    for(auto _ : state)
+    {
+        CountingEventListener listener;
+        ::lseek(fileno(file), 0, SEEK_SET);
+        runBinaryEventLoop(fileno(file), listener);
+        benchmark::DoNotOptimize(listener.sum());
+    }
+    std::fclose(file);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_EventLoop_istream)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EventLoop_memory)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EventLoop_blocks)->Unit(benchmark::kMillisecond)->RangeMultiplier(16)->Range(256, 1 << 20);
+BENCHMARK(BM_EventLoop_mapped_file)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EventLoop_binary_mapped_file)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,155 @@
+#include "AllocationCounter.h"
+#include "ValueGenerators.h"
+#include "median/MappedAllocator.h"
+#include "median/MedianCalculator.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace tplx;
+using namespace tplx::perf;
+
+using Clock = std::chrono::steady_clock;
+
+/// \brief Values are generated in chunks outside of the measured time.
+constexpr std::size_t chunk_size = 64 * 1024;
+
+/// \brief Histogram of latencies with power of two buckets (bucket i counts latencies below 2^i ns).
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() : buckets_(64, 0), max_{0}
+    {
+    }
+
+    void record(std::uint64_t nanoseconds)
+    {
+        std::size_t bucket = 0;
+        while ((std::uint64_t{1} << bucket) <= nanoseconds)
+        {
+            ++bucket;
+        }
+        ++buckets_[bucket];
+        max_ = nanoseconds > max_ ? nanoseconds : max_;
+    }
+
+    /// \brief Returns upper bound of the bucket containing the given percentile.
+    double percentile(double percent) const
+    {
+        std::uint64_t total = 0;
+        for (auto count : buckets_)
+        {
+            total += count;
+        }
+        const auto rank = static_cast<double>(total) * percent / 100.0;
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < buckets_.size(); bucket++)
+        {
+            seen += buckets_[bucket];
+            if (static_cast<double>(seen) >= rank)
+            {
+                return static_cast<double>(std::uint64_t{1} << bucket);
+            }
+        }
+        return static_cast<double>(max_);
+    }
+
+    std::uint64_t max() const
+    {
+        return max_;
+    }
+
+private:
+    std::vector<std::uint64_t> buckets_;
+    std::uint64_t max_;
+};
+
+/**
+    \brief Adds state.range(0) uniformly distributed values to MedianCalculator using the given allocation
+        policy and times each add() separately. The tail of the latency distribution is dominated by growing
+        the heaps, which copies the whole buffer unless the policy resizes it in place or, with
+        ReservedAllocator, just extends the accessible part of the buffer.
+ */
+template <typename Allocator>
+void BM_MedianCalc_large(benchmark::State& state, Allocator allocator)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<int> chunk(count < chunk_size ? count : chunk_size);
+    LatencyHistogram latencies;
+    std::size_t peakResident = 0;
+    for (auto _ : state)
+    {
+        ValueGenerator generator{Distribution::uniform};
+        resetPeakResidentBytes();
+        Clock::duration iteration{};
+        {
+            MedianCalculator<int, Allocator> calculator{allocator};
+            for (std::size_t done = 0; done < count; done += chunk.size())
+            {
+                if (count - done < chunk.size())
+                {
+                    chunk.resize(count - done);
+                }
+                generator.fill(chunk.data(), chunk.data() + chunk.size());
+                for (auto value : chunk)
+                {
+                    const auto start = Clock::now();
+                    calculator.add(value);
+                    const auto latency = Clock::now() - start;
+                    iteration += latency;
+                    latencies.record(static_cast<std::uint64_t>(std::chrono::nanoseconds(latency).count()));
+                }
+            }
+            benchmark::DoNotOptimize(calculator.calculate());
+        }
+        peakResident = peakResidentBytes();
+        chunk.resize(count < chunk_size ? count : chunk_size);
+        state.SetIterationTime(std::chrono::duration<double>(iteration).count());
+    }
+    state.counters["p50_ns"] = latencies.percentile(50);
+    state.counters["p99.99_ns"] = latencies.percentile(99.99);
+    state.counters["max_ms"] = static_cast<double>(latencies.max()) / 1e6;
+    state.counters["peak_rss_MB"] = static_cast<double>(peakResident) / (1024 * 1024);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(count));
+}
+
+/**
+    \brief Registers the benchmark for the global allocator, for mapped storage with and without huge pages
+        and for reserved storage, stream sizes go from 1e6 up to RUNNING_MEDIAN_MAX_STREAM_SIZE (1e8 by default).
+ */
+int registerLargeHeapBenchmarks()
+{
+    const auto limit = std::getenv("RUNNING_MEDIAN_MAX_STREAM_SIZE");
+    const auto maxStreamSize = limit ? std::strtoll(limit, nullptr, 10) : 100000000LL;
+    benchmark::RegisterBenchmark("BM_MedianCalc_large/new", BM_MedianCalc_large<NewAllocator>, NewAllocator{})
+        ->RangeMultiplier(10)
+        ->Range(1000000, maxStreamSize)
+        ->UseManualTime()
+        ->Unit(benchmark::kMillisecond);
+    for (auto hugePages : {false, true})
+    {
+        const auto name = std::string{"BM_MedianCalc_large/"} + (hugePages ? "mapped_huge_pages" : "mapped");
+        benchmark::RegisterBenchmark(name.c_str(), BM_MedianCalc_large<MappedAllocator>, MappedAllocator{hugePages})
+            ->RangeMultiplier(10)
+            ->Range(1000000, maxStreamSize)
+            ->UseManualTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+    benchmark::RegisterBenchmark("BM_MedianCalc_large/reserved", BM_MedianCalc_large<ReservedAllocator>,
+                                 ReservedAllocator{})
+        ->RangeMultiplier(10)
+        ->Range(1000000, maxStreamSize)
+        ->UseManualTime()
+        ->Unit(benchmark::kMillisecond);
+    return 0;
+}
+
+const int registered = registerLargeHeapBenchmarks();
+
+} // anonymous namespace
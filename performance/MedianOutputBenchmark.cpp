@@ -0,0 +1,148 @@
+#include "app/MedianCalculatingEventListener.h"
+#include "median/MedianCalculator.h"
+#include "output/BufferedWriter.h"
+#include <benchmark/benchmark.h>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <vector>
+
+namespace
+{
+
+/// \brief Stream buffer counting and discarding written characters, so only formatting cost is measured.
+class CountingStreamBuffer : public std::streambuf
+{
+public:
+    std::size_t written() const
+    {
+        return written_;
+    }
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        written_ += static_cast<std::size_t>(count);
+        return count;
+    }
+    int_type overflow(int_type ch) override
+    {
+        ++written_;
+        return ch;
+    }
+
+private:
+    std::size_t written_ = 0;
+};
+
+/// \brief Medians printed by a query-heavy workload, i.e. median requested after each new value.
+std::vector<double> generateMedians(std::size_t count)
+{
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(1, 1000000);
+    tplx::MedianCalculator<int> calculator;
+    std::vector<double> medians;
+    medians.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        calculator.add(distribution(generator));
+        medians.push_back(calculator.calculate());
+    }
+    return medians;
+}
+
+const std::vector<double> medians = generateMedians(1000000);
+
+void BM_MedianOutput_ostream(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        CountingStreamBuffer buffer;
+        std::ostream out{&buffer};
+        for (auto median : medians)
+        {
+            out << median << ' ';
+        }
+        benchmark::DoNotOptimize(buffer.written());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * medians.size()));
+}
+
+void BM_MedianOutput_buffered(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        CountingStreamBuffer buffer;
+        std::ostream out{&buffer};
+        {
+            tplx::BufferedWriter writer{out};
+            for (auto median : medians)
+            {
+                writer.write(median);
+                writer.write(' ');
+            }
+        }
+        benchmark::DoNotOptimize(buffer.written());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * medians.size()));
+}
+
+/**
+    \brief Events of a slowly moving stream (values of a narrow range, e.g. latencies in milliseconds) with
+        the median requested after each new value.
+ */
+std::vector<tplx::Event<int>> generateQueryEvents(std::size_t count)
+{
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(0, 100);
+    std::vector<tplx::Event<int>> events;
+    events.reserve(2 * count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        events.emplace_back(distribution(generator));
+        events.emplace_back(tplx::EventType::calculate_median);
+    }
+    return events;
+}
+
+const std::vector<tplx::Event<int>> query_events = generateQueryEvents(1000000);
+
+/// \brief Passes query_events to the listener of the main application, reports number of written bytes.
+template <typename Listener>
+void BM_MedianOutput_listener(benchmark::State& state)
+{
+    std::size_t written = 0;
+    for (auto _ : state)
+    {
+        CountingStreamBuffer buffer;
+        std::ostream out{&buffer};
+        Listener listener{out};
+        for (std::size_t i = 0; i < query_events.size(); i += tplx::default_event_batch_size)
+        {
+            const auto rest = query_events.size() - i;
+            listener.newEvents(query_events.data() + i,
+                               rest < tplx::default_event_batch_size ? rest : tplx::default_event_batch_size);
+        }
+        listener.flush();
+        written = buffer.written();
+    }
+    state.counters["bytes_written"] = static_cast<double>(written);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * query_events.size()));
+}
+
+void BM_MedianOutput_listener_every_query(benchmark::State& state)
+{
+    BM_MedianOutput_listener<tplx::MedianCalculatingEventListener>(state);
+}
+
+void BM_MedianOutput_listener_on_change(benchmark::State& state)
+{
+    BM_MedianOutput_listener<tplx::OnChangeMedianCalculatingEventListener>(state);
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_MedianOutput_ostream)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MedianOutput_buffered)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MedianOutput_listener_every_query)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MedianOutput_listener_on_change)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,132 @@
+#include "ValueGenerators.h"
+#include "median/ParallelMedian.h"
+#include "median/RadixMedian.h"
+#include "../tests/median/ReferenceMedianCalculator.h"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace tplx;
+using namespace tplx::perf;
+
+/// \brief Values of the distribution shared by benchmarks of all thread counts (generated once per stream size).
+const std::vector<int>& values(std::size_t count, Distribution distribution = Distribution::uniform)
+{
+    static std::vector<int> generated[2];
+    auto& cached = generated[distribution == Distribution::sorted ? 1 : 0];
+    if (cached.size() != count)
+    {
+        cached.resize(count);
+        ValueGenerator generator{distribution};
+        generator.fill(cached.data(), cached.data() + cached.size());
+    }
+    return cached;
+}
+
+/// \brief Calculates median of state.range(0) values by medianOf() using state.range(1) threads.
+void BM_MedianOf_parallel(benchmark::State& state)
+{
+    const auto& input = values(static_cast<std::size_t>(state.range(0)));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(medianOf(input.data(), input.data() + input.size(), threads));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief Like BM_MedianOf_parallel for ascending values (e.g. time-ordered data of offline jobs).
+void BM_MedianOf_parallel_sorted(benchmark::State& state)
+{
+    const auto& input = values(static_cast<std::size_t>(state.range(0)), Distribution::sorted);
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(medianOf(input.data(), input.data() + input.size(), threads));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief Calculates median of state.range(0) values by radixMedianOf() using state.range(1) threads.
+void BM_RadixMedianOf_parallel(benchmark::State& state)
+{
+    const auto& input = values(static_cast<std::size_t>(state.range(0)));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(radixMedianOf(input.data(), input.data() + input.size(), threads));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief One-shot median by std::nth_element, the input is copied as it is reordered.
+void BM_MedianOf_reference_nth_element(benchmark::State& state)
+{
+    const auto& input = values(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        auto copy = input;
+        benchmark::DoNotOptimize(calculateReferenceMedianValue_nth_element_based(copy));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief One-shot median by MedianCalculator, values added one by one (running median path).
+void BM_MedianOf_heap(benchmark::State& state)
+{
+    const auto& input = values(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        MedianCalculator<int> calculator;
+        for (auto value : input)
+        {
+            calculator.add(value);
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/**
+    \brief Registers benchmarks of parallel medians for 1, 2, 4, ... threads up to the number of hardware threads
+        and of the single-threaded reference and heap paths,
+        stream sizes go from 1e7 up to RUNNING_MEDIAN_MAX_STREAM_SIZE (1e8 by default, 1e9 needs ~12GB).
+ */
+int registerParallelMedianBenchmarks()
+{
+    const auto limit = std::getenv("RUNNING_MEDIAN_MAX_STREAM_SIZE");
+    const auto maxStreamSize = limit ? std::strtoll(limit, nullptr, 10) : 100000000LL;
+    const auto hardwareThreads = std::thread::hardware_concurrency();
+    for (long long size = 10000000; size <= maxStreamSize; size *= 10)
+    {
+        for (long long threads = 1; threads <= (hardwareThreads > 1 ? hardwareThreads : 1); threads *= 2)
+        {
+            benchmark::RegisterBenchmark("BM_MedianOf_parallel", BM_MedianOf_parallel)
+                ->Args({size, threads})
+                ->UseRealTime()
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("BM_MedianOf_parallel_sorted", BM_MedianOf_parallel_sorted)
+                ->Args({size, threads})
+                ->UseRealTime()
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("BM_RadixMedianOf_parallel", BM_RadixMedianOf_parallel)
+                ->Args({size, threads})
+                ->UseRealTime()
+                ->Unit(benchmark::kMillisecond);
+        }
+        benchmark::RegisterBenchmark("BM_MedianOf_reference_nth_element", BM_MedianOf_reference_nth_element)
+            ->Arg(size)
+            ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("BM_MedianOf_heap", BM_MedianOf_heap)->Arg(size)->Unit(benchmark::kMillisecond);
+    }
+    return 0;
+}
+
+const int registered = registerParallelMedianBenchmarks();
+
+} // anonymous namespace
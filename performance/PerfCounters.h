@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tplx
+{
+namespace perf
+{
+
+/**
+    \brief Hardware performance counters of the calling thread read with perf_event_open (Linux only).
+        Counting may be unavailable (e.g. no PMU access in virtual machines or restrictive
+        /proc/sys/kernel/perf_event_paranoid), which is reported by available().
+ */
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        cycles,
+        instructions,
+        cache_misses,
+        branch_misses,
+        counters_count
+    };
+
+    PerfCounters() noexcept
+    {
+        const std::uint64_t configs[counters_count] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                       PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < counters_count; i++)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            descriptors_[i] = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+        for (auto descriptor : descriptors_)
+        {
+            if (descriptor >= 0)
+            {
+                ::close(descriptor);
+            }
+        }
+    }
+
+    /// \brief Returns true if all counters could be opened.
+    bool available() const noexcept
+    {
+        for (auto descriptor : descriptors_)
+        {
+            if (descriptor < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Resets and starts all counters.
+    void start() noexcept
+    {
+        for (auto descriptor : descriptors_)
+        {
+            ::ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    /// \brief Stops all counters.
+    void stop() noexcept
+    {
+        for (auto descriptor : descriptors_)
+        {
+            ::ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    /// \brief Returns value of the counter collected between start() and stop().
+    std::uint64_t read(Counter counter) const noexcept
+    {
+        std::uint64_t value = 0;
+        if (::read(descriptors_[counter], &value, sizeof(value)) != sizeof(value))
+        {
+            return 0;
+        }
+        return value;
+    }
+
+private:
+    int descriptors_[counters_count];
+};
+
+} // namespace perf
+} // namespace tplx
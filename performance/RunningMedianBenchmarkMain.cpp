@@ -1,14 +1,21 @@
+#include "median/KeyedMedianEngine.h"
 #include "median/MedianCalculator.h"
+#include "median/QuantileCalculator.h"
+#include "median/SketchMedianCalculator.h"
+#include "median/WindowMedianCalculator.h"
 #include "../tests/median/ReferenceMedianCalculator.h"
+#include "ValueGenerators.h"
 #include <benchmark/benchmark.h>
+#include <fstream>
 #include <vector>
 #include <random>
+#include <unordered_map>
 
 template<typename T>
 std::vector<T> generate_random_numbers(T from, T to, std::size_t amount)
 {
-    std::random_device rd;
-    std::mt19937 generator(rd());
+    // fixed seed keeps runs reproducible
+    std::mt19937 generator(tplx::perf::default_seed);
     std::uniform_int_distribution<> distribution(from, to);
 
     std::vector<T> generated;
@@ -83,6 +90,347 @@ void BM_MedianCalc_nth_element(benchmark::State& state, Args ... args)
     }
 }
 
+void BM_WindowMedianCalc(benchmark::State& state)
+{
+    const auto windowSize = static_cast<std::size_t>(state.range(0));
+    const auto numbers = generate_random_numbers(-10000, 10000, windowSize * 2);
+    tplx::WindowMedianCalculator<int> calculator{windowSize};
+    for (auto number : numbers)
+    {
+        calculator.add(number);
+    }
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        calculator.add(numbers[next]);
+        benchmark::DoNotOptimize(calculator.calculate());
+        next = (next + 1 == numbers.size()) ? 0 : next + 1;
+    }
+}
+
+const double benchmarked_quantiles[] = {0.5, 0.9, 0.99, 0.999, 0.1, 0.25, 0.75, 0.95};
+
+/// \brief Single QuantileCalculator tracking state.range(0) quantiles on one shared set of values.
+void BM_QuantileCalc_shared(benchmark::State& state)
+{
+    const auto quantiles = static_cast<std::size_t>(state.range(0));
+    tplx::QuantileCalculator<int> calculator{benchmarked_quantiles, benchmarked_quantiles + quantiles};
+    for (auto number : _100000_numbers)
+    {
+        calculator.add(number);
+    }
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        calculator.add(_10000_numbers[next]);
+        benchmark::DoNotOptimize(calculator.calculate(benchmarked_quantiles[0]));
+        next = (next + 1 == _10000_numbers.size()) ? 0 : next + 1;
+    }
+}
+
+/// \brief One pair of heaps per quantile (state.range(0) independent MedianCalculator objects).
+void BM_QuantileCalc_separate(benchmark::State& state)
+{
+    const auto quantiles = static_cast<std::size_t>(state.range(0));
+    std::vector<tplx::MedianCalculator<int>> calculators(quantiles);
+    for (auto& calculator : calculators)
+    {
+        for (auto number : _100000_numbers)
+        {
+            calculator.add(number);
+        }
+    }
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        for (auto& calculator : calculators)
+        {
+            calculator.add(_10000_numbers[next]);
+        }
+        benchmark::DoNotOptimize(calculators.front().calculate());
+        next = (next + 1 == _10000_numbers.size()) ? 0 : next + 1;
+    }
+}
+
+/// \brief Returns resident set size of the process (Linux only, 0 elsewhere).
+std::size_t residentMemoryBytes()
+{
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * 4096;
+}
+
+/// \brief Streams state.range(0) values through the calculator and reports growth of the resident memory.
+template <typename Calculator>
+void BM_MedianCalc_stream(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::size_t residentGrowth = 0;
+    for (auto _ : state)
+    {
+        const auto residentBefore = residentMemoryBytes();
+        Calculator calculator;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            calculator.add(_100000_numbers[i % _100000_numbers.size()] + static_cast<int>(i % 7));
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+        const auto residentAfter = residentMemoryBytes();
+        residentGrowth = residentAfter > residentBefore ? residentAfter - residentBefore : 0;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    state.counters["resident_growth_bytes"] = static_cast<double>(residentGrowth);
+}
+
+/**
+    \brief Adds state.range(0) values of type T (the same random integers converted to T) to MedianCalculator,
+        so calculators of different value types are compared on equal input.
+ */
+template <typename T>
+void BM_MedianCalc_value_type(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<T> values;
+    values.reserve(_100000_numbers.size());
+    for (auto number : _100000_numbers)
+    {
+        values.push_back(static_cast<T>(number));
+    }
+    for (auto _ : state)
+    {
+        tplx::MedianCalculator<T> calculator;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            calculator.add(values[i % values.size()]);
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+/// \brief Generates state.range(0) values loaded as a historical batch by the warm-up benchmarks.
+std::vector<int> generateWarmUpBatch(const benchmark::State& state)
+{
+    std::vector<int> batch(static_cast<std::size_t>(state.range(0)));
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(-1000000, 1000000);
+    for (auto& value : batch)
+    {
+        value = distribution(generator);
+    }
+    return batch;
+}
+
+void BM_MedianCalc_warmup_loop(benchmark::State& state)
+{
+    const auto batch = generateWarmUpBatch(state);
+    for (auto _ : state)
+    {
+        tplx::MedianCalculator<int> calculator;
+        for (auto value : batch)
+        {
+            calculator.add(value);
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+
+void BM_MedianCalc_warmup_addRange(benchmark::State& state)
+{
+    const auto batch = generateWarmUpBatch(state);
+    for (auto _ : state)
+    {
+        tplx::MedianCalculator<int> calculator;
+        calculator.addRange(batch.data(), batch.data() + batch.size());
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+
+/**
+    \brief Measures pop() followed by insert() keeping the heap of state.range(0) random values,
+        so each iteration sifts down the whole height of the heap.
+ */
+template <typename HeapType>
+void BM_Heap_pop_insert(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(1, 1000000000);
+    std::vector<int> values(size);
+    for (auto& value : values)
+    {
+        value = distribution(generator);
+    }
+    HeapType heap;
+    heap.insert(values.data(), values.data() + values.size());
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        heap.pop();
+        heap.insert(values[next]);
+        next = next + 1 == size ? 0 : next + 1;
+    }
+    benchmark::DoNotOptimize(heap.top());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/**
+    \brief Ascending values, so every other value goes to the bigger half and its top has to be moved
+        to the other half (the worst case for balancing, as halves never differ by more than one value).
+ */
+std::vector<int> generateCrossingValues(const benchmark::State& state)
+{
+    std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        values[i] = static_cast<int>(i);
+    }
+    return values;
+}
+
+/// \brief Former balancing of MedianCalculator: top of the half bigger by two values is moved to the other one.
+template <typename LowerHalf, typename UpperHalf>
+void balanceByInsertPop(LowerHalf& lowerHalf, UpperHalf& upperHalf)
+{
+    if (lowerHalf.size() == upperHalf.size() + 2)
+    {
+        upperHalf.insert(lowerHalf.top());
+        lowerHalf.pop();
+    }
+    else if (upperHalf.size() == lowerHalf.size() + 2)
+    {
+        lowerHalf.insert(upperHalf.top());
+        upperHalf.pop();
+    }
+}
+
+/// \brief Value crossing the median is inserted to the bigger half, then its top is inserted and popped.
+void BM_MedianCalc_crossing_insert_pop(benchmark::State& state)
+{
+    const auto values = generateCrossingValues(state);
+    for (auto _ : state)
+    {
+        tplx::MaxHeap<int> lowerHalf;
+        tplx::MinHeap<int> upperHalf;
+        for (auto value : values)
+        {
+            tplx::details::addValue(value, lowerHalf, upperHalf);
+            balanceByInsertPop(lowerHalf, upperHalf);
+        }
+        benchmark::DoNotOptimize(lowerHalf.top());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+/// \brief Value crossing the median replaces top of the bigger half (MedianCalculator::add).
+void BM_MedianCalc_crossing_push_pop(benchmark::State& state)
+{
+    const auto values = generateCrossingValues(state);
+    for (auto _ : state)
+    {
+        tplx::MedianCalculator<int> calculator;
+        for (auto value : values)
+        {
+            calculator.add(value);
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+void releaseResource(tplx::NewAllocator&)
+{
+}
+
+void releaseResource(tplx::SizeClassPool&)
+{
+}
+
+void releaseResource(tplx::MonotonicArena& arena)
+{
+    arena.release();
+}
+
+/**
+    \brief Churn of short-living streams: each of state.range(0) calculators receives 64 values and then
+        returns its memory, the resource is shared by all calculators.
+ */
+template <typename Resource, typename Allocator>
+void BM_MedianCalc_churn(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto values = generate_random_numbers(-10000, 10000, 64);
+    Resource resource;
+    using Calculator = tplx::MedianCalculator<int, Allocator>;
+    std::vector<Calculator> calculators(count, Calculator{Allocator{resource}});
+    for (auto _ : state)
+    {
+        for (auto& calculator : calculators)
+        {
+            for (auto value : values)
+            {
+                calculator.add(value);
+            }
+            benchmark::DoNotOptimize(calculator.calculate());
+        }
+        for (auto& calculator : calculators)
+        {
+            calculator.release();
+        }
+        releaseResource(resource);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count * values.size()));
+}
+
+/// \brief Values spread over state.range(0) keys, each key gets about 4 values.
+std::vector<std::pair<unsigned, int>> generateKeyedValues(const benchmark::State& state)
+{
+    const auto keys = static_cast<unsigned>(state.range(0));
+    std::vector<std::pair<unsigned, int>> values(4 * static_cast<std::size_t>(keys));
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<unsigned> keyDistribution(0, keys - 1);
+    std::uniform_int_distribution<> valueDistribution(1, 1000000);
+    for (auto& value : values)
+    {
+        value = {keyDistribution(generator), valueDistribution(generator)};
+    }
+    return values;
+}
+
+void BM_KeyedMedian_engine(benchmark::State& state)
+{
+    const auto values = generateKeyedValues(state);
+    for (auto _ : state)
+    {
+        tplx::KeyedMedianEngine<unsigned, int> engine;
+        for (const auto& value : values)
+        {
+            engine.add(value.first, value.second);
+        }
+        benchmark::DoNotOptimize(engine.calculate(values.front().first));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+void BM_KeyedMedian_unordered_map(benchmark::State& state)
+{
+    const auto values = generateKeyedValues(state);
+    for (auto _ : state)
+    {
+        std::unordered_map<unsigned, tplx::MedianCalculator<int>> calculators;
+        for (const auto& value : values)
+        {
+            calculators[value.first].add(value.second);
+        }
+        benchmark::DoNotOptimize(calculators[values.front().first].calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
 BENCHMARK_CAPTURE(BM_MedianCalc_heap, 10, _10_numbers);
 BENCHMARK_CAPTURE(BM_MedianCalc_heap, 100, _100_numbers);
 BENCHMARK_CAPTURE(BM_MedianCalc_heap, 1000, _1000_numbers);
@@ -101,4 +449,35 @@ BENCHMARK_CAPTURE(BM_MedianCalc_nth_element, 1000, _1000_numbers);
 BENCHMARK_CAPTURE(BM_MedianCalc_nth_element, 10000, _10000_numbers);
 BENCHMARK_CAPTURE(BM_MedianCalc_nth_element, 100000, _100000_numbers);
 
+BENCHMARK(BM_WindowMedianCalc)->RangeMultiplier(8)->Range(16, 1 << 20);
+
+BENCHMARK_TEMPLATE(BM_MedianCalc_stream, tplx::MedianCalculator<int>)->RangeMultiplier(10)->Range(100000, 100000000);
+BENCHMARK_TEMPLATE(BM_MedianCalc_stream, tplx::SketchMedianCalculator<int>)->RangeMultiplier(10)->Range(100000, 100000000);
+
+BENCHMARK_TEMPLATE(BM_MedianCalc_value_type, int)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_MedianCalc_value_type, float)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_MedianCalc_value_type, double)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_MedianCalc_value_type, long long)->RangeMultiplier(10)->Range(100000, 10000000);
+
+BENCHMARK(BM_MedianCalc_warmup_loop)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(1000000, 100000000);
+BENCHMARK(BM_MedianCalc_warmup_addRange)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(1000000, 100000000);
+
+BENCHMARK(BM_MedianCalc_crossing_insert_pop)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(10000, 10000000);
+BENCHMARK(BM_MedianCalc_crossing_push_pop)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(10000, 10000000);
+
+BENCHMARK_TEMPLATE(BM_Heap_pop_insert, tplx::MaxHeap<int, 2>)->RangeMultiplier(10)->Range(1000, 100000000);
+BENCHMARK_TEMPLATE(BM_Heap_pop_insert, tplx::MaxHeap<int, 4>)->RangeMultiplier(10)->Range(1000, 100000000);
+BENCHMARK_TEMPLATE(BM_Heap_pop_insert, tplx::MaxHeap<int, 8>)->RangeMultiplier(10)->Range(1000, 100000000);
+BENCHMARK_TEMPLATE(BM_Heap_pop_insert, tplx::MaxHeap<int, 16>)->RangeMultiplier(10)->Range(1000, 100000000);
+
+BENCHMARK_TEMPLATE(BM_MedianCalc_churn, tplx::NewAllocator, tplx::NewAllocator)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_MedianCalc_churn, tplx::SizeClassPool, tplx::PoolAllocator)->Arg(1000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_MedianCalc_churn, tplx::MonotonicArena, tplx::ArenaAllocator)->Arg(1000)->Arg(100000);
+
+BENCHMARK(BM_KeyedMedian_engine)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_KeyedMedian_unordered_map)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(1000, 1000000);
+
+BENCHMARK(BM_QuantileCalc_shared)->RangeMultiplier(2)->Range(1, 8);
+BENCHMARK(BM_QuantileCalc_separate)->RangeMultiplier(2)->Range(1, 8);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,66 @@
+#include "events/BufferedEventLoop.h"
+#include "pipeline/ShardedMedianPipeline.h"
+#include <benchmark/benchmark.h>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+
+namespace
+{
+
+using namespace tplx;
+
+/// \brief Stream buffer discarding written characters, so only calculation cost is measured.
+class NullStreamBuffer : public std::streambuf
+{
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        return count;
+    }
+    int_type overflow(int_type ch) override
+    {
+        return ch;
+    }
+};
+
+/// \brief Generates about \a size bytes of keyed input spread over \a streams streams.
+std::string generateKeyedInput(std::size_t size, unsigned streams)
+{
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> values(1, 1000000);
+    std::uniform_int_distribution<unsigned> keys(1, streams);
+    std::string input;
+    input.reserve(size + 32);
+    while(input.size() < size)
+    {
+        const auto key = std::to_string(keys(generator));
+        input += key + ':' + std::to_string(values(generator)) + ' ';
+        if(generator() % 4 == 0)
+        {
+            input += key + ":m ";
+        }
+    }
+    input += 'q';
+    return input;
+}
+
+const std::string keyedInput = generateKeyedInput(16 * 1024 * 1024, 10000);
+
+void BM_ShardedPipeline_threads(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        NullStreamBuffer buffer;
+        std::ostream out{&buffer};
+        ShardedMedianPipeline<int> pipeline{out, static_cast<std::size_t>(state.range(0))};
+        runEventLoop(keyedInput.data(), keyedInput.data() + keyedInput.size(), pipeline);
+        pipeline.finish();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * keyedInput.size()));
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_ShardedPipeline_threads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
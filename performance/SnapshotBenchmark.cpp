@@ -0,0 +1,81 @@
+#include "ValueGenerators.h"
+#include "median/MedianCalculator.h"
+#include "median/SnapshotFile.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace tplx;
+using namespace tplx::perf;
+
+const std::string snapshot_path = "running_median_benchmark_snapshot.bin";
+
+std::vector<int> generateValues(std::size_t count)
+{
+    std::vector<int> values(count);
+    ValueGenerator generator{Distribution::uniform};
+    generator.fill(values.data(), values.data() + values.size());
+    return values;
+}
+
+/// \brief Rebuilds the state of the calculator by adding all state.range(0) values again (restart without snapshot).
+void BM_MedianCalc_restore_by_replay(benchmark::State& state)
+{
+    const auto values = generateValues(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        MedianCalculator<int> calculator;
+        for (auto value : values)
+        {
+            calculator.add(value);
+        }
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief Restores the state of the calculator of state.range(0) values from the snapshot file.
+void BM_MedianCalc_restore_from_snapshot(benchmark::State& state)
+{
+    {
+        const auto values = generateValues(static_cast<std::size_t>(state.range(0)));
+        MedianCalculator<int> calculator;
+        calculator.addRange(values.data(), values.data() + values.size());
+        saveSnapshotFile(calculator, snapshot_path.c_str());
+    }
+    for (auto _ : state)
+    {
+        MedianCalculator<int> calculator;
+        loadSnapshotFile(calculator, snapshot_path.c_str());
+        benchmark::DoNotOptimize(calculator.calculate());
+    }
+    std::remove(snapshot_path.c_str());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+/// \brief Writes the snapshot file of the calculator of state.range(0) values.
+void BM_MedianCalc_save_snapshot(benchmark::State& state)
+{
+    const auto values = generateValues(static_cast<std::size_t>(state.range(0)));
+    MedianCalculator<int> calculator;
+    calculator.addRange(values.data(), values.data() + values.size());
+    for (auto _ : state)
+    {
+        saveSnapshotFile(calculator, snapshot_path.c_str());
+    }
+    std::remove(snapshot_path.c_str());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_MedianCalc_restore_by_replay)->RangeMultiplier(10)->Range(100000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MedianCalc_restore_from_snapshot)
+    ->RangeMultiplier(10)
+    ->Range(100000, 10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MedianCalc_save_snapshot)->RangeMultiplier(10)->Range(100000, 10000000)->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
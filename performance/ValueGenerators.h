@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace tplx
+{
+namespace perf
+{
+
+/// \brief Seed used by all generators unless stated otherwise, so benchmark runs are reproducible.
+constexpr std::uint32_t default_seed = 2019;
+
+/// \brief Shapes of input streams exercising different paths of the calculators.
+enum class Distribution
+{
+    sorted,         // ascending values, every other value crosses the median
+    reverse_sorted, // descending values
+    alternating,    // values alternately above and below the median, moving away from it
+    zipf,           // few values repeated very often, long tail of rare ones
+    duplicates,     // only a handful of distinct values
+    normal,         // values concentrated around the mean
+    uniform         // values spread evenly over the whole range
+};
+
+inline const char* toString(Distribution distribution)
+{
+    switch (distribution)
+    {
+    case Distribution::sorted:
+        return "sorted";
+    case Distribution::reverse_sorted:
+        return "reverse_sorted";
+    case Distribution::alternating:
+        return "alternating";
+    case Distribution::zipf:
+        return "zipf";
+    case Distribution::duplicates:
+        return "duplicates";
+    case Distribution::normal:
+        return "normal";
+    case Distribution::uniform:
+        return "uniform";
+    }
+    return "unknown";
+}
+
+/**
+    \brief Generates an endless stream of int values of the given distribution.
+        Values are produced on demand, so streams much longer than the available memory can be generated.
+        The same distribution and seed always give the same stream.
+ */
+class ValueGenerator
+{
+public:
+    explicit ValueGenerator(Distribution distribution, std::uint32_t seed = default_seed)
+        : distribution_{distribution},
+          generator_{seed},
+          uniform_{-1000000000, 1000000000},
+          duplicates_{0, 15},
+          normal_{0.0, 1000000.0},
+          index_{0}
+    {
+        if (distribution_ == Distribution::zipf)
+        {
+            prepareZipf();
+        }
+    }
+
+    int next()
+    {
+        const auto index = index_++;
+        switch (distribution_)
+        {
+        case Distribution::sorted:
+            return static_cast<int>(index % max_sequential) - max_sequential / 2;
+        case Distribution::reverse_sorted:
+            return max_sequential / 2 - static_cast<int>(index % max_sequential);
+        case Distribution::alternating:
+        {
+            const auto distance = static_cast<int>((index / 2) % (max_sequential / 2));
+            return index % 2 == 0 ? distance : -distance - 1;
+        }
+        case Distribution::zipf:
+        {
+            const auto point = std::generate_canonical<double, 32>(generator_);
+            return static_cast<int>(std::upper_bound(zipfCdf_.begin(), zipfCdf_.end(), point) - zipfCdf_.begin());
+        }
+        case Distribution::duplicates:
+            return duplicates_(generator_) * 1000;
+        case Distribution::normal:
+            return static_cast<int>(std::lround(normal_(generator_)));
+        case Distribution::uniform:
+            return uniform_(generator_);
+        }
+        return 0;
+    }
+
+    /// \brief Fills [first, last) range with the next values of the stream.
+    void fill(int* first, int* last)
+    {
+        while (first != last)
+        {
+            *first++ = next();
+        }
+    }
+
+private:
+    // sequential streams wrap around before exceeding the int range
+    static constexpr int max_sequential = 2000000000;
+
+    static constexpr std::size_t zipf_ranks = 1000000;
+
+    void prepareZipf()
+    {
+        // cumulative distribution of ranks 1..zipf_ranks with exponent 1
+        zipfCdf_.resize(zipf_ranks);
+        double sum = 0;
+        for (std::size_t rank = 0; rank < zipf_ranks; rank++)
+        {
+            sum += 1.0 / static_cast<double>(rank + 1);
+            zipfCdf_[rank] = sum;
+        }
+        for (auto& value : zipfCdf_)
+        {
+            value /= sum;
+        }
+    }
+
+    Distribution distribution_;
+    std::mt19937 generator_;
+    std::uniform_int_distribution<int> uniform_;
+    std::uniform_int_distribution<int> duplicates_;
+    std::normal_distribution<double> normal_;
+    std::vector<double> zipfCdf_;
+    std::uint64_t index_;
+};
+
+} // namespace perf
+} // namespace tplx
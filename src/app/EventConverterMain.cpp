@@ -0,0 +1,33 @@
+#include "events/BinaryEventLoop.h"
+#include "events/BufferedEventLoop.h"
+#include <iostream>
+
+using namespace tplx;
+
+/**
+    Converts the input sequence written in the text grammar (read from stdin) to the binary event format
+    (written to stdout), which running_median reads without parsing.
+ */
+int main(int argc, char**)
+{
+    try
+    {
+        if(argc != 1)
+        {
+            throw std::invalid_argument("usage: running_median_convert < text_input > binary_input");
+        }
+        BinaryEventWriter<int> writer{STDOUT_FILENO};
+        runBufferedEventLoop(STDIN_FILENO, writer);
+        writer.flush();
+        return 0;
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+    }
+    catch(...)
+    {
+        std::cerr << "[ERROR] unknown error" << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "median/CountingMedianCalculator.h"
+#include "median/KeyedMedianEngine.h"
+#include "median/LazyMedianCalculator.h"
+#include "median/MedianCalculator.h"
+#include "events/Event.h"
+#include "events/EventBatch.h"
+#include "events/EventListener.h"
+#include "output/BufferedWriter.h"
+#include <ostream>
+#include <utility>
+
+namespace tplx
+{
+
+/**
+    \brief Listener of the main application calculating running medians of the default stream and of the
+        identified streams, medians are written to the output stream separated by spaces.
+        Values of the default stream are handled by the \a Calculator engine (MedianCalculator or
+        CountingMedianCalculator), which is constructed from the arguments following the output stream.
+        Engines wrapped in LazyMedianCalculator give the "on-change" output mode: the median of the default
+        stream is written only if it differs from the one written last, so slowly moving medians cost
+        neither formatting nor output volume (medians of identified streams are always written).
+ */
+template<typename Calculator>
+class BasicMedianCalculatingEventListener : public EventListener<int>
+{
+public:
+    template<typename... Args>
+    explicit BasicMedianCalculatingEventListener(std::ostream& out, Args&&... args)
+        : out_{out}, calculator_{std::forward<Args>(args)...}
+    {
+    }
+    bool newEvent(Event<int>&& event) override
+    {
+        if(event.stream != default_stream)
+        {
+            newStreamEvent(event);
+            return true;
+        }
+        switch(event.type)
+        {
+            case EventType::new_value:
+            {
+                calculator_.add(event.value);
+                break;
+            }
+            case EventType::calculate_median:
+            {
+                if(details::medianChanged(calculator_))
+                {
+                    out_.write(details::takeMedian(calculator_));
+                    out_.write(' ');
+                }
+                break;
+            }
+            case EventType::sequence_end:
+            {
+                calculator_.reset();
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool newEvents(const Event<int>* events, std::size_t count) override
+    {
+        std::size_t i = 0;
+        while(i < count)
+        {
+            if(events[i].type != EventType::new_value or events[i].stream != default_stream)
+            {
+                Event<int> event{events[i++]};
+                newEvent(std::move(event));
+                continue;
+            }
+            // a run of consecutive values goes to the calculator at once
+            std::size_t runLength = 0;
+            while(i < count and runLength < default_event_batch_size and events[i].type == EventType::new_value and
+                  events[i].stream == default_stream)
+            {
+                values_[runLength++] = events[i++].value;
+            }
+            calculator_.addRange(values_, values_ + runLength);
+        }
+        return true;
+    }
+
+    void flush()
+    {
+        out_.flush();
+    }
+
+    /// \brief Returns statistics of the default stream calculator (if its engine collects them).
+    StatsSnapshot stats() const noexcept
+    {
+        return calculator_.stats();
+    }
+
+private:
+    void newStreamEvent(const Event<int>& event)
+    {
+        switch(event.type)
+        {
+            case EventType::new_value:
+            {
+                streams_.add(event.stream, event.value);
+                break;
+            }
+            case EventType::calculate_median:
+            {
+                out_.write(streams_.calculate(event.stream));
+                out_.write(' ');
+                break;
+            }
+            case EventType::sequence_end:
+            {
+                streams_.reset(event.stream);
+                break;
+            }
+        }
+    }
+
+    BufferedWriter out_;
+    Calculator calculator_;
+    KeyedMedianEngine<StreamId, int> streams_;
+    int values_[default_event_batch_size];
+};
+
+using MedianCalculatingEventListener = BasicMedianCalculatingEventListener<MedianCalculator<int>>;
+using StatsCollectingEventListener =
+    BasicMedianCalculatingEventListener<MedianCalculator<int, NewAllocator, NanPolicy::skip, CollectStats>>;
+/// \brief Listener counting values of the default stream, which have to lie in the range given to its constructor.
+using CountingMedianCalculatingEventListener = BasicMedianCalculatingEventListener<CountingMedianCalculator<int>>;
+/// \brief Listener writing the median of the default stream only when it has changed ("on-change" output mode).
+using OnChangeMedianCalculatingEventListener =
+    BasicMedianCalculatingEventListener<LazyMedianCalculator<MedianCalculator<int>>>;
+
+} // namespace tplx
@@ -1,52 +1,169 @@
-#include "median/MedianCalculator.h"
-#include "events/EventLoop.h"
+#include "MedianCalculatingEventListener.h"
+#include "events/BinaryEventLoop.h"
+#include "events/BufferedEventLoop.h"
+#include "pipeline/ShardedMedianPipeline.h"
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
-namespace tplx
+using namespace tplx;
+
+namespace
+{
+
+struct Options
+{
+    // number of worker threads requested by "--threads N" option, 0 if not requested
+    std::size_t threads;
+    // "--stats" option: statistics of the calculator are written to stderr at exit
+    bool stats;
+    // "--binary" option or binary input file detected: events are read in the binary format
+    bool binary;
+    // "--range MIN MAX" option: values of the default stream are counted (see CountingMedianCalculator)
+    bool counting;
+    int min;
+    int max;
+    // "--on-change" option: the median of the default stream is written only if it has changed
+    bool onChange;
+};
+
+bool parseInt(const char* text, int& value)
 {
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(text, &end, 10);
+    value = static_cast<int>(parsed);
+    return end != text and *end == '\0' and errno == 0 and parsed >= INT_MIN and parsed <= INT_MAX;
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options{0, false, false, false, 0, 0, false};
+    int next = 1;
+    if(next < argc and std::strcmp(argv[next], "--binary") == 0)
+    {
+        options.binary = true;
+        ++next;
+    }
+    if(next < argc and std::strcmp(argv[next], "--on-change") == 0)
+    {
+        options.onChange = true;
+        ++next;
+    }
+    bool valid = next == argc;
+    if(next + 1 == argc and std::strcmp(argv[next], "--stats") == 0)
+    {
+        options.stats = true;
+        valid = true;
+    }
+    else if(next + 2 == argc and std::strcmp(argv[next], "--threads") == 0)
+    {
+        char* end = nullptr;
+        options.threads = std::strtoul(argv[next + 1], &end, 10);
+        valid = options.threads > 0 and *end == '\0';
+    }
+    else if(next + 3 == argc and std::strcmp(argv[next], "--range") == 0)
+    {
+        options.counting = true;
+        valid = parseInt(argv[next + 1], options.min) and parseInt(argv[next + 2], options.max) and
+                options.min <= options.max;
+    }
+    // worker threads and statistics are available for the default output mode only
+    valid = valid and not(options.onChange and (options.threads > 0 or options.stats));
+    if(not valid)
+    {
+        throw std::invalid_argument(
+            "usage: running_median [--binary] [--on-change] [--threads N | --stats | --range MIN MAX]");
+    }
+    // binary files are recognized by their header, pipes need the option
+    options.binary = options.binary or isBinaryEventFile(STDIN_FILENO);
+    return options;
+}
 
-class MedianCalculatingEventListener : public EventListener<int>
+void runEvents(const Options& options, EventListener<int>& listener)
 {
-public:
-    explicit MedianCalculatingEventListener(std::ostream& out) : out_{out} {}
-    bool newEvent(Event<int>&& event) override
+    if(options.binary)
     {
-        switch(event.type)
+        runBinaryEventLoop(STDIN_FILENO, listener);
+    }
+    else
+    {
+        runBufferedEventLoop(STDIN_FILENO, listener);
+    }
+}
+
+template<typename Calculator, typename... Args>
+void runListener(const Options& options, Args... args)
+{
+    BasicMedianCalculatingEventListener<Calculator> listener{std::cout, args...};
+    runEvents(options, listener);
+    listener.flush();
+}
+
+void printHistogram(std::ostream& out, const char* name, const std::uint64_t* buckets)
+{
+    out << name;
+    for(std::size_t depth = 0; depth < StatsSnapshot::depth_buckets; depth++)
+    {
+        if(buckets[depth] > 0)
         {
-            case EventType::new_value:
-            {
-                calculator_.add(event.value);
-                break;
-            }
-            case EventType::calculate_median:
-            {
-                out_ << calculator_.calculate() << ' ';
-                break;
-            }
-            case EventType::sequence_end:
-            {
-                calculator_.reset();
-                break;
-            }
+            out << ' ' << depth << ':' << buckets[depth];
         }
-        return true;
     }
+    out << '\n';
+}
 
-private:
-    std::ostream& out_;
-    MedianCalculator<int> calculator_; 
-};
-
-} // namespace tplx
+void printStats(std::ostream& out, const StatsSnapshot& stats)
+{
+    out << "reallocations " << stats.reallocations << '\n';
+    out << "bytes_copied " << stats.bytesCopied << '\n';
+    out << "rebalances " << stats.rebalances << '\n';
+    printHistogram(out, "sift_up_depths", stats.siftUpDepths);
+    printHistogram(out, "sift_down_depths", stats.siftDownDepths);
+    out.flush();
+}
 
-using namespace tplx;
+} // anonymous namespace
 
-int main(int, char**)
+int main(int argc, char** argv)
 {
     try
     {
-        MedianCalculatingEventListener listener{std::cout};
-        runEventLoop(std::cin, listener);
+        const auto options = parseOptions(argc, argv);
+        if(options.threads > 0)
+        {
+            ShardedMedianPipeline<int> pipeline{std::cout, options.threads};
+            runEvents(options, pipeline);
+            pipeline.finish();
+        }
+        else if(options.stats)
+        {
+            StatsCollectingEventListener listener{std::cout};
+            runEvents(options, listener);
+            listener.flush();
+            std::cout << std::endl;
+            printStats(std::cerr, listener.stats());
+            return 0;
+        }
+        else if(options.counting and options.onChange)
+        {
+            runListener<LazyMedianCalculator<CountingMedianCalculator<int>>>(options, options.min, options.max);
+        }
+        else if(options.counting)
+        {
+            runListener<CountingMedianCalculator<int>>(options, options.min, options.max);
+        }
+        else if(options.onChange)
+        {
+            runListener<LazyMedianCalculator<MedianCalculator<int>>>(options);
+        }
+        else
+        {
+            runListener<MedianCalculator<int>>(options);
+        }
         std::cout << std::endl;
         return 0;
     }
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "BufferedEventLoop.h"
+#include "EventListener.h"
+#include "Event.h"
+#include "median/HeapStorageTypeTraits.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tplx
+{
+
+/**
+    \brief Header starting the binary event sequence.
+
+        The binary format is an alternative to the text grammar which needs no parsing at all: the header
+        is followed by blocks, each made of BinaryBlockHeader and \a count fixed-width event records.
+        A record is the memory image of Event<T> (value, type tag, stream identifier and timestamp), so
+        records of a memory mapped file are passed to EventListener::newEvents() in place. All fields are
+        stored in native byte order, files are meant to be read on the machine (architecture) which has
+        written them, the header records sizes of the value and of the record to reject other layouts.
+        The sequence ends with the end of input. Use BinaryEventWriter to produce the format.
+ */
+struct BinaryEventsHeader
+{
+    /// \brief "RMEV" in little endian byte order.
+    static constexpr std::uint32_t magic_value = 0x56454D52;
+    static constexpr std::uint16_t current_version = 1;
+
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t valueSize;
+    std::uint32_t recordSize;
+    std::uint32_t reserved;
+};
+
+/// \brief Header of a block of event records (length prefix).
+struct BinaryBlockHeader
+{
+    std::uint64_t count;
+    std::uint64_t reserved;
+};
+
+/// \brief Alignment of records guaranteed by the layout of headers (relative to the beginning of the input).
+constexpr std::size_t binary_events_alignment = 16;
+
+static_assert(sizeof(BinaryEventsHeader) == binary_events_alignment and
+                  sizeof(BinaryBlockHeader) == binary_events_alignment,
+              "headers keep records aligned");
+
+namespace details
+{
+
+template<typename T>
+void checkBinaryEventType()
+{
+    static_assert(IsTriviallyCopyable<Event<T>>::value, "binary events are memory images of Event<T>");
+    static_assert(alignof(Event<T>) <= binary_events_alignment, "records of binary events would be misaligned");
+}
+
+template<typename T>
+BinaryEventsHeader makeBinaryEventsHeader() noexcept
+{
+    BinaryEventsHeader header{};
+    header.magic = BinaryEventsHeader::magic_value;
+    header.version = BinaryEventsHeader::current_version;
+    header.valueSize = static_cast<std::uint16_t>(sizeof(T));
+    header.recordSize = static_cast<std::uint32_t>(sizeof(Event<T>));
+    return header;
+}
+
+/// \throws std::invalid_argument if the header does not start binary events of T values
+template<typename T>
+void checkBinaryEventsHeader(const BinaryEventsHeader& header)
+{
+    if(header.magic != BinaryEventsHeader::magic_value)
+    {
+        throw std::invalid_argument("not a binary event sequence");
+    }
+    if(header.version != BinaryEventsHeader::current_version)
+    {
+        throw std::invalid_argument("unsupported binary event sequence version");
+    }
+    if(header.valueSize != sizeof(T) or header.recordSize != sizeof(Event<T>))
+    {
+        throw std::invalid_argument("binary events of other type");
+    }
+}
+
+/**
+    \brief Reads \a size bytes unless the end of input is reached first.
+    \throws std::system_error if reading fails
+    \return number of bytes read
+ */
+inline std::size_t readFully(int fileDescriptor, void* buffer, std::size_t size)
+{
+    std::size_t done = 0;
+    while(done < size)
+    {
+        const auto count = ::read(fileDescriptor, static_cast<char*>(buffer) + done, size - done);
+        if(count < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if(count == 0)
+        {
+            break;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return done;
+}
+
+/// \throws std::system_error if writing fails
+inline void writeFully(int fileDescriptor, const void* buffer, std::size_t size)
+{
+    std::size_t done = 0;
+    while(done < size)
+    {
+        const auto count = ::write(fileDescriptor, static_cast<const char*>(buffer) + done, size - done);
+        if(count < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+        done += static_cast<std::size_t>(count);
+    }
+}
+
+/// \throws std::invalid_argument if any of the records holds an unknown type tag
+template<typename T>
+void checkEventTypes(const Event<T>* events, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; i++)
+    {
+        if(static_cast<unsigned>(events[i].type) > static_cast<unsigned>(EventType::sequence_end))
+        {
+            throw std::invalid_argument("unknown event type in binary event sequence");
+        }
+    }
+}
+
+/**
+    \brief Passes \a count records to the listener, in place if they are aligned, copied in batches otherwise.
+        Type tags of the records are checked before they are passed.
+ */
+template<typename T>
+bool deliverRecords(const char* records, std::size_t count, EventListener<T>& listener)
+{
+    if(reinterpret_cast<std::uintptr_t>(records) % alignof(Event<T>) == 0)
+    {
+        const auto events = reinterpret_cast<const Event<T>*>(records);
+        checkEventTypes(events, count);
+        return count == 0 or listener.newEvents(events, count);
+    }
+    Event<T> batch[default_event_batch_size];
+    while(count > 0)
+    {
+        const auto length = count < default_event_batch_size ? count : default_event_batch_size;
+        std::memcpy(static_cast<void*>(batch), records, length * sizeof(Event<T>));
+        checkEventTypes(batch, length);
+        if(not listener.newEvents(batch, length))
+        {
+            return false;
+        }
+        records += length * sizeof(Event<T>);
+        count -= length;
+    }
+    return true;
+}
+
+} // namespace details
+
+/**
+    \brief Passes events of the binary sequence stored in the [first, last) memory block to the listener,
+        block by block without parsing or copying them (see BinaryEventsHeader).
+    \throws std::invalid_argument if the sequence is malformed (e.g. a record of unknown type) or holds events
+        of other type
+ */
+template<typename T>
+void runBinaryEventLoop(const char* first, const char* last, EventListener<T>& listener)
+{
+    details::checkBinaryEventType<T>();
+    BinaryEventsHeader header;
+    if(static_cast<std::size_t>(last - first) < sizeof(header))
+    {
+        throw std::invalid_argument("not a binary event sequence");
+    }
+    std::memcpy(&header, first, sizeof(header));
+    details::checkBinaryEventsHeader<T>(header);
+    first += sizeof(header);
+    while(first != last)
+    {
+        BinaryBlockHeader block;
+        if(static_cast<std::size_t>(last - first) < sizeof(block))
+        {
+            throw std::invalid_argument("truncated binary event sequence");
+        }
+        std::memcpy(&block, first, sizeof(block));
+        first += sizeof(block);
+        if(block.count > static_cast<std::size_t>(last - first) / sizeof(Event<T>))
+        {
+            throw std::invalid_argument("truncated binary event sequence");
+        }
+        const auto count = static_cast<std::size_t>(block.count);
+        if(not details::deliverRecords(first, count, listener))
+        {
+            return;
+        }
+        first += count * sizeof(Event<T>);
+    }
+}
+
+/**
+    \brief Passes events of the binary sequence read from the file descriptor to the listener.
+        Regular files are memory mapped and their records are passed in place, any other input (pipe) is
+        read into batches of \a batchSize events.
+    \throws std::invalid_argument if the sequence is malformed (e.g. a record of unknown type) or holds events
+        of other type
+    \throws std::system_error if reading fails
+ */
+template<typename T>
+void runBinaryEventLoop(int fileDescriptor, EventListener<T>& listener,
+                        std::size_t batchSize = default_event_batch_size)
+{
+    details::checkBinaryEventType<T>();
+    struct stat status;
+    if(::fstat(fileDescriptor, &status) == 0 and S_ISREG(status.st_mode) and status.st_size > 0)
+    {
+        const auto offset = ::lseek(fileDescriptor, 0, SEEK_CUR);
+        const auto size = static_cast<std::size_t>(status.st_size);
+        details::MappedFile file{fileDescriptor, size};
+        if(file.valid() and offset >= 0 and static_cast<std::size_t>(offset) <= size)
+        {
+            runBinaryEventLoop(file.data() + offset, file.data() + size, listener);
+            return;
+        }
+    }
+
+    BinaryEventsHeader header;
+    if(details::readFully(fileDescriptor, &header, sizeof(header)) != sizeof(header))
+    {
+        throw std::invalid_argument("not a binary event sequence");
+    }
+    details::checkBinaryEventsHeader<T>(header);
+    std::unique_ptr<Event<T>[]> batch{new Event<T>[batchSize]};
+    while(true)
+    {
+        BinaryBlockHeader block;
+        const auto headerSize = details::readFully(fileDescriptor, &block, sizeof(block));
+        if(headerSize == 0)
+        {
+            return;
+        }
+        if(headerSize != sizeof(block))
+        {
+            throw std::invalid_argument("truncated binary event sequence");
+        }
+        auto remaining = block.count;
+        while(remaining > 0)
+        {
+            const auto count = static_cast<std::size_t>(remaining < batchSize ? remaining : batchSize);
+            const auto bytes = count * sizeof(Event<T>);
+            if(details::readFully(fileDescriptor, batch.get(), bytes) != bytes)
+            {
+                throw std::invalid_argument("truncated binary event sequence");
+            }
+            details::checkEventTypes(batch.get(), count);
+            if(not listener.newEvents(batch.get(), count))
+            {
+                return;
+            }
+            remaining -= count;
+        }
+    }
+}
+
+/**
+    \brief Checks whether the regular file starts with BinaryEventsHeader at its current offset.
+        The offset is not changed, inputs other than regular files (e.g. pipes) are never recognized.
+ */
+inline bool isBinaryEventFile(int fileDescriptor)
+{
+    struct stat status;
+    if(::fstat(fileDescriptor, &status) != 0 or not S_ISREG(status.st_mode))
+    {
+        return false;
+    }
+    const auto offset = ::lseek(fileDescriptor, 0, SEEK_CUR);
+    std::uint32_t magic = 0;
+    return offset >= 0 and ::pread(fileDescriptor, &magic, sizeof(magic), offset) == sizeof(magic) and
+           magic == BinaryEventsHeader::magic_value;
+}
+
+/**
+    \brief Listener writing received events to the file descriptor in the binary format
+        (see BinaryEventsHeader), events are collected into blocks of \a blockSize events.
+        flush() has to be called once all events are written.
+ */
+template<typename T>
+class BinaryEventWriter : public EventListener<T>
+{
+public:
+    /// \brief Size of blocks written by default.
+    static constexpr std::size_t default_block_size = 4096;
+
+    /// \throws std::system_error if writing the header fails
+    explicit BinaryEventWriter(int fileDescriptor, std::size_t blockSize = default_block_size)
+        : fileDescriptor_{fileDescriptor},
+          block_{new char[sizeof(BinaryBlockHeader) + blockSize * sizeof(Event<T>)]},
+          blockSize_{blockSize},
+          size_{0}
+    {
+        details::checkBinaryEventType<T>();
+        const auto header = details::makeBinaryEventsHeader<T>();
+        details::writeFully(fileDescriptor_, &header, sizeof(header));
+    }
+
+    /// \throws std::system_error if writing fails
+    bool newEvent(Event<T>&& event) override
+    {
+        // records are composed field by field, so padding bytes are always zeros
+        auto record = block_.get() + sizeof(BinaryBlockHeader) + size_ * sizeof(Event<T>);
+        std::memset(record, 0, sizeof(Event<T>));
+        store(record + offsetof(Event<T>, value), event.value);
+        store(record + offsetof(Event<T>, type), event.type);
+        store(record + offsetof(Event<T>, stream), event.stream);
+        store(record + offsetof(Event<T>, timestamp), event.timestamp);
+        if(++size_ == blockSize_)
+        {
+            flush();
+        }
+        return true;
+    }
+
+    /**
+        \brief Writes the block of collected events.
+        \throws std::system_error if writing fails
+     */
+    void flush()
+    {
+        if(size_ == 0)
+        {
+            return;
+        }
+        BinaryBlockHeader header{};
+        header.count = size_;
+        std::memcpy(block_.get(), &header, sizeof(header));
+        details::writeFully(fileDescriptor_, block_.get(), sizeof(header) + size_ * sizeof(Event<T>));
+        size_ = 0;
+    }
+
+private:
+    template<typename Field>
+    static void store(char* destination, const Field& field)
+    {
+        std::memcpy(destination, &field, sizeof(field));
+    }
+
+    int fileDescriptor_;
+    std::unique_ptr<char[]> block_;
+    std::size_t blockSize_;
+    std::size_t size_;
+};
+
+} // namespace tplx
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "EventBatch.h"
+#include "EventListener.h"
+#include "EventLoop.h"
+#include "Event.h"
+#include "median/HeapStorageTypeTraits.h"
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tplx
+{
+
+namespace details
+{
+
+/**
+    \brief Incremental parser of the input sequence fed with consecutive blocks of memory.
+        Accepts exactly the same grammar as the istream based runEventLoop and raises the same errors,
+        but works on raw characters, so there is no per-character stream call. A number may span
+        blocks, its digits are accumulated until the first non-digit character is seen. Events are passed
+        to the listener in batches, each block is fully delivered before parse() returns.
+ */
+template<typename T>
+class EventParser
+{
+    static_assert(isIntegral<T>(), "EventParser supports integral values only");
+
+public:
+    explicit EventParser(EventListener<T>& listener) noexcept
+        : batch_{listener},
+          value_{},
+          stream_{default_stream},
+          inNumber_{false},
+          separatorExpected_{false},
+          streamGiven_{false},
+          streamEventExpected_{false}
+    {
+    }
+
+    /**
+        \brief Parses the next block of the input sequence.
+        \throws std::invalid_argument if the input is malformed
+        \return \a false if the end of the sequence is reached (end of line or listener is not interested
+            in further events), so no further block should be provided.
+     */
+    bool parse(const char* first, const char* last);
+
+    /**
+        \brief Notifies about the end of input, so the number located at the very end gets reported.
+        \throws std::invalid_argument if the input ends with an incomplete event
+     */
+    void finish();
+
+private:
+    bool parseEvents(const char* first, const char* last);
+    bool notify(EventType type);
+
+    EventBatch<T> batch_;
+    T value_;
+    StreamId stream_;
+    bool inNumber_;
+    bool separatorExpected_;
+    // the current event is preceded by stream identifier
+    bool streamGiven_;
+    // stream_marker has just been consumed, so either a value or a marker has to follow
+    bool streamEventExpected_;
+};
+
+template<typename T>
+bool EventParser<T>::parse(const char* first, const char* last)
+{
+    bool proceed;
+    try
+    {
+        proceed = parseEvents(first, last);
+    }
+    catch(std::invalid_argument&)
+    {
+        // the listener could have stopped before reaching the malformed input
+        if(batch_.flush())
+        {
+            throw;
+        }
+        return false;
+    }
+    return batch_.flush() and proceed;
+}
+
+template<typename T>
+bool EventParser<T>::parseEvents(const char* first, const char* last)
+{
+    constexpr T max = std::numeric_limits<T>::max();
+
+    while(first != last)
+    {
+        if(inNumber_)
+        {
+            while(first != last and *first >= '0' and *first <= '9')
+            {
+                const T digit = static_cast<T>(*first - '0');
+                if(value_ > (max - digit) / 10)
+                {
+                    // istream reports out of range number as failure
+                    throw std::invalid_argument("Not-a-number");
+                }
+                value_ = static_cast<T>(value_ * 10 + digit);
+                ++first;
+            }
+            if(first == last)
+            {
+                return true;
+            }
+            inNumber_ = false;
+            if(*first == stream_marker and not streamGiven_)
+            {
+                // the number identifies the stream the following value or marker belongs to
+                stream_ = toStreamId(value_);
+                value_ = {};
+                streamGiven_ = true;
+                streamEventExpected_ = true;
+                separatorExpected_ = false;
+                ++first;
+                continue;
+            }
+            if(not notify(EventType::new_value))
+            {
+                return false;
+            }
+        }
+
+        const char next = *first++;
+        if(streamEventExpected_)
+        {
+            if(not isStreamEventStart(next))
+            {
+                throw std::invalid_argument("unexpected character");
+            }
+            streamEventExpected_ = false;
+        }
+        if(next == '\n' or next == '\r')
+        {
+            return false;
+        }
+        else if(separatorExpected_ and next != separator_marker)
+        {
+            throw std::invalid_argument("missing separator");
+        }
+        else if(next == calc_median_marker)
+        {
+            separatorExpected_ = true;
+            if(not notify(EventType::calculate_median))
+            {
+                return false;
+            }
+        }
+        else if(next == seq_end_marker)
+        {
+            separatorExpected_ = true;
+            if(not notify(EventType::sequence_end))
+            {
+                return false;
+            }
+        }
+        else if(next >= '1' and next <= '9')
+        {
+            value_ = static_cast<T>(next - '0');
+            inNumber_ = true;
+            separatorExpected_ = true;
+        }
+        else if(next == separator_marker)
+        {
+            if(not separatorExpected_)
+            {
+                throw std::invalid_argument("unexpected separator");
+            }
+            separatorExpected_ = false;
+        }
+        else
+        {
+            throw std::invalid_argument("unexpected character");
+        }
+    }
+    return true;
+}
+
+template<typename T>
+void EventParser<T>::finish()
+{
+    if(streamEventExpected_)
+    {
+        if(batch_.flush())
+        {
+            throw std::invalid_argument("unexpected character");
+        }
+        return;
+    }
+    if(inNumber_)
+    {
+        inNumber_ = false;
+        notify(EventType::new_value);
+    }
+    batch_.flush();
+}
+
+template<typename T>
+bool EventParser<T>::notify(EventType type)
+{
+    Event<T> event{type, value_};
+    event.stream = stream_;
+    value_ = {};
+    stream_ = default_stream;
+    streamGiven_ = false;
+    return batch_.add(static_cast<Event<T>&&>(event));
+}
+
+/// \brief Owns read-only memory mapping of a file.
+class MappedFile
+{
+public:
+    MappedFile(int fileDescriptor, std::size_t size)
+        : data_{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0)}, size_{size}
+    {
+        if(data_ != MAP_FAILED)
+        {
+            ::madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile()
+    {
+        if(data_ != MAP_FAILED)
+        {
+            ::munmap(data_, size_);
+        }
+    }
+
+    bool valid() const noexcept
+    {
+        return data_ != MAP_FAILED;
+    }
+    const char* data() const noexcept
+    {
+        return static_cast<const char*>(data_);
+    }
+
+private:
+    void* data_;
+    std::size_t size_;
+};
+
+} // namespace details
+
+/// \brief Size of blocks read by runBufferedEventLoop if the input cannot be memory mapped.
+constexpr std::size_t default_block_size = 64 * 1024;
+
+/**
+    \brief Parses the input sequence stored in the [first, last) memory block and notifies the listener
+        about each event. Accepts the same grammar as runEventLoop reading from std::istream.
+    \throws std::invalid_argument if the input is malformed
+ */
+template<typename T>
+void runEventLoop(const char* first, const char* last, EventListener<T>& listener)
+{
+    details::EventParser<T> parser{listener};
+    if(parser.parse(first, last))
+    {
+        parser.finish();
+    }
+}
+
+/**
+    \brief Parses the input sequence read from the file descriptor and notifies the listener about each event.
+        Regular files are memory mapped and parsed in place, any other input (pipe, terminal) is read
+        in blocks of \a blockSize bytes, each read returns as soon as some data is available.
+    \throws std::invalid_argument if the input is malformed
+    \throws std::system_error if reading fails
+ */
+template<typename T>
+void runBufferedEventLoop(int fileDescriptor, EventListener<T>& listener, std::size_t blockSize = default_block_size)
+{
+    struct stat status;
+    if(::fstat(fileDescriptor, &status) == 0 and S_ISREG(status.st_mode) and status.st_size > 0)
+    {
+        const auto offset = ::lseek(fileDescriptor, 0, SEEK_CUR);
+        const auto size = static_cast<std::size_t>(status.st_size);
+        details::MappedFile file{fileDescriptor, size};
+        if(file.valid() and offset >= 0 and static_cast<std::size_t>(offset) <= size)
+        {
+            runEventLoop(file.data() + offset, file.data() + size, listener);
+            return;
+        }
+    }
+
+    details::EventParser<T> parser{listener};
+    std::unique_ptr<char[]> block{new char[blockSize]};
+    while(true)
+    {
+        const auto count = ::read(fileDescriptor, block.get(), blockSize);
+        if(count < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if(count == 0)
+        {
+            parser.finish();
+            return;
+        }
+        if(not parser.parse(block.get(), block.get() + count))
+        {
+            return;
+        }
+    }
+}
+
+} // namespace tplx
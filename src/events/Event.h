@@ -1,5 +1,8 @@
 #pragma once
 
+#include "median/Timestamp.h"
+#include <climits>
+
 namespace tplx
 {
 
@@ -10,18 +13,43 @@ enum class EventType
     sequence_end
 };
 
+/// \brief Identifier of an independent stream of values (e.g. endpoint whose latency is measured).
+using StreamId = unsigned int;
+
+/// \brief Stream of events which do not carry stream identifier.
+constexpr StreamId default_stream = 0;
+
+/// \brief Timestamp of events which do not carry any.
+constexpr Timestamp no_timestamp = LLONG_MIN;
+
 template<typename T>
 struct Event
 {
-    explicit Event(T value) : value{value}, type{EventType::new_value}
+    Event() : value{}, type{EventType::new_value}, stream{default_stream}, timestamp{no_timestamp}
+    {
+    }
+    explicit Event(T value)
+        : value{value}, type{EventType::new_value}, stream{default_stream}, timestamp{no_timestamp}
     {
     }
-    explicit Event(EventType type, T value = {}) : value{value}, type{type}
+    Event(T value, Timestamp timestamp)
+        : value{value}, type{EventType::new_value}, stream{default_stream}, timestamp{timestamp}
+    {
+    }
+    explicit Event(EventType type, T value = {}, Timestamp timestamp = no_timestamp)
+        : value{value}, type{type}, stream{default_stream}, timestamp{timestamp}
+    {
+    }
+
+    bool hasTimestamp() const
     {
+        return timestamp != no_timestamp;
     }
 
     T value;
     EventType type;
+    StreamId stream;
+    Timestamp timestamp;
 };
 
 } // namespace tplx
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "EventListener.h"
+#include "Event.h"
+#include <cstddef>
+
+namespace tplx
+{
+
+/// \brief Number of events collected by event loops before they are passed to the listener.
+constexpr std::size_t default_event_batch_size = 256;
+
+namespace details
+{
+
+/**
+    \brief Fixed-size buffer of events passed to EventListener::newEvents() once it is full or flushed.
+ */
+template<typename T, std::size_t Capacity = default_event_batch_size>
+class EventBatch
+{
+public:
+    explicit EventBatch(EventListener<T>& listener) noexcept : listener_{listener}, size_{0}
+    {
+    }
+
+    /**
+        \brief Appends the event, passes the whole batch to the listener if it gets full.
+        \return \a false if the listener is not interested in further events.
+     */
+    bool add(Event<T>&& event)
+    {
+        events_[size_++] = event;
+        if(size_ == Capacity)
+        {
+            return flush();
+        }
+        return true;
+    }
+
+    /**
+        \brief Passes collected events to the listener.
+        \return \a false if the listener is not interested in further events.
+     */
+    bool flush()
+    {
+        if(size_ == 0)
+        {
+            return true;
+        }
+        const auto count = size_;
+        size_ = 0;
+        return listener_.newEvents(events_, count);
+    }
+
+private:
+    EventListener<T>& listener_;
+    Event<T> events_[Capacity];
+    std::size_t size_;
+};
+
+} // namespace details
+} // namespace tplx
@@ -1,11 +1,11 @@
 #pragma once
 
+#include "Event.h"
+#include <cstddef>
+
 namespace tplx
 {
 
-template<typename T>
-struct Event;
-
 /**
     \brief Abstracts receiver of the produced by event loop events.
         Listener receives each newly produced event.
@@ -22,6 +22,28 @@ public:
         \return \a true if is not interested in further events any longer.
      */
     virtual bool newEvent(Event<T>&& event) = 0;
+
+    /**
+        \brief Notifies about a batch of consecutive events.
+            Default implementation passes events one by one to newEvent() until it asks to stop.
+            Listeners able to process several events at once (e.g. a run of new values) override it
+            in order to avoid a virtual call per event.
+        \param events - pointer to the first event
+        \param count - number of events
+        \return the same as newEvent() for the last processed event
+     */
+    virtual bool newEvents(const Event<T>* events, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            Event<T> event{events[i]};
+            if(not newEvent(static_cast<Event<T>&&>(event)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 };
 
 } // namespace tplx
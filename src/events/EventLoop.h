@@ -1,8 +1,11 @@
 #pragma once
 
+#include "EventBatch.h"
 #include "EventListener.h"
 #include "Event.h"
 #include <istream>
+#include <limits>
+#include <stdexcept>
 #include <cassert>
 
 namespace tplx
@@ -14,6 +17,7 @@ namespace details
 constexpr char calc_median_marker = 'm';
 constexpr char seq_end_marker = 'q';
 constexpr char separator_marker = ' ';
+constexpr char stream_marker = ':';
 
 inline void consumeNextAsMarker(std::istream& source)
 {
@@ -34,17 +38,35 @@ T consumeNextAsNewValue(std::istream& source)
     return newValue;
 }
 
-} // namespace details
-
+/**
+    \brief Converts number preceding stream_marker to the stream identifier.
+    \throws std::invalid_argument if the number is not a valid stream identifier
+ */
 template<typename T>
-void runEventLoop(std::istream& source, EventListener<T>& listener)
+StreamId toStreamId(T number)
 {
-    using namespace details;
+    if(static_cast<long double>(number) > static_cast<long double>(std::numeric_limits<StreamId>::max()) or
+       static_cast<T>(static_cast<StreamId>(number)) != number)
+    {
+        throw std::invalid_argument("invalid stream id");
+    }
+    return static_cast<StreamId>(number);
+}
 
+/// \brief Checks whether the character may follow stream_marker (i.e. starts a value or is a marker).
+inline bool isStreamEventStart(int next)
+{
+    return next == calc_median_marker or next == seq_end_marker or (next >= '1' and next <= '9');
+}
+
+template<typename T>
+void readEvents(std::istream& source, EventBatch<T>& batch)
+{
     char next;
     bool separatorExpected = false;
     T newValue{};
     EventType type;
+    StreamId stream = default_stream;
 
     while(not source.eof())
     {
@@ -76,6 +98,27 @@ void runEventLoop(std::istream& source, EventListener<T>& listener)
                 newValue = consumeNextAsNewValue<T>(source);
                 separatorExpected = true;
                 type = EventType::new_value;
+                if(not source.eof() and source.peek() == stream_marker)
+                {
+                    // the number identifies the stream the following value or marker belongs to
+                    stream = toStreamId(newValue);
+                    newValue = {};
+                    consumeNextAsMarker(source);
+                    next = static_cast<char>(source.peek());
+                    if(not source.good() or not isStreamEventStart(next))
+                    {
+                        throw std::invalid_argument("unexpected character");
+                    }
+                    if(next == calc_median_marker or next == seq_end_marker)
+                    {
+                        consumeNextAsMarker(source);
+                        type = next == calc_median_marker ? EventType::calculate_median : EventType::sequence_end;
+                    }
+                    else
+                    {
+                        newValue = consumeNextAsNewValue<T>(source);
+                    }
+                }
             }
             else if(next == separator_marker)
             {
@@ -93,14 +136,45 @@ void runEventLoop(std::istream& source, EventListener<T>& listener)
 
             if(separatorExpected)
             {
-                if(not listener.newEvent(Event<T>{type, newValue}))
+                Event<T> event{type, newValue};
+                event.stream = stream;
+                if(not batch.add(static_cast<Event<T>&&>(event)))
                 {
                     break;
                 }
                 newValue = {};
+                stream = default_stream;
             }
         }
     }
 }
 
+} // namespace details
+
+/**
+    \brief Reads the input sequence from the stream and notifies the listener about each event.
+        Events are passed to the listener in batches, so the stream may be read ahead of the last event
+        the listener was interested in. Events preceding malformed input are passed before the error is raised.
+    \throws std::invalid_argument if the input is malformed
+ */
+template<typename T>
+void runEventLoop(std::istream& source, EventListener<T>& listener)
+{
+    details::EventBatch<T> batch{listener};
+    try
+    {
+        details::readEvents(source, batch);
+    }
+    catch(std::invalid_argument&)
+    {
+        // the listener could have stopped before reaching the malformed input
+        if(batch.flush())
+        {
+            throw;
+        }
+        return;
+    }
+    batch.flush();
+}
+
 } // namespace tplx
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Comparators.h"
+#include <cstddef>
+
+namespace tplx
+{
+namespace details
+{
+
+template <typename T>
+void swapValues(T& lhs, T& rhs) noexcept
+{
+    auto tmp = static_cast<T&&>(lhs);
+    lhs = static_cast<T&&>(rhs);
+    rhs = static_cast<T&&>(tmp);
+}
+
+/**
+    \brief Sorts [first, last) range in ascending order (according to \a cmp) using insertion sort.
+        Efficient for short ranges only.
+ */
+template <typename T, typename Compare = Less<T>>
+void insertionSort(T* first, T* last, Compare cmp = Compare{}) noexcept
+{
+    if (first == last)
+    {
+        return;
+    }
+    for (auto i = first + 1; i != last; ++i)
+    {
+        auto value = static_cast<T&&>(*i);
+        auto j = i;
+        while (j != first and cmp(value, *(j - 1)))
+        {
+            *j = static_cast<T&&>(*(j - 1));
+            --j;
+        }
+        *j = static_cast<T&&>(value);
+    }
+}
+
+/**
+    \brief Partitions [first, last) range around the median of its first, middle and last element.
+        Implements Hoare partition scheme. The range must contain at least 3 elements.
+    \return pointer p such that no element of [p, last) is less (according to \a cmp) than any element
+        of [first, p), both subranges are not empty
+ */
+template <typename T, typename Compare = Less<T>>
+T* partitionAroundMedianOfThree(T* first, T* last, Compare cmp = Compare{}) noexcept
+{
+    auto middle = first + (last - first) / 2;
+    auto back = last - 1;
+    if (cmp(*middle, *first))
+    {
+        swapValues(*middle, *first);
+    }
+    if (cmp(*back, *middle))
+    {
+        swapValues(*back, *middle);
+        if (cmp(*middle, *first))
+        {
+            swapValues(*middle, *first);
+        }
+    }
+    const auto pivot = *middle;
+    auto i = first - 1;
+    auto j = last;
+    while (true)
+    {
+        do
+        {
+            ++i;
+        } while (cmp(*i, pivot));
+        do
+        {
+            --j;
+        } while (cmp(pivot, *j));
+        if (i >= j)
+        {
+            return j + 1;
+        }
+        swapValues(*i, *j);
+    }
+}
+
+/**
+    \brief Partitions [first, last) range so that elements less than the pivot precede the other ones.
+    \return pointer to the first element which is not less than the pivot
+ */
+template <typename T>
+T* partitionByPivot(T* first, T* last, T pivot) noexcept
+{
+    while (true)
+    {
+        while (first != last and *first < pivot)
+        {
+            ++first;
+        }
+        while (first != last and not(*(last - 1) < pivot))
+        {
+            --last;
+        }
+        if (first == last)
+        {
+            return first;
+        }
+        swapValues(*first, *(last - 1));
+    }
+}
+
+/**
+    \brief Sorts [first, last) range in ascending order (quicksort switching to insertion sort for short ranges).
+        Recursion always handles the shorter subrange, so the stack depth is O(log n).
+ */
+template <typename T, typename Compare = Less<T>>
+void sort(T* first, T* last, Compare cmp = Compare{}) noexcept
+{
+    constexpr std::ptrdiff_t insertionSortThreshold = 16;
+    while (last - first > insertionSortThreshold)
+    {
+        auto split = partitionAroundMedianOfThree(first, last, cmp);
+        if (split - first < last - split)
+        {
+            sort(first, split, cmp);
+            first = split;
+        }
+        else
+        {
+            sort(split, last, cmp);
+            last = split;
+        }
+    }
+    insertionSort(first, last, cmp);
+}
+
+/**
+    \brief Rearranges [first, last) range so that the element pointed by \a nth is the one which would be
+        there if the range was sorted, no element of [first, nth) is greater than it and no element of
+        (nth, last) is less than it (quickselect, average O(n)).
+ */
+template <typename T, typename Compare = Less<T>>
+void selectNth(T* first, T* nth, T* last, Compare cmp = Compare{}) noexcept
+{
+    constexpr std::ptrdiff_t insertionSortThreshold = 16;
+    while (last - first > insertionSortThreshold)
+    {
+        auto split = partitionAroundMedianOfThree(first, last, cmp);
+        if (nth < split)
+        {
+            last = split;
+        }
+        else
+        {
+            first = split;
+        }
+    }
+    insertionSort(first, last, cmp);
+}
+
+} // namespace details
+} // namespace tplx
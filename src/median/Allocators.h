@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+namespace tplx
+{
+
+/**
+    \brief Allocation policy of HeapStorage using the global operator new (default).
+
+        Every allocation policy provides:
+        - void* allocate(std::size_t bytes) returning memory aligned for any fundamental type
+          or throwing std::bad_alloc,
+        - void deallocate(void* memory, std::size_t bytes) noexcept accepting memory returned by allocate()
+          of an equal policy object along with its size.
+        Policy objects are copied along with the storage, so policies referring to a shared memory resource
+        keep just a pointer to it.
+ */
+struct NewAllocator
+{
+    void* allocate(std::size_t bytes)
+    {
+        return ::operator new(bytes);
+    }
+    void deallocate(void* memory, std::size_t) noexcept
+    {
+        ::operator delete(memory);
+    }
+};
+
+/**
+    \brief Monotonic memory resource: allocates by bumping a pointer within big slabs and frees all memory
+        at once (release() or destruction). Deallocation of a single block is a no-op, so it suits many
+        short-living objects whose memory can be dropped together, e.g. calculators of a batch of streams.
+        NOTE: Not thread safe.
+ */
+class MonotonicArena
+{
+public:
+    /// \brief Default size of slabs requested from the global operator new.
+    static constexpr std::size_t default_slab_size = 1024 * 1024;
+
+    explicit MonotonicArena(std::size_t slabSize = default_slab_size) noexcept
+        : slabs_{nullptr}, current_{nullptr}, end_{nullptr}, slabSize_{slabSize}, allocated_{0}
+    {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena()
+    {
+        release();
+    }
+
+    /**
+        \brief Returns \a bytes of memory aligned for any fundamental type.
+            Blocks bigger than the slab size get a dedicated slab.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void* allocate(std::size_t bytes)
+    {
+        bytes = alignUp(bytes == 0 ? 1 : bytes);
+        if (static_cast<std::size_t>(end_ - current_) < bytes)
+        {
+            addSlab(bytes > slabSize_ ? bytes : slabSize_);
+        }
+        const auto allocated = current_;
+        current_ += bytes;
+        allocated_ += bytes;
+        return allocated;
+    }
+
+    /// \brief Frees all slabs in O(number of slabs), all memory returned by the arena becomes invalid.
+    void release() noexcept
+    {
+        while (slabs_)
+        {
+            const auto next = slabs_->next;
+            ::operator delete(slabs_);
+            slabs_ = next;
+        }
+        current_ = nullptr;
+        end_ = nullptr;
+        allocated_ = 0;
+    }
+
+    /// \brief Returns number of bytes allocated since the last release().
+    std::size_t allocated() const noexcept
+    {
+        return allocated_;
+    }
+
+private:
+    struct alignas(std::max_align_t) Slab
+    {
+        Slab* next;
+    };
+
+    static std::size_t alignUp(std::size_t bytes) noexcept
+    {
+        constexpr std::size_t alignment = alignof(std::max_align_t);
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    void addSlab(std::size_t bytes)
+    {
+        auto slab = static_cast<Slab*>(::operator new(sizeof(Slab) + bytes));
+        slab->next = slabs_;
+        slabs_ = slab;
+        current_ = reinterpret_cast<char*>(slab + 1);
+        end_ = current_ + bytes;
+    }
+
+    Slab* slabs_;
+    char* current_;
+    char* end_;
+    std::size_t slabSize_;
+    std::size_t allocated_;
+};
+
+/**
+    \brief Memory resource keeping freed blocks on per size class free lists (powers of two), so blocks
+        released by one object are reused by another one without calling the global allocator.
+        Both allocation and deallocation are O(1). Pooled blocks are carved out of an owned MonotonicArena
+        and are freed together with the pool, blocks bigger than \a max_pooled_size are passed directly
+        to the global operator new.
+        NOTE: Not thread safe.
+ */
+class SizeClassPool
+{
+public:
+    /// \brief Size of the biggest block kept by the pool.
+    static constexpr std::size_t max_pooled_size = 256 * 1024;
+
+    SizeClassPool() noexcept : freeLists_{}
+    {
+    }
+
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    /**
+        \brief Returns block of at least \a bytes bytes aligned for any fundamental type.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes > max_pooled_size)
+        {
+            return ::operator new(bytes);
+        }
+        const auto sizeClass = sizeClassOf(bytes);
+        if (auto block = freeLists_[sizeClass])
+        {
+            freeLists_[sizeClass] = block->next;
+            return block;
+        }
+        return arena_.allocate(min_block_size << sizeClass);
+    }
+
+    /// \brief Returns the block of the given size to the pool.
+    void deallocate(void* memory, std::size_t bytes) noexcept
+    {
+        if (bytes > max_pooled_size)
+        {
+            ::operator delete(memory);
+            return;
+        }
+        const auto sizeClass = sizeClassOf(bytes);
+        const auto block = static_cast<FreeBlock*>(memory);
+        block->next = freeLists_[sizeClass];
+        freeLists_[sizeClass] = block;
+    }
+
+private:
+    static constexpr std::size_t min_block_size = 16;
+
+    static constexpr std::size_t size_classes_count = 15;
+
+    static_assert((min_block_size << (size_classes_count - 1)) == max_pooled_size, "size classes mismatch");
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    static std::size_t sizeClassOf(std::size_t bytes) noexcept
+    {
+        std::size_t sizeClass = 0;
+        while ((min_block_size << sizeClass) < bytes)
+        {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    MonotonicArena arena_;
+    FreeBlock* freeLists_[size_classes_count];
+};
+
+/// \brief Allocation policy of HeapStorage taking memory from the shared MonotonicArena.
+class ArenaAllocator
+{
+public:
+    explicit ArenaAllocator(MonotonicArena& arena) noexcept : arena_{&arena}
+    {
+    }
+    void* allocate(std::size_t bytes)
+    {
+        return arena_->allocate(bytes);
+    }
+    void deallocate(void*, std::size_t) noexcept
+    {
+        // memory is freed along with the whole arena
+    }
+
+private:
+    MonotonicArena* arena_;
+};
+
+/// \brief Allocation policy of HeapStorage taking memory from the shared SizeClassPool.
+class PoolAllocator
+{
+public:
+    explicit PoolAllocator(SizeClassPool& pool) noexcept : pool_{&pool}
+    {
+    }
+    void* allocate(std::size_t bytes)
+    {
+        return pool_->allocate(bytes);
+    }
+    void deallocate(void* memory, std::size_t bytes) noexcept
+    {
+        pool_->deallocate(memory, bytes);
+    }
+
+private:
+    SizeClassPool* pool_;
+};
+
+} // namespace tplx
@@ -17,7 +17,8 @@ struct Greater
 {
     constexpr bool operator()(const T& lhs, const T& rhs) const
     {
-        return lhs > rhs;
+        // expressed by operator< so custom types need to define only that one
+        return rhs < lhs;
     }
 };
 
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "HeapStorage.h"
+#include "HeapStorageTypeTraits.h"
+#include "MedianTraits.h"
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates running median of integral values from the range declared up front (e.g. status codes,
+        latencies in milliseconds below 65536) by counting occurrences of each value.
+
+        Counts are kept in a two-level histogram: a bucket per value and a block count per \a block_size
+        consecutive values. The calculator tracks the bucket holding the lower middle value and the number
+        of values below it. Adding a value moves the middle rank by at most one, so the tracked bucket moves
+        at most to the adjacent non-empty bucket, found by skipping empty blocks. Hence add() is O(1) for
+        dense domains, calculate() reads the tracked bucket only, and memory usage is fixed by the range
+        (sizeof(Count) bytes per value). Occurrences of each value are counted by the unsigned \a Count type,
+        which limits number of equal values to its maximum (add() throws instead of wrapping around).
+ */
+template <typename T, typename Count = std::uint32_t>
+class CountingMedianCalculator
+{
+    static_assert(details::isIntegral<T>(), "CountingMedianCalculator supports integral values only");
+    static_assert(static_cast<Count>(-1) > Count{0}, "Count has to be an unsigned integral type");
+
+public:
+    /// \brief Number of consecutive values sharing a block count.
+    static constexpr std::size_t block_size = 256;
+
+    /**
+        \brief Constructs calculator of values from the [min, max] range.
+        \throws std::invalid_argument if the range is empty or too wide to be counted
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    CountingMedianCalculator(T min, T max);
+
+    /**
+        \brief Adds a new value to the set.
+        \throws std::out_of_range if the value is outside of the declared range
+        \throws std::overflow_error if the count of the value has reached the maximum of \a Count
+        \param value - value to add.
+     */
+    void add(T value);
+
+    /**
+        \brief Adds all values from the [first, last) range to the set.
+        \throws std::out_of_range if a value is outside of the declared range (preceding values are added)
+        \throws std::overflow_error if the count of a value would overflow (preceding values are added)
+     */
+    void addRange(const T* first, const T* last);
+
+    /**
+        \brief Calculates median from all so far collected values.
+            NOTE: Median of empty set is NAN.
+
+        \return median value
+     */
+    double calculate() const noexcept;
+
+    /**
+        \brief Reset internal state, so median will be calculated from scratch starting with the
+            nearest added new value. Takes time proportional to the declared range.
+     */
+    void reset() noexcept;
+
+    /// \brief Returns number of values in the set.
+    std::size_t size() const noexcept;
+
+    T min() const noexcept;
+    T max() const noexcept;
+
+private:
+    using Unsigned = unsigned long long;
+
+    std::size_t indexOf(T value) const noexcept;
+    T valueOf(std::size_t index) const noexcept;
+    /// \brief Returns index of the nearest non-empty bucket preceding the given one (such bucket must exist).
+    std::size_t previous(std::size_t index) const noexcept;
+    /// \brief Returns index of the nearest non-empty bucket following the given one (such bucket must exist).
+    std::size_t next(std::size_t index) const noexcept;
+
+    details::HeapStorage<Count> counts_;
+    details::HeapStorage<std::size_t> blockCounts_;
+    T min_;
+    T max_;
+    std::size_t size_;
+    // bucket holding the lower middle value and number of values in the preceding buckets
+    std::size_t middle_;
+    std::size_t below_;
+};
+
+template <typename T, typename Count>
+CountingMedianCalculator<T, Count>::CountingMedianCalculator(T min, T max)
+    : min_{min}, max_{max}, size_{0}, middle_{0}, below_{0}
+{
+    if (max < min)
+    {
+        throw std::invalid_argument("empty value range");
+    }
+    // two's complement arithmetic gives the distance of signed values too
+    const auto span = static_cast<Unsigned>(max) - static_cast<Unsigned>(min);
+    if (span >= static_cast<std::size_t>(-1) / sizeof(Count) - block_size)
+    {
+        throw std::invalid_argument("value range too wide");
+    }
+    const auto range = static_cast<std::size_t>(span) + 1;
+    counts_.resize(range);
+    blockCounts_.resize((range + block_size - 1) / block_size);
+}
+
+template <typename T, typename Count>
+std::size_t CountingMedianCalculator<T, Count>::indexOf(T value) const noexcept
+{
+    return static_cast<std::size_t>(static_cast<Unsigned>(value) - static_cast<Unsigned>(min_));
+}
+
+template <typename T, typename Count>
+T CountingMedianCalculator<T, Count>::valueOf(std::size_t index) const noexcept
+{
+    return static_cast<T>(static_cast<Unsigned>(min_) + index);
+}
+
+template <typename T, typename Count>
+void CountingMedianCalculator<T, Count>::add(T value)
+{
+    if (value < min_ or max_ < value)
+    {
+        throw std::out_of_range("value out of the declared range");
+    }
+    const auto index = indexOf(value);
+    if (counts_[index] == static_cast<Count>(-1))
+    {
+        throw std::overflow_error("too many equal values");
+    }
+    ++counts_[index];
+    ++blockCounts_[index / block_size];
+    if (size_++ == 0)
+    {
+        middle_ = index;
+        below_ = 0;
+        return;
+    }
+    below_ += index < middle_ ? 1 : 0;
+    const auto rank = (size_ - 1) / 2;
+    if (rank < below_)
+    {
+        middle_ = previous(middle_);
+        below_ -= counts_[middle_];
+    }
+    else if (rank >= below_ + counts_[middle_])
+    {
+        below_ += counts_[middle_];
+        middle_ = next(middle_);
+    }
+}
+
+template <typename T, typename Count>
+void CountingMedianCalculator<T, Count>::addRange(const T* first, const T* last)
+{
+    while (first != last)
+    {
+        add(*first++);
+    }
+}
+
+template <typename T, typename Count>
+double CountingMedianCalculator<T, Count>::calculate() const noexcept
+{
+    using Traits = MedianTraits<T>;
+    if (size_ == 0)
+    {
+        return Traits::empty();
+    }
+    const auto lower = valueOf(middle_);
+    // the upper middle value is in the same bucket unless the lower one is the last value of the bucket
+    if (size_ % 2 != 0 or (size_ - 1) / 2 + 1 < below_ + counts_[middle_])
+    {
+        return Traits::middle(lower);
+    }
+    return Traits::mean(lower, valueOf(next(middle_)));
+}
+
+template <typename T, typename Count>
+std::size_t CountingMedianCalculator<T, Count>::previous(std::size_t index) const noexcept
+{
+    const auto blockBegin = index / block_size * block_size;
+    while (index > blockBegin)
+    {
+        if (counts_[--index] != 0)
+        {
+            return index;
+        }
+    }
+    auto block = blockBegin / block_size;
+    while (blockCounts_[--block] == 0)
+    {
+    }
+    index = (block + 1) * block_size;
+    while (counts_[--index] == 0)
+    {
+    }
+    return index;
+}
+
+template <typename T, typename Count>
+std::size_t CountingMedianCalculator<T, Count>::next(std::size_t index) const noexcept
+{
+    const auto blockEnd = (index / block_size + 1) * block_size;
+    while (++index < blockEnd and index < counts_.size())
+    {
+        if (counts_[index] != 0)
+        {
+            return index;
+        }
+    }
+    auto block = blockEnd / block_size;
+    while (blockCounts_[block] == 0)
+    {
+        ++block;
+    }
+    index = block * block_size;
+    while (counts_[index] == 0)
+    {
+        ++index;
+    }
+    assert(index < counts_.size());
+    return index;
+}
+
+template <typename T, typename Count>
+void CountingMedianCalculator<T, Count>::reset() noexcept
+{
+    for (auto& count : counts_)
+    {
+        count = 0;
+    }
+    for (auto& count : blockCounts_)
+    {
+        count = 0;
+    }
+    size_ = 0;
+    middle_ = 0;
+    below_ = 0;
+}
+
+template <typename T, typename Count>
+std::size_t CountingMedianCalculator<T, Count>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T, typename Count>
+T CountingMedianCalculator<T, Count>::min() const noexcept
+{
+    return min_;
+}
+
+template <typename T, typename Count>
+T CountingMedianCalculator<T, Count>::max() const noexcept
+{
+    return max_;
+}
+
+} // namespace tplx
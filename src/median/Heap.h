@@ -1,20 +1,66 @@
 #pragma once
 
+#include "Algorithms.h"
 #include "Comparators.h"
 #include "HeapStorage.h"
 
 namespace tplx
 {
+namespace details
+{
+
+/**
+    \brief Returns index of the "greatest" (according to \a cmp) of \a count children of a heap node,
+        the first one in case of ties.
+        A full group of \a Arity children is scanned by a loop with the trip count known at compile time,
+        which compilers unroll and turn into branchless (vector) min/max instructions for integral types.
+ */
+template <std::size_t Arity, typename T, typename Compare>
+std::size_t selectChild(const T* children, std::size_t count, Compare cmp) noexcept
+{
+    auto best = children[0];
+    if (count == Arity)
+    {
+        for (std::size_t i = 1; i < Arity; i++)
+        {
+            best = cmp(best, children[i]) ? children[i] : best;
+        }
+    }
+    else
+    {
+        for (std::size_t i = 1; i < count; i++)
+        {
+            best = cmp(best, children[i]) ? children[i] : best;
+        }
+    }
+    std::size_t selected = 0;
+    while (cmp(children[selected], best))
+    {
+        ++selected;
+    }
+    return selected;
+}
+
+} // namespace details
 
 /**
     \brief Implementation of the HEAP data structure
         inspired by "Introduction To Algorithms" (Thomas H. Cormen et. all)
+
+        The heap is d-ary: each node has up to \a Arity children stored next to each other in the underlying
+        array, so choosing the child to descend to reads a single contiguous block of memory (e.g. 32 bytes
+        for 8-ary heap of int). Bigger arity makes the heap shallower, which saves cache misses of pop() in
+        big heaps at the cost of more comparisons per level.
+        Depths of sift-up and sift-down operations and allocations are reported to the \a Stats policy.
  */
-template <typename T, typename Compare>
-class Heap : private details::HeapStorage<T>
+template <typename T, typename Compare, std::size_t Arity = 2, typename Allocator = NewAllocator,
+          typename Stats = NoStats>
+class Heap : private details::HeapStorage<T, Allocator, Stats>
 {
+    static_assert(Arity >= 2, "Heap requires at least two children per node");
+
 private:
-    using Storage = details::HeapStorage<T>;
+    using Storage = details::HeapStorage<T, Allocator, Stats>;
 
 public:
     using value_type = typename Storage::value_type;
@@ -36,6 +82,12 @@ public:
         \param cmp - comparator.
      */
     explicit Heap(Compare cmp);
+    /**
+        \brief Constructs Heap structure using provided comparator object and allocation policy.
+        \param cmp - comparator.
+        \param allocator - allocation policy of the underlying storage (see NewAllocator).
+     */
+    Heap(Compare cmp, Allocator allocator);
 
     /**
         \brief Inserts new element to the heap.
@@ -44,11 +96,62 @@ public:
      */
     void insert(T item);
 
+    /**
+        \brief Inserts all elements from the [first, last) range to the heap.
+            Elements are appended to the underlying array at once. The heap property is then restored either
+            by sifting up each new element or, if the range is big compared to the heap, by rebuilding the
+            whole heap bottom-up (Floyd's method, O(n)).
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void insert(const_iterator first, const_iterator last);
+
+    /**
+        \brief Replaces content of the heap with the [first, last) range, which must already be a heap
+            of this type (e.g. a copy of the begin()/end() range of another heap), so the elements are copied
+            at once without restoring the heap property (used to restore snapshots).
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void assign(const_iterator first, const_iterator last);
+
+    /**
+        \brief Replaces content of the heap with the [first, last) range like assign(), but checks (in O(n))
+            whether the range is a heap of this type, e.g. read from an untrusted snapshot.
+        \throws std::bad_alloc if there is not enough memory available
+        \return true if the range is a heap, otherwise the heap is left empty
+     */
+    bool tryAssign(const_iterator first, const_iterator last);
+
     /**
         \brief Removes top element from the heap.
      */
     void pop() noexcept;
 
+    /**
+        \brief Removes \a count top-most elements from the heap and writes them (in unspecified order) to \a out.
+            Uses either repeated pop() or, if \a count is big compared to the heap, selection followed by
+            rebuilding the rest of the heap bottom-up (O(n)).
+        \param count - number of elements to remove, must not be greater than size()
+        \param out - destination buffer of at least \a count constructed elements (removed ones are move-assigned)
+     */
+    void pop(size_type count, pointer out) noexcept;
+
+    /**
+        \brief Replaces top element of the heap with the new element, which is cheaper than pop() followed
+            by insert() as the heap is traversed once (top-down). The heap must not be empty.
+        \param item - new element
+        \return replaced top element
+     */
+    T replaceTop(T item) noexcept;
+
+    /**
+        \brief Inserts new element to the heap and removes the top element, i.e. returns the "greatest" of
+            the new element and the heap elements. The heap is not modified at all if the new element is
+            the "greatest" one, otherwise it is traversed once (see replaceTop()).
+        \param item - new element
+        \return removed element
+     */
+    T pushPop(T item) noexcept;
+
     /**
         \brief Returns top element of the heap.
         \return top element.
@@ -56,7 +159,10 @@ public:
     T top() const noexcept;
 
     using Storage::clear;
+    using Storage::release;
     using Storage::reserve;
+    using Storage::get_allocator;
+    using Storage::stats;
 
     using Storage::empty;
     using Storage::size;
@@ -69,52 +175,101 @@ public:
 private:
     size_type parent(size_type index) const noexcept
     {
-        return (index - 1) / 2;
-    }
-    size_type left(size_type index) const noexcept
-    {
-        return 2 * index + 1;
+        return (index - 1) / Arity;
     }
-    size_type right(size_type index) const noexcept
+    size_type firstChild(size_type index) const noexcept
     {
-        return 2 * index + 2;
+        return Arity * index + 1;
     }
 
     /// \brief Implements MAX-HEAPIFY/MIN-HEAPIFY procedure
     void heapify(size_type index) noexcept;
 
+    /// \brief Implements BUILD-MAX-HEAP/BUILD-MIN-HEAP procedure
+    void build() noexcept;
+
+    /// \brief Moves element towards the root as long as it is "greater" than its parent
+    void siftUp(size_type index) noexcept;
+
+    /// \brief Checks the heap property of all elements.
+    bool valid() const noexcept;
+
+    /// \brief Returns true if processing \a count elements one by one is cheaper than rebuilding the heap
+    bool preferIncremental(size_type count) const noexcept;
+
     Compare cmp_;
 };
 
-template <typename T = int>
-using MaxHeap = Heap<T, Less<T>>;
+template <typename T = int, std::size_t Arity = 2, typename Allocator = NewAllocator, typename Stats = NoStats>
+using MaxHeap = Heap<T, Less<T>, Arity, Allocator, Stats>;
 
-template <typename T = int>
-using MinHeap = Heap<T, Greater<T>>;
+template <typename T = int, std::size_t Arity = 2, typename Allocator = NewAllocator, typename Stats = NoStats>
+using MinHeap = Heap<T, Greater<T>, Arity, Allocator, Stats>;
 
 // -------------------------------------------------------------------------- //
 
-template <typename T, typename Compare>
-Heap<T, Compare>::Heap(Compare cmp) : cmp_{cmp}
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+Heap<T, Compare, Arity, Allocator, Stats>::Heap(Compare cmp) : cmp_{cmp}
+{
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+Heap<T, Compare, Arity, Allocator, Stats>::Heap(Compare cmp, Allocator allocator) : Storage{allocator}, cmp_{cmp}
 {
 }
 
 /// \brief Implements MAX-HEAP-INSERT/MIN-HEAP-INSERT procedure
-template <typename T, typename Compare>
-void Heap<T, Compare>::insert(T item)
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::insert(T item)
 {
     this->push_back(item);
-    auto i = this->size() - 1;
-    while (i > 0 and cmp_(this->operator[](parent(i)), this->operator[](i)))
+    siftUp(this->size() - 1);
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::insert(const_iterator first, const_iterator last)
+{
+    const auto count = static_cast<size_type>(last - first);
+    const auto incremental = preferIncremental(count);
+    const auto oldSize = this->size();
+    this->append(first, last);
+    if (incremental)
     {
-        this->swap(i, parent(i));
-        i = parent(i);
+        for (auto i = oldSize; i < this->size(); i++)
+        {
+            siftUp(i);
+        }
+    }
+    else
+    {
+        build();
+    }
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::assign(const_iterator first, const_iterator last)
+{
+    this->clear();
+    this->append(first, last);
+    assert(valid());
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+bool Heap<T, Compare, Arity, Allocator, Stats>::tryAssign(const_iterator first, const_iterator last)
+{
+    this->clear();
+    this->append(first, last);
+    if (not valid())
+    {
+        this->clear();
+        return false;
     }
+    return true;
 }
 
 /// \brief Implements HEAP-EXTRACT-MAX/HEAP-EXTRACT-MIN procedure
-template <typename T, typename Compare>
-void Heap<T, Compare>::pop() noexcept
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::pop() noexcept
 {
     this->swap(0, this->size() - 1);
     this->pop_back();
@@ -124,43 +279,142 @@ void Heap<T, Compare>::pop() noexcept
     }
 }
 
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::pop(size_type count, pointer out) noexcept
+{
+    assert(count <= this->size());
+    if (preferIncremental(count))
+    {
+        for (size_type i = 0; i < count; i++)
+        {
+            out[i] = top();
+            pop();
+        }
+        return;
+    }
+    // the top-most elements are moved to the back of the array
+    const auto remaining = this->size() - count;
+    details::selectNth(this->begin(), this->begin() + remaining, this->end(), cmp_);
+    const auto topMost = this->begin() + remaining;
+    for (size_type i = 0; i < count; i++)
+    {
+        out[i] = static_cast<T&&>(topMost[i]);
+    }
+    this->pop_back(count);
+    build();
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+T Heap<T, Compare, Arity, Allocator, Stats>::replaceTop(T item) noexcept
+{
+    assert(not this->empty());
+    auto replaced = static_cast<T&&>(this->front());
+    this->front() = static_cast<T&&>(item);
+    heapify(0);
+    return replaced;
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+T Heap<T, Compare, Arity, Allocator, Stats>::pushPop(T item) noexcept
+{
+    if (this->empty() or not cmp_(item, this->front()))
+    {
+        return item;
+    }
+    return replaceTop(static_cast<T&&>(item));
+}
+
 /// \brief Implements HEAP-MAXIMUM/HEAP-MINIMUM procedure
-template <typename T, typename Compare>
-T Heap<T, Compare>::top() const noexcept
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+T Heap<T, Compare, Arity, Allocator, Stats>::top() const noexcept
 {
     return this->front();
 }
 
 /// \brief Implements MAX-HEAPIFY/MIN-HEAPIFY procedure
-template <typename T, typename Compare>
-void Heap<T, Compare>::heapify(size_type index) noexcept
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::heapify(size_type index) noexcept
 {
-    auto compare = [this](size_type lhs, size_type rhs){
-        return rhs <= (size() - 1) and cmp_(this->operator[](lhs), this->operator[](rhs));
-    };
+    // the element is moved down through a "hole" instead of being swapped at each level
+    const auto length = this->size();
+    const auto items = this->data();
+    auto item = static_cast<T&&>(items[index]);
+    size_type levels = 0;
     while (true)
     {
-        auto l = left(index);
-        auto r = right(index);
-        auto selected = index;
-        if(compare(selected, l))
+        const auto first = firstChild(index);
+        if (first >= length)
         {
-            selected = l;
-        }
-        if(compare(selected, r))
-        {
-            selected = r;
+            break;
         }
-        if (selected != index)
+        const auto count = length - first < Arity ? length - first : Arity;
+        const auto selected = first + details::selectChild<Arity>(items + first, count, cmp_);
+        if (not cmp_(item, items[selected]))
         {
-            this->swap(selected, index);
-            index = selected;
+            break;
         }
-        else
+        items[index] = static_cast<T&&>(items[selected]);
+        index = selected;
+        ++levels;
+    }
+    items[index] = static_cast<T&&>(item);
+    this->stats().siftedDown(levels);
+}
+
+/// \brief Implements BUILD-MAX-HEAP/BUILD-MIN-HEAP procedure
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::build() noexcept
+{
+    if (this->size() < 2)
+    {
+        return;
+    }
+    for (auto i = parent(this->size() - 1) + 1; i > 0; i--)
+    {
+        heapify(i - 1);
+    }
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+void Heap<T, Compare, Arity, Allocator, Stats>::siftUp(size_type index) noexcept
+{
+    const auto items = this->data();
+    auto item = static_cast<T&&>(items[index]);
+    size_type levels = 0;
+    while (index > 0 and cmp_(items[parent(index)], item))
+    {
+        items[index] = static_cast<T&&>(items[parent(index)]);
+        index = parent(index);
+        ++levels;
+    }
+    items[index] = static_cast<T&&>(item);
+    this->stats().siftedUp(levels);
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+bool Heap<T, Compare, Arity, Allocator, Stats>::valid() const noexcept
+{
+    const auto items = this->data();
+    for (size_type i = 1; i < this->size(); i++)
+    {
+        if (cmp_(items[parent(i)], items[i]))
         {
-            break;
+            return false;
         }
     }
+    return true;
+}
+
+template <typename T, typename Compare, std::size_t Arity, typename Allocator, typename Stats>
+bool Heap<T, Compare, Arity, Allocator, Stats>::preferIncremental(size_type count) const noexcept
+{
+    // each of count O(log n) steps versus rebuilding the whole heap in about 2n steps
+    size_type height = 1;
+    for (auto n = this->size() + count; n > 1; n /= Arity)
+    {
+        ++height;
+    }
+    return count * height < 2 * (this->size() + count);
 }
 
 } // namespace tplx
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Allocators.h"
 #include "HeapStorageTypeTraits.h"
+#include "Stats.h"
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -11,8 +13,86 @@ namespace tplx
 namespace details
 {
 
+/// \brief Copy-constructs \a count elements of uninitialized memory \a out from \a first.
 template <typename T>
-class HeapStorage
+void constructCopies(const T* first, std::size_t count, T* out, TrueType) noexcept
+{
+    if (count > 0)
+    {
+        std::memcpy(out, first, count * sizeof(T));
+    }
+}
+
+template <typename T>
+void constructCopies(const T* first, std::size_t count, T* out, FalseType)
+{
+    std::size_t constructed = 0;
+    try
+    {
+        for (; constructed < count; constructed++)
+        {
+            new (out + constructed) T(first[constructed]);
+        }
+    }
+    catch (...)
+    {
+        while (constructed > 0)
+        {
+            out[--constructed].~T();
+        }
+        throw;
+    }
+}
+
+/**
+    \brief Moves \a count elements from \a first to uninitialized memory \a out, the source elements are
+        destroyed. Moving is assumed not to throw.
+ */
+template <typename T>
+void relocate(T* first, std::size_t count, T* out, TrueType) noexcept
+{
+    if (count > 0)
+    {
+        std::memcpy(out, first, count * sizeof(T));
+    }
+}
+
+template <typename T>
+void relocate(T* first, std::size_t count, T* out, FalseType) noexcept
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        new (out + i) T(static_cast<T&&>(first[i]));
+        first[i].~T();
+    }
+}
+
+template <typename T>
+void destroy(T*, std::size_t, TrueType) noexcept
+{
+}
+
+template <typename T>
+void destroy(T* first, std::size_t count, FalseType) noexcept
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        first[i].~T();
+    }
+}
+
+/**
+    \brief Extensible buffer of contiguous memory.
+        Trivially copyable types (integral and floating point numbers, plain structs) are copied and moved
+        by memcpy. Other types are copy- and move-constructed element by element, their move constructors
+        are expected not to throw.
+        Memory is obtained through the \a Allocator policy (see NewAllocator), so many storages may share
+        a single memory resource (e.g. MonotonicArena or SizeClassPool). The buffer of trivially copyable
+        elements is resized in place if the policy provides reallocate() (e.g. MappedAllocator), otherwise
+        elements are moved to a new buffer. Allocations are reported to the \a Stats policy (see NoStats).
+ */
+template <typename T, typename Allocator = NewAllocator, typename Stats = NoStats>
+class HeapStorage : private Allocator, private Stats
 {
 public:
     using value_type = T;
@@ -26,6 +106,7 @@ public:
     using difference_type = std::ptrdiff_t;
 
     HeapStorage() noexcept;
+    explicit HeapStorage(Allocator allocator) noexcept;
     ~HeapStorage();
 
     HeapStorage(const HeapStorage& other);
@@ -45,8 +126,12 @@ public:
 
     // modifiers
     void push_back(value_type item);
+    void append(const_iterator first, const_iterator last);
     void pop_back() noexcept;
+    void pop_back(size_type count) noexcept;
+    void resize(size_type count);
     void clear() noexcept;
+    void release() noexcept;
     void swap(size_type a, size_type b) noexcept;
 
     // capacity
@@ -56,6 +141,13 @@ public:
     size_type capacity() const noexcept;
     void shrink_to_fit();
 
+    // allocator
+    Allocator get_allocator() const noexcept;
+
+    // statistics
+    Stats& stats() noexcept;
+    const Stats& stats() const noexcept;
+
     // iterators
     const_iterator begin() const noexcept;
     const_iterator end() const noexcept;
@@ -65,64 +157,89 @@ public:
     iterator end() noexcept;
 
 private:
+    using Trivial = IsTriviallyCopyable<T>;
+    using InPlace = typename Conditional<Trivial::value and HasReallocate<Allocator>::value, TrueType, FalseType>::type;
+
     void adjustCapacity(size_type length, bool force_shrink = false);
+    T* allocate(size_type length);
+    void deallocate(T* storage, size_type length) noexcept;
+    void reallocate(size_type length, FalseType);
+    void reallocate(size_type length, TrueType);
 
     T* storage_;
     size_type storage_size_;
     size_type storage_capacity_;
 };
 
-template <typename T>
-HeapStorage<T>::HeapStorage() noexcept : storage_{nullptr}, storage_size_{0}, storage_capacity_{0}
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>::HeapStorage() noexcept : HeapStorage{Allocator{}}
 {
-    // Fundamental types (https://en.cppreference.com/w/cpp/language/types)
-    static_assert(
-        isTypeInTheList<T, short, unsigned short, int, unsigned, long, unsigned long, long long, unsigned long long>(),
-        "Provided type T is not supported by HeapStorage");
 }
 
-template <typename T>
-HeapStorage<T>::~HeapStorage()
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>::HeapStorage(Allocator allocator) noexcept
+    : Allocator{allocator}, Stats{}, storage_{nullptr}, storage_size_{0}, storage_capacity_{0}
+{
+    // allocation policies return memory aligned for fundamental types only
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported by HeapStorage");
+}
+
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>::~HeapStorage()
 {
     if (storage_)
     {
-        delete[] storage_;
+        destroy(storage_, storage_size_, Trivial{});
+        deallocate(storage_, storage_capacity_);
     }
 }
 
-template <typename T>
-HeapStorage<T>::HeapStorage(const HeapStorage& other) : storage_{nullptr}, storage_size_{0}, storage_capacity_{0}
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>::HeapStorage(const HeapStorage& other)
+    : Allocator{other.get_allocator()}, Stats{}, storage_{nullptr}, storage_size_{0}, storage_capacity_{0}
 {
     if (other.storage_size_ > 0)
     {
         adjustCapacity(other.storage_size_);
-        std::memcpy(storage_, other.storage_, other.storage_size_ * sizeof(value_type));
+        constructCopies(other.storage_, other.storage_size_, storage_, Trivial{});
         storage_size_ = other.storage_size_;
     }
 }
 
-template <typename T>
-HeapStorage<T>::HeapStorage(HeapStorage&& other) noexcept
-    : storage_{other.storage_}, storage_size_{other.storage_size_}, storage_capacity_{other.storage_capacity_}
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>::HeapStorage(HeapStorage&& other) noexcept
+    : Allocator{other.get_allocator()},
+      Stats{other.stats()},
+      storage_{other.storage_},
+      storage_size_{other.storage_size_},
+      storage_capacity_{other.storage_capacity_}
 {
     other.storage_ = nullptr;
     other.storage_size_ = 0;
     other.storage_capacity_ = 0;
 }
 
-template <typename T>
-HeapStorage<T>& HeapStorage<T>::operator=(const HeapStorage& other)
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>& HeapStorage<T, Allocator, Stats>::operator=(const HeapStorage& other)
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+    clear();
     adjustCapacity(other.storage_size_);
-    std::memcpy(storage_, other.storage_, other.storage_size_ * sizeof(value_type));
+    constructCopies(other.storage_, other.storage_size_, storage_, Trivial{});
     storage_size_ = other.storage_size_;
     return *this;
 }
 
-template <typename T>
-HeapStorage<T>& HeapStorage<T>::operator=(HeapStorage&& other) noexcept
+template <typename T, typename Allocator, typename Stats>
+HeapStorage<T, Allocator, Stats>& HeapStorage<T, Allocator, Stats>::operator=(HeapStorage&& other) noexcept
 {
+    clear();
     adjustCapacity(0);
+    // the memory has to be deallocated by the allocator it comes from
+    static_cast<Allocator&>(*this) = other.get_allocator();
     storage_ = other.storage_;
     storage_size_ = other.storage_size_;
     storage_capacity_ = other.storage_capacity_;
@@ -134,62 +251,64 @@ HeapStorage<T>& HeapStorage<T>::operator=(HeapStorage&& other) noexcept
     return *this;
 }
 
-template <typename T>
-typename HeapStorage<T>::reference HeapStorage<T>::operator[](size_type pos) noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::reference
+HeapStorage<T, Allocator, Stats>::operator[](size_type pos) noexcept
 {
     assert(pos <= storage_size_);
     return *(storage_ + pos);
 }
 
-template <typename T>
-typename HeapStorage<T>::const_reference HeapStorage<T>::operator[](size_type pos) const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_reference
+HeapStorage<T, Allocator, Stats>::operator[](size_type pos) const noexcept
 {
     assert(pos <= storage_size_);
     return *(storage_ + pos);
 }
 
-template <typename T>
-typename HeapStorage<T>::reference HeapStorage<T>::front() noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::reference HeapStorage<T, Allocator, Stats>::front() noexcept
 {
     assert(storage_size_ > 0);
     return *storage_;
 }
 
-template <typename T>
-typename HeapStorage<T>::const_reference HeapStorage<T>::front() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_reference HeapStorage<T, Allocator, Stats>::front() const noexcept
 {
     assert(storage_size_ > 0);
     return *storage_;
 }
 
-template <typename T>
-typename HeapStorage<T>::reference HeapStorage<T>::back() noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::reference HeapStorage<T, Allocator, Stats>::back() noexcept
 {
     assert(storage_size_ > 0);
     return *(storage_ + storage_size_ - 1);
 }
 
-template <typename T>
-typename HeapStorage<T>::const_reference HeapStorage<T>::back() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_reference HeapStorage<T, Allocator, Stats>::back() const noexcept
 {
     assert(storage_size_ > 0);
     return *(storage_ + storage_size_ - 1);
 }
 
-template <typename T>
-T* HeapStorage<T>::data() noexcept
+template <typename T, typename Allocator, typename Stats>
+T* HeapStorage<T, Allocator, Stats>::data() noexcept
 {
     return storage_;
 }
 
-template <typename T>
-const T* HeapStorage<T>::data() const noexcept
+template <typename T, typename Allocator, typename Stats>
+const T* HeapStorage<T, Allocator, Stats>::data() const noexcept
 {
     return storage_;
 }
 
-template <typename T>
-void HeapStorage<T>::reserve(size_type capacity)
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::reserve(size_type capacity)
 {
     if (capacity > storage_capacity_)
     {
@@ -198,8 +317,8 @@ void HeapStorage<T>::reserve(size_type capacity)
     }
 }
 
-template <typename T>
-void HeapStorage<T>::push_back(value_type item)
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::push_back(value_type item)
 {
     assert(storage_capacity_ >= storage_size_);
     if (storage_capacity_ == storage_size_)
@@ -208,93 +327,205 @@ void HeapStorage<T>::push_back(value_type item)
     }
     assert(storage_capacity_ >= storage_size_);
     assert(storage_);
-    storage_[storage_size_++] = item;
+    new (storage_ + storage_size_) T(static_cast<T&&>(item));
+    ++storage_size_;
 }
 
-template <typename T>
-void HeapStorage<T>::pop_back() noexcept
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::append(const_iterator first, const_iterator last)
+{
+    assert(first <= last);
+    const auto count = static_cast<size_type>(last - first);
+    if (count == 0)
+    {
+        return;
+    }
+    if (storage_capacity_ - storage_size_ < count)
+    {
+        const auto doubled = storage_capacity_ * 2;
+        adjustCapacity(doubled > storage_size_ + count ? doubled : storage_size_ + count);
+    }
+    constructCopies(first, count, storage_ + storage_size_, Trivial{});
+    storage_size_ += count;
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::pop_back() noexcept
 {
     assert(storage_size_ > 0);
     --storage_size_;
+    destroy(storage_ + storage_size_, 1, Trivial{});
 }
 
-template <typename T>
-void HeapStorage<T>::clear() noexcept
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::pop_back(size_type count) noexcept
+{
+    assert(storage_size_ >= count);
+    storage_size_ -= count;
+    destroy(storage_ + storage_size_, count, Trivial{});
+}
+
+/// \brief Changes size to \a count, new elements are value-initialized (e.g. zeroed numbers).
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::resize(size_type count)
+{
+    if (count <= storage_size_)
+    {
+        pop_back(storage_size_ - count);
+        return;
+    }
+    reserve(count);
+    while (storage_size_ < count)
+    {
+        new (storage_ + storage_size_) T();
+        ++storage_size_;
+    }
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::clear() noexcept
 {
+    destroy(storage_, storage_size_, Trivial{});
     storage_size_ = 0;
 }
 
-template <typename T>
-void HeapStorage<T>::swap(size_type a, size_type b) noexcept
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::release() noexcept
 {
-    const auto tmp = *(storage_ + b);
-    *(storage_ + b) = *(storage_ + a);
-    *(storage_ + a) = tmp;
+    clear();
+    adjustCapacity(0);
 }
 
-template <typename T>
-void HeapStorage<T>::shrink_to_fit()
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::swap(size_type a, size_type b) noexcept
+{
+    auto tmp = static_cast<T&&>(storage_[b]);
+    storage_[b] = static_cast<T&&>(storage_[a]);
+    storage_[a] = static_cast<T&&>(tmp);
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::shrink_to_fit()
 {
     adjustCapacity(storage_size_, true);
     assert(storage_size_ == storage_capacity_);
 }
 
-template <typename T>
-typename HeapStorage<T>::size_type HeapStorage<T>::size() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::size_type HeapStorage<T, Allocator, Stats>::size() const noexcept
 {
     return storage_size_;
 }
 
-template <typename T>
-typename HeapStorage<T>::size_type HeapStorage<T>::capacity() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::size_type HeapStorage<T, Allocator, Stats>::capacity() const noexcept
 {
     return storage_capacity_;
 }
 
-template <typename T>
-bool HeapStorage<T>::empty() const noexcept
+template <typename T, typename Allocator, typename Stats>
+bool HeapStorage<T, Allocator, Stats>::empty() const noexcept
 {
     return storage_size_ == 0;
 }
 
-template <typename T>
-typename HeapStorage<T>::const_iterator HeapStorage<T>::cbegin() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_iterator HeapStorage<T, Allocator, Stats>::cbegin() const noexcept
 {
     return storage_;
 }
 
-template <typename T>
-typename HeapStorage<T>::const_iterator HeapStorage<T>::cend() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_iterator HeapStorage<T, Allocator, Stats>::cend() const noexcept
 {
     return storage_ + storage_size_;
 }
 
-template <typename T>
-typename HeapStorage<T>::const_iterator HeapStorage<T>::begin() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_iterator HeapStorage<T, Allocator, Stats>::begin() const noexcept
 {
     return cbegin();
 }
 
-template <typename T>
-typename HeapStorage<T>::const_iterator HeapStorage<T>::end() const noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::const_iterator HeapStorage<T, Allocator, Stats>::end() const noexcept
 {
     return cend();
 }
 
-template <typename T>
-typename HeapStorage<T>::iterator HeapStorage<T>::begin() noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::iterator HeapStorage<T, Allocator, Stats>::begin() noexcept
 {
     return storage_;
 }
 
-template <typename T>
-typename HeapStorage<T>::iterator HeapStorage<T>::end() noexcept
+template <typename T, typename Allocator, typename Stats>
+typename HeapStorage<T, Allocator, Stats>::iterator HeapStorage<T, Allocator, Stats>::end() noexcept
 {
     return storage_ + storage_size_;
 }
 
-template <typename T>
-void HeapStorage<T>::adjustCapacity(size_type length, bool force_shrink)
+template <typename T, typename Allocator, typename Stats>
+Allocator HeapStorage<T, Allocator, Stats>::get_allocator() const noexcept
+{
+    return static_cast<const Allocator&>(*this);
+}
+
+template <typename T, typename Allocator, typename Stats>
+Stats& HeapStorage<T, Allocator, Stats>::stats() noexcept
+{
+    return static_cast<Stats&>(*this);
+}
+
+template <typename T, typename Allocator, typename Stats>
+const Stats& HeapStorage<T, Allocator, Stats>::stats() const noexcept
+{
+    return static_cast<const Stats&>(*this);
+}
+
+template <typename T, typename Allocator, typename Stats>
+T* HeapStorage<T, Allocator, Stats>::allocate(size_type length)
+{
+    // the allocator gets the size in bytes, which must not overflow
+    if (length > static_cast<size_type>(-1) / sizeof(value_type))
+    {
+        throw std::bad_alloc{};
+    }
+    return static_cast<T*>(Allocator::allocate(length * sizeof(value_type)));
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::deallocate(T* storage, size_type length) noexcept
+{
+    Allocator::deallocate(storage, length * sizeof(value_type));
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::reallocate(size_type length, FalseType)
+{
+    value_type* new_storage = allocate(length);
+    relocate(storage_, storage_size_, new_storage, Trivial{});
+    stats().reallocated(storage_size_ * sizeof(value_type));
+    deallocate(storage_, storage_capacity_);
+    storage_ = new_storage;
+    storage_capacity_ = length;
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::reallocate(size_type length, TrueType)
+{
+    if (length > static_cast<size_type>(-1) / sizeof(value_type))
+    {
+        throw std::bad_alloc{};
+    }
+    storage_ = static_cast<T*>(
+        Allocator::reallocate(storage_, storage_capacity_ * sizeof(value_type), length * sizeof(value_type)));
+    stats().reallocated(0);
+    storage_capacity_ = length;
+}
+
+template <typename T, typename Allocator, typename Stats>
+void HeapStorage<T, Allocator, Stats>::adjustCapacity(size_type length, bool force_shrink)
 {
     /*
         Possible cases:
@@ -307,13 +538,7 @@ void HeapStorage<T>::adjustCapacity(size_type length, bool force_shrink)
         6) storage_capacity_ > 0, length > 0 and storage_capacity_ = length
     */
 
-    auto realloc = [this](size_type length) {
-        value_type* new_storage = new value_type[length];
-        std::memcpy(new_storage, storage_, storage_size_ * sizeof(value_type));
-        delete[] storage_;
-        storage_ = new_storage;
-        storage_capacity_ = length;
-    };
+    auto realloc = [this](size_type length) { reallocate(length, InPlace{}); };
 
     if (length == storage_capacity_) // case #1 and #6
     {
@@ -324,14 +549,15 @@ void HeapStorage<T>::adjustCapacity(size_type length, bool force_shrink)
         assert(not storage_);
         assert(length > 0);
         // allocate
-        storage_ = new value_type[length];
+        storage_ = allocate(length);
         storage_capacity_ = length;
+        stats().reallocated(0);
     }
     else if (length == 0) // case #3
     {
         assert(storage_capacity_ > 0);
         assert(storage_);
-        delete[] storage_;
+        deallocate(storage_, storage_capacity_);
         storage_ = nullptr;
         storage_capacity_ = 0;
     }
@@ -5,14 +5,38 @@ namespace tplx
 namespace details
 {
 
-struct TrueType
+template <bool Value>
+struct BoolConstant
 {
-    static constexpr bool value = true;
+    static constexpr bool value = Value;
 };
 
-struct FalseType
+// out-of-line definition, so the member may be ODR-used (e.g. bound to a reference by EXPECT_TRUE)
+template <bool Value>
+constexpr bool BoolConstant<Value>::value;
+
+using TrueType = BoolConstant<true>;
+using FalseType = BoolConstant<false>;
+
+template <bool Condition, typename Then, typename Else>
+struct Conditional
+{
+    using type = Then;
+};
+
+template <typename Then, typename Else>
+struct Conditional<false, Then, Else>
+{
+    using type = Else;
+};
+
+/**
+    \brief Checks whether objects of type T may be copied by memcpy (the compiler builtin implementing
+        std::is_trivially_copyable).
+ */
+template <typename T>
+struct IsTriviallyCopyable : Conditional<__is_trivially_copyable(T), TrueType, FalseType>::type
 {
-    static constexpr bool value = false;
 };
 
 template <typename T>
@@ -45,6 +69,24 @@ struct RemoveCV
     using type = typename RemoveVolatile<typename RemoveConst<T>::type>::type;
 };
 
+template <typename T>
+struct RemoveReference
+{
+    using type = T;
+};
+
+template <typename T>
+struct RemoveReference<T&>
+{
+    using type = T;
+};
+
+template <typename T>
+struct RemoveReference<T&&>
+{
+    using type = T;
+};
+
 template <typename T, typename U>
 struct IsSame : FalseType
 {
@@ -55,6 +97,31 @@ struct IsSame<T, T> : TrueType
 {
 };
 
+template <bool Condition, typename T = void>
+struct EnableIf
+{
+    using type = T;
+};
+
+template <typename T>
+struct EnableIf<false, T>
+{
+};
+
+/**
+    \brief Checks whether allocation policy provides
+        void* reallocate(void* memory, std::size_t oldBytes, std::size_t newBytes) (see MappedAllocator).
+ */
+template <typename Allocator, typename = void>
+struct HasReallocate : FalseType
+{
+};
+
+template <typename Allocator>
+struct HasReallocate<Allocator, decltype(void(&Allocator::reallocate))> : TrueType
+{
+};
+
 template <typename T>
 constexpr bool findTypeImpl()
 {
@@ -79,5 +146,53 @@ constexpr bool isTypeInTheList()
     return findTypeImpl<T, Ts...>();
 }
 
+/// \brief Checks whether T is one of the (signed or unsigned) integral types supported by calculators.
+template <typename T>
+constexpr bool isIntegral()
+{
+    return isTypeInTheList<T, short, unsigned short, int, unsigned, long, unsigned long, long long,
+                           unsigned long long>();
+}
+
+/// \brief Checks whether T is one of the floating point types.
+template <typename T>
+constexpr bool isFloatingPoint()
+{
+    return isTypeInTheList<T, float, double, long double>();
+}
+
+template <typename T>
+constexpr bool isArithmetic()
+{
+    return isIntegral<T>() or isFloatingPoint<T>();
+}
+
+/// \brief Checks whether T is one of the character types (their signedness depends on the platform).
+template <typename T>
+constexpr bool isCharacter()
+{
+    return isTypeInTheList<T, char, signed char, unsigned char, wchar_t, char16_t, char32_t>();
+}
+
+template <typename T, bool Numeric = isArithmetic<T>() or isCharacter<T>(), typename U = typename RemoveCV<T>::type>
+struct IsSigned : BoolConstant<(static_cast<U>(-1) < static_cast<U>(0))>
+{
+};
+
+template <typename T, typename U>
+struct IsSigned<T, false, U> : FalseType
+{
+};
+
+/**
+    \brief Checks whether T is a signed arithmetic or character type (e.g. wchar_t on Linux), false for
+        unsigned and non-arithmetic types. Floating point types are signed.
+ */
+template <typename T>
+constexpr bool isSigned()
+{
+    return IsSigned<T>::value;
+}
+
 } // namespace details
 } // namespace tplx
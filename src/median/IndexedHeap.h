@@ -0,0 +1,341 @@
+#pragma once
+
+#include "Comparators.h"
+#include "HeapStorage.h"
+
+namespace tplx
+{
+
+/**
+    \brief Implementation of the HEAP data structure in which every element is identified by a handle
+        provided by the caller upon insertion. Tracking position of each handle makes it possible to remove
+        or update arbitrary elements (not only the top one) in O(log n).
+
+        Handles are expected to be small non-negative integers (e.g. slot numbers of a ring buffer), as the
+        heap keeps a position table indexed directly by handle.
+ */
+template <typename T, typename Compare>
+class IndexedHeap
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using handle_type = std::size_t;
+
+    /// \brief Position of a handle which is not present in the heap.
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    /**
+        \brief Constructs IndexedHeap structure using default-constructed comparator object.
+     */
+    IndexedHeap() = default;
+    /**
+        \brief Constructs IndexedHeap structure using provided comparator object.
+        \param cmp - comparator.
+     */
+    explicit IndexedHeap(Compare cmp);
+
+    /**
+        \brief Inserts new element to the heap.
+        \throws std::bad_alloc if there is not enough memory available
+        \param handle - identifier of the new element, must not be already present in the heap
+        \param item - new element to be inserted
+     */
+    void insert(handle_type handle, T item);
+
+    /**
+        \brief Replaces content of the heap with the given elements, building it bottom-up in O(n)
+            instead of inserting them one by one in O(n log n).
+        \throws std::bad_alloc if there is not enough memory available
+        \param handles - identifiers of the elements, must be distinct
+        \param items - elements, \a items[i] is identified by \a handles[i]
+        \param count - number of elements
+     */
+    void assign(const handle_type* handles, const T* items, size_type count);
+
+    /**
+        \brief Removes top element from the heap.
+     */
+    void pop() noexcept;
+
+    /**
+        \brief Removes element identified by the handle from the heap.
+        \param handle - identifier of the element, must be present in the heap
+     */
+    void erase(handle_type handle) noexcept;
+
+    /**
+        \brief Removes element located at the given position of the underlying array.
+        \param position - position of the element, must be less than size()
+     */
+    void eraseAt(size_type position) noexcept;
+
+    /**
+        \brief Replaces value of the element identified by the handle and restores the heap property.
+        \param handle - identifier of the element, must be present in the heap
+        \param item - new value
+     */
+    void update(handle_type handle, T item) noexcept;
+
+    /**
+        \brief Returns top element of the heap.
+        \return top element.
+     */
+    T top() const noexcept;
+
+    /**
+        \brief Returns handle of the top element of the heap.
+        \return handle of the top element.
+     */
+    handle_type topHandle() const noexcept;
+
+    /**
+        \brief Checks whether element identified by the handle is present in the heap.
+     */
+    bool contains(handle_type handle) const noexcept;
+
+    /**
+        \brief Returns position of the element identified by the handle or npos if it is not present.
+     */
+    size_type position(handle_type handle) const noexcept;
+
+    /**
+        \brief Removes all elements from the heap. Allocated memory is preserved.
+     */
+    void clear() noexcept;
+
+    /**
+        \brief Preallocates memory for the given number of elements and handles.
+        \param capacity - maximum number of elements stored at the same time
+        \param handles - number of distinct handles (all handles are expected to be less than that value)
+     */
+    void reserve(size_type capacity, size_type handles);
+
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+
+private:
+    size_type parent(size_type index) const noexcept
+    {
+        return (index - 1) / 2;
+    }
+    size_type left(size_type index) const noexcept
+    {
+        return 2 * index + 1;
+    }
+    size_type right(size_type index) const noexcept
+    {
+        return 2 * index + 2;
+    }
+
+    void swap(size_type a, size_type b) noexcept;
+    void siftUp(size_type index) noexcept;
+    void heapify(size_type index) noexcept;
+
+    details::HeapStorage<T> values_;
+    details::HeapStorage<handle_type> handles_;
+    details::HeapStorage<size_type> positions_;
+    Compare cmp_;
+};
+
+template <typename T = int>
+using IndexedMaxHeap = IndexedHeap<T, Less<T>>;
+
+template <typename T = int>
+using IndexedMinHeap = IndexedHeap<T, Greater<T>>;
+
+// -------------------------------------------------------------------------- //
+
+template <typename T, typename Compare>
+constexpr typename IndexedHeap<T, Compare>::size_type IndexedHeap<T, Compare>::npos;
+
+template <typename T, typename Compare>
+IndexedHeap<T, Compare>::IndexedHeap(Compare cmp) : cmp_{cmp}
+{
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::insert(handle_type handle, T item)
+{
+    assert(not contains(handle));
+    while (positions_.size() <= handle)
+    {
+        positions_.push_back(npos);
+    }
+    values_.push_back(item);
+    handles_.push_back(handle);
+    positions_[handle] = values_.size() - 1;
+    siftUp(values_.size() - 1);
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::assign(const handle_type* handles, const T* items, size_type count)
+{
+    clear();
+    values_.append(items, items + count);
+    handles_.append(handles, handles + count);
+    for (size_type i = 0; i < count; i++)
+    {
+        assert(not contains(handles[i]));
+        while (positions_.size() <= handles[i])
+        {
+            positions_.push_back(npos);
+        }
+        positions_[handles[i]] = i;
+    }
+    for (auto i = count / 2; i > 0; i--)
+    {
+        heapify(i - 1);
+    }
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::pop() noexcept
+{
+    eraseAt(0);
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::erase(handle_type handle) noexcept
+{
+    assert(contains(handle));
+    eraseAt(positions_[handle]);
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::eraseAt(size_type position) noexcept
+{
+    assert(position < size());
+    const auto last = size() - 1;
+    positions_[handles_[position]] = npos;
+    if (position != last)
+    {
+        values_[position] = values_[last];
+        handles_[position] = handles_[last];
+        positions_[handles_[position]] = position;
+    }
+    values_.pop_back();
+    handles_.pop_back();
+    if (position < size())
+    {
+        // the element moved from the back may violate the heap property in either direction
+        siftUp(position);
+        heapify(position);
+    }
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::update(handle_type handle, T item) noexcept
+{
+    assert(contains(handle));
+    const auto position = positions_[handle];
+    values_[position] = item;
+    siftUp(position);
+    heapify(position);
+}
+
+template <typename T, typename Compare>
+T IndexedHeap<T, Compare>::top() const noexcept
+{
+    return values_.front();
+}
+
+template <typename T, typename Compare>
+typename IndexedHeap<T, Compare>::handle_type IndexedHeap<T, Compare>::topHandle() const noexcept
+{
+    return handles_.front();
+}
+
+template <typename T, typename Compare>
+bool IndexedHeap<T, Compare>::contains(handle_type handle) const noexcept
+{
+    return position(handle) != npos;
+}
+
+template <typename T, typename Compare>
+typename IndexedHeap<T, Compare>::size_type IndexedHeap<T, Compare>::position(handle_type handle) const noexcept
+{
+    return handle < positions_.size() ? positions_[handle] : npos;
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::clear() noexcept
+{
+    for (auto handle : handles_)
+    {
+        positions_[handle] = npos;
+    }
+    values_.clear();
+    handles_.clear();
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::reserve(size_type capacity, size_type handles)
+{
+    values_.reserve(capacity);
+    handles_.reserve(capacity);
+    positions_.reserve(handles);
+}
+
+template <typename T, typename Compare>
+bool IndexedHeap<T, Compare>::empty() const noexcept
+{
+    return values_.empty();
+}
+
+template <typename T, typename Compare>
+typename IndexedHeap<T, Compare>::size_type IndexedHeap<T, Compare>::size() const noexcept
+{
+    return values_.size();
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::swap(size_type a, size_type b) noexcept
+{
+    values_.swap(a, b);
+    handles_.swap(a, b);
+    positions_[handles_[a]] = a;
+    positions_[handles_[b]] = b;
+}
+
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::siftUp(size_type index) noexcept
+{
+    while (index > 0 and cmp_(values_[parent(index)], values_[index]))
+    {
+        swap(index, parent(index));
+        index = parent(index);
+    }
+}
+
+/// \brief Implements MAX-HEAPIFY/MIN-HEAPIFY procedure
+template <typename T, typename Compare>
+void IndexedHeap<T, Compare>::heapify(size_type index) noexcept
+{
+    const auto count = size();
+    while (true)
+    {
+        auto l = left(index);
+        auto r = right(index);
+        auto selected = index;
+        if (l < count and cmp_(values_[selected], values_[l]))
+        {
+            selected = l;
+        }
+        if (r < count and cmp_(values_[selected], values_[r]))
+        {
+            selected = r;
+        }
+        if (selected != index)
+        {
+            swap(selected, index);
+            index = selected;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+} // namespace tplx
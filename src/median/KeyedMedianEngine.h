@@ -0,0 +1,281 @@
+#pragma once
+
+#include "HeapStorage.h"
+#include "HeapStorageTypeTraits.h"
+#include "MedianCalculator.h"
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates running medians of many independent streams of values identified by keys
+        (e.g. latency per endpoint).
+
+        State of every stream (a MedianCalculator) is kept in a single contiguous pool indexed by slot number,
+        so an idle stream costs just the calculator object (no heap allocation until it receives values) and
+        a table entry. Keys are mapped to slots by an open addressing hash table with linear probing, whose
+        entries (key and slot number) are stored contiguously, so a lookup usually touches a single cache
+        line of the table. The table is kept at most half full and doubled when needed.
+        Memory of the values of all streams is obtained through the \a Allocator policy (see NewAllocator),
+        e.g. PoolAllocator lets streams reuse blocks freed by each other instead of calling operator new
+        for every stream. The pool of calculators and the table always use the global operator new.
+ */
+template <typename Key, typename T, typename Allocator = NewAllocator>
+class KeyedMedianEngine
+{
+    static_assert(details::isIntegral<Key>(), "KeyedMedianEngine supports integral keys only");
+
+public:
+    using calculator_type = MedianCalculator<T, Allocator>;
+
+    /**
+        \brief Constructs engine prepared for the given number of keys.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    explicit KeyedMedianEngine(std::size_t expectedKeys = 0);
+
+    /**
+        \brief Constructs engine prepared for the given number of keys, whose streams use the given
+            allocation policy.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    KeyedMedianEngine(std::size_t expectedKeys, Allocator allocator);
+
+    KeyedMedianEngine(const KeyedMedianEngine&) = delete;
+    KeyedMedianEngine& operator=(const KeyedMedianEngine&) = delete;
+
+    /**
+        \brief Adds a new value to the stream identified by the key, the stream is created if necessary.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void add(Key key, T value);
+
+    /**
+        \brief Adds all values from the [first, last) range to the stream identified by the key.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void addRange(Key key, const T* first, const T* last);
+
+    /**
+        \brief Calculates median of the stream identified by the key.
+            NOTE: Median of unknown stream is NAN.
+     */
+    double calculate(Key key) const noexcept;
+
+    /**
+        \brief Resets the stream identified by the key, so its median will be calculated from scratch.
+            The stream keeps its slot and memory.
+     */
+    void reset(Key key) noexcept;
+
+    /// \brief Removes all streams.
+    void clear() noexcept;
+
+    /**
+        \brief Prepares the engine for the given number of keys.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    void reserve(std::size_t keys);
+
+    /// \brief Returns number of known streams.
+    std::size_t size() const noexcept;
+
+    /**
+        \brief Returns calculator of the stream identified by the key or nullptr if the stream is unknown.
+            NOTE: The pointer is invalidated by reserve() and by adding values to a new stream, because
+            calculators may be moved to a bigger pool.
+     */
+    const calculator_type* find(Key key) const noexcept;
+
+private:
+    using slot_type = std::uint32_t;
+
+    static constexpr slot_type empty_slot = ~slot_type{0};
+
+    struct Entry
+    {
+        Key key;
+        slot_type slot;
+    };
+
+    static std::size_t hash(Key key) noexcept;
+    std::size_t probe(Key key) const noexcept;
+    calculator_type& findOrCreate(Key key);
+    void rehash(std::size_t capacity);
+
+    std::unique_ptr<Entry[]> table_;
+    std::size_t tableMask_;
+    // calculators of removed streams are kept (reset) for reuse, so the pool may be bigger than size_
+    details::HeapStorage<calculator_type> pool_;
+    Allocator allocator_;
+    std::size_t size_;
+};
+
+// -------------------------------------------------------------------------- //
+
+template <typename Key, typename T, typename Allocator>
+constexpr typename KeyedMedianEngine<Key, T, Allocator>::slot_type KeyedMedianEngine<Key, T, Allocator>::empty_slot;
+
+template <typename Key, typename T, typename Allocator>
+KeyedMedianEngine<Key, T, Allocator>::KeyedMedianEngine(std::size_t expectedKeys)
+    : KeyedMedianEngine{expectedKeys, Allocator{}}
+{
+}
+
+template <typename Key, typename T, typename Allocator>
+KeyedMedianEngine<Key, T, Allocator>::KeyedMedianEngine(std::size_t expectedKeys, Allocator allocator)
+    : tableMask_{0}, allocator_{allocator}, size_{0}
+{
+    rehash(16);
+    reserve(expectedKeys);
+}
+
+template <typename Key, typename T, typename Allocator>
+void KeyedMedianEngine<Key, T, Allocator>::add(Key key, T value)
+{
+    findOrCreate(key).add(value);
+}
+
+template <typename Key, typename T, typename Allocator>
+void KeyedMedianEngine<Key, T, Allocator>::addRange(Key key, const T* first, const T* last)
+{
+    findOrCreate(key).addRange(first, last);
+}
+
+template <typename Key, typename T, typename Allocator>
+double KeyedMedianEngine<Key, T, Allocator>::calculate(Key key) const noexcept
+{
+    const auto calculator = find(key);
+    return calculator ? calculator->calculate() : NAN;
+}
+
+template <typename Key, typename T, typename Allocator>
+void KeyedMedianEngine<Key, T, Allocator>::reset(Key key) noexcept
+{
+    const auto& entry = table_[probe(key)];
+    if (entry.slot != empty_slot)
+    {
+        pool_[entry.slot].reset();
+    }
+}
+
+template <typename Key, typename T, typename Allocator>
+void KeyedMedianEngine<Key, T, Allocator>::clear() noexcept
+{
+    for (std::size_t i = 0; i <= tableMask_; i++)
+    {
+        table_[i].slot = empty_slot;
+    }
+    for (std::size_t i = 0; i < size_; i++)
+    {
+        pool_[i].reset();
+    }
+    size_ = 0;
+}
+
+template <typename Key, typename T, typename Allocator>
+void KeyedMedianEngine<Key, T, Allocator>::reserve(std::size_t keys)
+{
+    auto capacity = tableMask_ + 1;
+    while (capacity < 2 * keys)
+    {
+        capacity *= 2;
+    }
+    if (capacity > tableMask_ + 1)
+    {
+        rehash(capacity);
+    }
+    pool_.reserve(keys);
+}
+
+template <typename Key, typename T, typename Allocator>
+std::size_t KeyedMedianEngine<Key, T, Allocator>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename Key, typename T, typename Allocator>
+auto KeyedMedianEngine<Key, T, Allocator>::find(Key key) const noexcept -> const calculator_type*
+{
+    const auto& entry = table_[probe(key)];
+    return entry.slot == empty_slot ? nullptr : pool_.data() + entry.slot;
+}
+
+template <typename Key, typename T, typename Allocator>
+std::size_t KeyedMedianEngine<Key, T, Allocator>::hash(Key key) noexcept
+{
+    // finalizer of MurmurHash3, spreads consecutive keys over the whole table
+    auto h = static_cast<std::uint64_t>(key);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+}
+
+/// \brief Returns index of the entry holding the key or of the empty entry the key would be inserted to.
+template <typename Key, typename T, typename Allocator>
+std::size_t KeyedMedianEngine<Key, T, Allocator>::probe(Key key) const noexcept
+{
+    auto index = hash(key) & tableMask_;
+    while (table_[index].slot != empty_slot and table_[index].key != key)
+    {
+        index = (index + 1) & tableMask_;
+    }
+    return index;
+}
+
+template <typename Key, typename T, typename Allocator>
+auto KeyedMedianEngine<Key, T, Allocator>::findOrCreate(Key key) -> calculator_type&
+{
+    auto index = probe(key);
+    if (table_[index].slot != empty_slot)
+    {
+        return pool_[table_[index].slot];
+    }
+    assert(size_ < empty_slot);
+    if (2 * (size_ + 1) > tableMask_ + 1)
+    {
+        rehash(2 * (tableMask_ + 1));
+        index = probe(key);
+    }
+    if (size_ == pool_.size())
+    {
+        if (pool_.size() == pool_.capacity())
+        {
+            pool_.reserve(pool_.capacity() == 0 ? 16 : 2 * pool_.capacity());
+        }
+        pool_.push_back(calculator_type{allocator_});
+    }
+    table_[index].key = key;
+    table_[index].slot = static_cast<slot_type>(size_);
+    return pool_[size_++];
+}
+
+template <typename Key, typename T, typename Allocator>
+void KeyedMedianEngine<Key, T, Allocator>::rehash(std::size_t capacity)
+{
+    assert((capacity & (capacity - 1)) == 0);
+    std::unique_ptr<Entry[]> oldTable{new Entry[capacity]};
+    for (std::size_t i = 0; i < capacity; i++)
+    {
+        oldTable[i].slot = empty_slot;
+    }
+    const auto oldCapacity = table_ ? tableMask_ + 1 : 0;
+    oldTable.swap(table_);
+    tableMask_ = capacity - 1;
+    for (std::size_t i = 0; i < oldCapacity; i++)
+    {
+        if (oldTable[i].slot != empty_slot)
+        {
+            table_[probe(oldTable[i].key)] = oldTable[i];
+        }
+    }
+}
+
+} // namespace tplx
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "HeapStorageTypeTraits.h"
+#include "MedianTraits.h"
+#include <cstddef>
+#include <utility>
+
+namespace tplx
+{
+
+namespace details
+{
+
+/// \brief Checks whether arguments \a Args consist of a single (possibly const) \a Self object, i.e. make a copy.
+template <typename Self, typename... Args>
+struct IsCopyOf : FalseType
+{
+};
+
+template <typename Self, typename Arg>
+struct IsCopyOf<Self, Arg> : IsSame<Self, typename RemoveCV<typename RemoveReference<Arg>::type>::type>
+{
+};
+
+} // namespace details
+
+/**
+    \brief Wraps a median calculator (MedianCalculator, CountingMedianCalculator, WindowMedianCalculator, ...)
+        evaluating the median lazily: adding values only invalidates the cached result, which is recalculated
+        by the nearest changed() or take() call, so the median of a run of values is evaluated once.
+        changed() tells whether the median differs from the one returned by the last take() call
+        (the median of the empty set before the first one), so consumers of slowly moving medians
+        (see BasicMedianCalculatingEventListener) may skip the unchanged ones, e.g. skip formatting them.
+ */
+template <typename Calculator>
+class LazyMedianCalculator
+{
+public:
+    using result_type = decltype(std::declval<const Calculator&>().calculate());
+
+    /// \brief Constructs the wrapped calculator from the given arguments (copies are made by the copy constructor).
+    template <typename... Args,
+              typename = typename details::EnableIf<not details::IsCopyOf<LazyMedianCalculator, Args...>::value>::type>
+    explicit LazyMedianCalculator(Args&&... args)
+        : calculator_{std::forward<Args>(args)...},
+          median_{calculator_.calculate()},
+          reported_{median_},
+          valid_{true}
+    {
+    }
+
+    /// \brief Adds a new value to the wrapped calculator (see its add() for exceptions thrown).
+    template <typename T>
+    void add(const T& value)
+    {
+        valid_ = false;
+        calculator_.add(value);
+    }
+
+    /// \brief Adds all values from the [first, last) range to the wrapped calculator.
+    template <typename T>
+    void addRange(const T* first, const T* last)
+    {
+        valid_ = false;
+        calculator_.addRange(first, last);
+    }
+
+    /**
+        \brief Returns median of the values of the wrapped calculator (the cached one unless values have been
+            added since it was evaluated). Has no side effects, in particular does not acknowledge the change.
+     */
+    result_type calculate() const noexcept
+    {
+        return valid_ ? median_ : calculator_.calculate();
+    }
+
+    /**
+        \brief Checks whether the median differs from the one returned by the last take() call
+            (NaN results are equal to each other). The evaluated median is cached.
+     */
+    bool changed() noexcept
+    {
+        refresh();
+        return not(median_ == reported_ or (details::isNan(median_) and details::isNan(reported_)));
+    }
+
+    /// \brief Returns the median like calculate() and makes it the reference value of changed().
+    result_type take() noexcept
+    {
+        refresh();
+        reported_ = median_;
+        return median_;
+    }
+
+    /// \brief Resets the wrapped calculator, the last taken median remains the reference value of changed().
+    void reset() noexcept
+    {
+        valid_ = false;
+        calculator_.reset();
+    }
+
+    const Calculator& calculator() const noexcept
+    {
+        return calculator_;
+    }
+
+private:
+    void refresh() noexcept
+    {
+        if (not valid_)
+        {
+            median_ = calculator_.calculate();
+            valid_ = true;
+        }
+    }
+
+    Calculator calculator_;
+    result_type median_;
+    result_type reported_;
+    bool valid_;
+};
+
+namespace details
+{
+
+/// \brief Calculators which do not track changes of the median report every query as a change.
+template <typename Calculator>
+constexpr bool medianChanged(const Calculator&) noexcept
+{
+    return true;
+}
+
+template <typename Calculator>
+bool medianChanged(LazyMedianCalculator<Calculator>& calculator) noexcept
+{
+    return calculator.changed();
+}
+
+/// \brief Returns the median to be reported, acknowledging it if the calculator tracks changes.
+template <typename Calculator>
+auto takeMedian(const Calculator& calculator) noexcept -> decltype(calculator.calculate())
+{
+    return calculator.calculate();
+}
+
+template <typename Calculator>
+auto takeMedian(LazyMedianCalculator<Calculator>& calculator) noexcept ->
+    typename LazyMedianCalculator<Calculator>::result_type
+{
+    return calculator.take();
+}
+
+} // namespace details
+
+} // namespace tplx
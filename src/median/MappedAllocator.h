@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace tplx
+{
+
+/**
+    \brief Allocation policy of HeapStorage for very big heaps (Linux only).
+
+        Blocks of at least \a min_mapped_size bytes are anonymous memory mappings, which grow and shrink
+        by mremap(), so the kernel moves page table entries instead of copying the contents and the old and
+        new buffers never coexist in physical memory. Mapped blocks may additionally be backed by transparent
+        huge pages, which reduces TLB misses of random accesses done by heap traversal.
+        Smaller blocks come from the global operator new, as mappings are rounded up to whole pages.
+
+        Besides allocate() and deallocate() the policy provides
+        void* reallocate(void* memory, std::size_t oldBytes, std::size_t newBytes)
+        preserving min(oldBytes, newBytes) bytes of the block, which HeapStorage uses instead of allocating
+        a new buffer and copying the elements whenever the policy offers it.
+ */
+class MappedAllocator
+{
+public:
+    /// \brief Size of the smallest block being mapped (size of the x86-64 huge page).
+    static constexpr std::size_t min_mapped_size = 2 * 1024 * 1024;
+
+    /// \param hugePages - whether mapped blocks should be backed by transparent huge pages
+    explicit MappedAllocator(bool hugePages = true) noexcept : hugePages_{hugePages}
+    {
+    }
+
+    /// \throws std::bad_alloc if there is not enough memory available
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes < min_mapped_size)
+        {
+            return ::operator new(bytes);
+        }
+        const auto memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            throw std::bad_alloc{};
+        }
+        adviseHugePages(memory, bytes);
+        return memory;
+    }
+
+    void deallocate(void* memory, std::size_t bytes) noexcept
+    {
+        if (bytes < min_mapped_size)
+        {
+            ::operator delete(memory);
+            return;
+        }
+        ::munmap(memory, bytes);
+    }
+
+    /**
+        \brief Resizes the block, the contents are preserved up to the lesser of the sizes.
+            Mapped blocks are remapped without copying, the block may be moved.
+        \throws std::bad_alloc if there is not enough memory available, the original block is left intact
+     */
+    void* reallocate(void* memory, std::size_t oldBytes, std::size_t newBytes)
+    {
+        if (oldBytes >= min_mapped_size and newBytes >= min_mapped_size)
+        {
+            const auto remapped = ::mremap(memory, oldBytes, newBytes, MREMAP_MAYMOVE);
+            if (remapped == MAP_FAILED)
+            {
+                throw std::bad_alloc{};
+            }
+            if (newBytes > oldBytes)
+            {
+                adviseHugePages(remapped, newBytes);
+            }
+            return remapped;
+        }
+        const auto resized = allocate(newBytes);
+        std::memcpy(resized, memory, oldBytes < newBytes ? oldBytes : newBytes);
+        deallocate(memory, oldBytes);
+        return resized;
+    }
+
+    bool hugePages() const noexcept
+    {
+        return hugePages_;
+    }
+
+private:
+    void adviseHugePages(void* memory, std::size_t bytes) const noexcept
+    {
+#ifdef MADV_HUGEPAGE
+        if (hugePages_)
+        {
+            // only a hint, the kernel may not support or may have disabled transparent huge pages
+            ::madvise(memory, bytes, MADV_HUGEPAGE);
+        }
+#else
+        static_cast<void>(memory);
+        static_cast<void>(bytes);
+#endif
+    }
+
+    bool hugePages_;
+};
+
+/**
+    \brief Allocation policy of HeapStorage making growth of the buffer constant work (Linux only).
+
+        Each block reserves \a reservedBytes of address space up front (no memory is committed) and only
+        its first bytes are accessible. Growing the block within the reservation just extends the accessible
+        part in place, pages are provided by the kernel when touched for the first time, so no element is
+        ever copied and the insert causing the growth costs no more than other ones. Shrinking the block
+        returns the pages beyond the new size to the system. Blocks growing beyond the reservation are
+        moved by mremap() (see MappedAllocator).
+
+        Reservations use virtual address space only, but every block takes at least \a reservedBytes of it,
+        so the policy is meant for a limited number of big heaps on 64-bit systems: with the default
+        reservation of 16 GiB and two heaps per MedianCalculator, the 128 TiB user address space of x86-64
+        limits a process to about 4000 calculators (pass smaller \a reservedBytes for more of them).
+ */
+class ReservedAllocator
+{
+public:
+    /// \brief Default size of the address space reserved for each block.
+    static constexpr std::size_t default_reserved_size = std::size_t{16} * 1024 * 1024 * 1024;
+
+    explicit ReservedAllocator(std::size_t reservedBytes = default_reserved_size) noexcept
+        : reservedBytes_{reservedBytes}
+    {
+    }
+
+    /// \throws std::bad_alloc if there is not enough address space or memory available
+    void* allocate(std::size_t bytes)
+    {
+        const auto mapped = mappedSize(bytes);
+        const auto memory = ::mmap(nullptr, mapped, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            throw std::bad_alloc{};
+        }
+        if (::mprotect(memory, bytes, PROT_READ | PROT_WRITE) != 0)
+        {
+            ::munmap(memory, mapped);
+            throw std::bad_alloc{};
+        }
+        return memory;
+    }
+
+    void deallocate(void* memory, std::size_t bytes) noexcept
+    {
+        ::munmap(memory, mappedSize(bytes));
+    }
+
+    /**
+        \brief Resizes the block in place if it fits the reservation, the contents are preserved up to
+            the lesser of the sizes.
+        \throws std::bad_alloc if there is not enough memory available, the original block is left intact
+     */
+    void* reallocate(void* memory, std::size_t oldBytes, std::size_t newBytes)
+    {
+        const auto oldMapped = mappedSize(oldBytes);
+        const auto newMapped = mappedSize(newBytes);
+        if (oldMapped == newMapped)
+        {
+            if (newBytes > oldBytes and ::mprotect(memory, newBytes, PROT_READ | PROT_WRITE) != 0)
+            {
+                throw std::bad_alloc{};
+            }
+            if (newBytes < oldBytes)
+            {
+                const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                const auto unused = (newBytes + pageSize - 1) / pageSize * pageSize;
+                if (unused < oldBytes)
+                {
+                    ::madvise(static_cast<char*>(memory) + unused, oldBytes - unused, MADV_DONTNEED);
+                }
+            }
+            return memory;
+        }
+        // mremap() requires a single mapping, so the reserved part is made accessible (still not committed)
+        if (::mprotect(memory, oldMapped, PROT_READ | PROT_WRITE) != 0)
+        {
+            throw std::bad_alloc{};
+        }
+        const auto remapped = ::mremap(memory, oldMapped, newMapped, MREMAP_MAYMOVE);
+        if (remapped == MAP_FAILED)
+        {
+            throw std::bad_alloc{};
+        }
+        return remapped;
+    }
+
+    std::size_t reservedBytes() const noexcept
+    {
+        return reservedBytes_;
+    }
+
+private:
+    std::size_t mappedSize(std::size_t bytes) const noexcept
+    {
+        return bytes > reservedBytes_ ? bytes : reservedBytes_;
+    }
+
+    std::size_t reservedBytes_;
+};
+
+} // namespace tplx
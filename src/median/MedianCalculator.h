@@ -1,29 +1,113 @@
 #pragma once
 
 #include "Heap.h"
+#include "MedianTraits.h"
+#include "Snapshot.h"
 #include <cmath>
 #include <cassert>
+#include <stdexcept>
 
 namespace tplx
 {
 
-template <typename T>
-class MedianCalculator
+namespace details
+{
+
+/**
+    \brief Flag of a NaN value added to MedianCalculator, stored only if NaN values propagate (\a Stored),
+        otherwise empty, so the calculator deriving from it takes no space for the flag.
+ */
+template <bool Stored>
+class NanFlag
 {
 public:
+    bool nanAdded() const noexcept
+    {
+        return nanAdded_;
+    }
+    void setNanAdded(bool nanAdded) noexcept
+    {
+        nanAdded_ = nanAdded;
+    }
+
+private:
+    bool nanAdded_ = false;
+};
+
+template <>
+class NanFlag<false>
+{
+public:
+    constexpr bool nanAdded() const noexcept
+    {
+        return false;
+    }
+    void setNanAdded(bool) noexcept
+    {
+    }
+};
+
+} // namespace details
+
+/**
+    \brief Calculates running median of all so far added values keeping them in two heaps (lower and upper half).
+        Memory of the heaps is obtained through the \a Allocator policy (see NewAllocator), so calculators
+        of many streams may share a single memory resource (e.g. MonotonicArena or SizeClassPool).
+        Values may be of any type ordered by operator< and described by MedianTraits, e.g. integral
+        and floating point numbers. NaN values are handled according to the \a Nan policy.
+        Reallocations of the heaps, depths of heap operations and moves of values between the halves are
+        reported to the \a Stats policy (nothing is collected by default, see NoStats and CollectStats).
+ */
+template <typename T, typename Allocator = NewAllocator, NanPolicy Nan = NanPolicy::skip, typename Stats = NoStats>
+class MedianCalculator : private details::NanFlag<Nan == NanPolicy::propagate>
+{
+public:
+    using result_type = typename MedianTraits<T>::result_type;
+
+    MedianCalculator() = default;
+
+    /**
+        \brief Constructs calculator using the given allocation policy.
+        \param allocator - allocation policy of the heaps (see NewAllocator).
+     */
+    explicit MedianCalculator(Allocator allocator);
+
     /**
         \brief Adds a new value to the set.
+        \throws std::invalid_argument if the value is NaN and NaN values are rejected
         \param value - value to add.
      */
     void add(T value);
 
+    /**
+        \brief Adds all values from the [first, last) range to the set.
+            The range is partitioned around the current median and each part is appended to the corresponding
+            half at once, then halves are balanced by moving a group of top-most elements selected in linear
+            time. That makes loading big batches O(n) instead of O(n log n) of adding values one by one.
+        \throws std::bad_alloc if there is not enough memory available
+        \throws std::invalid_argument if the range contains NaN and NaN values are rejected (no value is added)
+        \param first - pointer to the first value
+        \param last - pointer past the last value
+     */
+    void addRange(const T* first, const T* last);
+
+    /**
+        \brief Adds all values collected by the other calculator (e.g. partial result of a parallel job).
+            Values of the other calculator are partitioned around the current median and appended to
+            the halves at once like by addRange(), so merging is O(n + m) instead of O(m log(n + m)) of adding
+            them one by one. A NaN value added to the other calculator is propagated according to the policy.
+        \throws std::bad_alloc if there is not enough memory available
+        \param other - calculator whose values are added (may be this calculator)
+     */
+    void merge(const MedianCalculator& other);
+
     /**
         \brief Calculates median from all so far collected values.
-            NOTE: Median of empty set is NAN.
+            NOTE: Median of empty set is NAN (MedianTraits<T>::empty()).
 
         \return median value
      */
-    double calculate() const noexcept;
+    result_type calculate() const noexcept;
 
     /**
         \brief Reset internal state, so median will be calculated from scratch starting with the
@@ -31,36 +115,104 @@ public:
      */
     void reset() noexcept;
 
+    /**
+        \brief Resets internal state like reset() and returns memory of the heaps to the allocator
+            (O(1) with the bundled MonotonicArena and SizeClassPool).
+     */
+    void release() noexcept;
+
     void reserve(std::size_t capacity);
 
+    /**
+        \brief Returns statistics collected since the calculator has been created (empty unless
+            the \a Stats policy collects them). Statistics are kept by reset() and release().
+     */
+    StatsSnapshot stats() const noexcept;
+
+    /// \brief Returns size in bytes of the snapshot of the current state (see SnapshotHeader).
+    std::size_t snapshotSize() const noexcept;
+
+    /**
+        \brief Writes snapshot of the current state (see SnapshotHeader) to the buffer.
+        \param out - buffer of at least snapshotSize() bytes aligned for T values
+     */
+    void saveSnapshot(void* out) const noexcept;
+
+    /**
+        \brief Replaces the current state with the one stored in the snapshot written by saveSnapshot().
+            Values are copied to the heaps at once and checked in a single pass (both halves have to be heaps,
+            the top of the lower half must not be greater than the top of the upper half), so restoring takes
+            time of copying the memory and reading it once. Statistics are not part of the snapshot, the flag
+            of an added NaN value is restored only if NaN values propagate. The calculator is reset if
+            restoring fails.
+        \throws std::invalid_argument if the snapshot is malformed or holds values of other type
+        \throws std::bad_alloc if there is not enough memory available
+        \param data - snapshot aligned for T values (e.g. memory mapped file)
+        \param size - size of the snapshot in bytes
+     */
+    void restoreSnapshot(const void* data, std::size_t size);
+
 private:
-    MaxHeap<T> lowerHalf_;
-    MinHeap<T> upperHalf_;
+    /// \brief Distributes values of the batch (NaN values already dropped) among the halves and balances them.
+    void insertBatch(details::HeapStorage<T>& batch);
+
+    template <typename From, typename To>
+    void moveTopElements(std::size_t count, From& from, To& to);
+
+    /// \brief Applies the NaN policy, returns false if the value must not be added.
+    bool admit(const T& value);
+
+    // values moved between the halves are counted by statistics of the lower half, as an empty Stats member
+    // of the calculator would take space of its own
+    MaxHeap<T, 2, Allocator, Stats> lowerHalf_;
+    MinHeap<T, 2, Allocator, Stats> upperHalf_;
 };
 
-template <typename T>
-double MedianCalculator<T>::calculate() const noexcept
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+MedianCalculator<T, Allocator, Nan, Stats>::MedianCalculator(Allocator allocator)
+    : lowerHalf_{Less<T>{}, allocator}, upperHalf_{Greater<T>{}, allocator}
 {
-    if (lowerHalf_.empty() and upperHalf_.empty())
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+auto MedianCalculator<T, Allocator, Nan, Stats>::calculate() const noexcept -> result_type
+{
+    using Traits = MedianTraits<T>;
+    if ((lowerHalf_.empty() and upperHalf_.empty()) or this->nanAdded())
     {
-        return NAN;
+        return Traits::empty();
     }
     if (lowerHalf_.size() == upperHalf_.size())
     {
-        return (static_cast<double>(lowerHalf_.top()) + upperHalf_.top()) / 2;
+        return Traits::mean(lowerHalf_.top(), upperHalf_.top());
     }
     if (lowerHalf_.size() > upperHalf_.size())
     {
-        return lowerHalf_.top();
+        return Traits::middle(lowerHalf_.top());
+    }
+    return Traits::middle(upperHalf_.top());
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+bool MedianCalculator<T, Allocator, Nan, Stats>::admit(const T& value)
+{
+    if (not details::isNan(value))
+    {
+        return true;
+    }
+    if (Nan == NanPolicy::reject)
+    {
+        throw std::invalid_argument("NaN value");
     }
-    return upperHalf_.top();
+    this->setNanAdded(true);
+    return false;
 }
 
 namespace details
 {
 
-template <typename T>
-void addValue(T value, MaxHeap<T>& lowerHalf, MinHeap<T>& upperHalf)
+template <typename T, typename LowerHalf, typename UpperHalf>
+void addValue(T value, LowerHalf& lowerHalf, UpperHalf& upperHalf)
 {
     if (lowerHalf.empty() or (value < lowerHalf.top()))
     {
@@ -72,52 +224,226 @@ void addValue(T value, MaxHeap<T>& lowerHalf, MinHeap<T>& upperHalf)
     }
 }
 
-template <typename T>
-void balance(MaxHeap<T>& lowerHalf, MinHeap<T>& upperHalf)
+} // namespace details
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::add(T value)
 {
-    if (lowerHalf.size() > upperHalf.size())
+    // If the value goes to the bigger half, the top of that half moves to the other one. pushPop() does it
+    // with a single traversal of the bigger half instead of inserting the value and then popping the top.
+    if (not admit(value))
     {
-        const auto diff = lowerHalf.size() - upperHalf.size();
-        assert(diff <= 2);
-        if (diff == 2)
+        return;
+    }
+    if (lowerHalf_.size() > upperHalf_.size())
+    {
+        // the top moves to the other half unless pushPop() returns the value itself
+        lowerHalf_.stats().rebalanced(value < lowerHalf_.top() ? 1 : 0);
+        upperHalf_.insert(lowerHalf_.pushPop(value));
+    }
+    else if (upperHalf_.size() > lowerHalf_.size())
+    {
+        lowerHalf_.stats().rebalanced(upperHalf_.top() < value ? 1 : 0);
+        lowerHalf_.insert(upperHalf_.pushPop(value));
+    }
+    else
+    {
+        details::addValue(value, lowerHalf_, upperHalf_);
+    }
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::addRange(const T* first, const T* last)
+{
+    if (details::isFloatingPoint<T>() and Nan == NanPolicy::reject)
+    {
+        for (auto value = first; value != last; ++value)
+        {
+            if (details::isNan(*value))
+            {
+                throw std::invalid_argument("NaN value");
+            }
+        }
+    }
+
+    // short ranges are not worth the extra copy
+    constexpr std::ptrdiff_t bulkThreshold = 32;
+    if (last - first < bulkThreshold)
+    {
+        while (first != last)
         {
-            upperHalf.insert(lowerHalf.top());
-            lowerHalf.pop();
+            add(*first++);
         }
+        return;
     }
-    else if (upperHalf.size() > lowerHalf.size())
+
+    details::HeapStorage<T> batch;
+    batch.append(first, last);
+    if (details::isFloatingPoint<T>())
     {
-        const auto diff = upperHalf.size() - lowerHalf.size();
-        assert(diff <= 2);
-        if (diff == 2)
+        // NaN values are dropped (their effect is recorded by admit())
+        auto kept = batch.begin();
+        for (auto& value : batch)
         {
-            lowerHalf.insert(upperHalf.top());
-            upperHalf.pop();
+            if (admit(value))
+            {
+                *kept++ = value;
+            }
         }
+        batch.pop_back(static_cast<std::size_t>(batch.end() - kept));
     }
+    insertBatch(batch);
 }
 
-} // namespace details
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::merge(const MedianCalculator& other)
+{
+    this->setNanAdded(this->nanAdded() or other.nanAdded());
+    if (other.lowerHalf_.empty() and other.upperHalf_.empty())
+    {
+        return;
+    }
+    if (lowerHalf_.empty() and upperHalf_.empty())
+    {
+        // halves of the other calculator are already balanced heaps
+        lowerHalf_.assign(other.lowerHalf_.begin(), other.lowerHalf_.end());
+        upperHalf_.assign(other.upperHalf_.begin(), other.upperHalf_.end());
+        return;
+    }
+    details::HeapStorage<T> batch;
+    batch.reserve(other.lowerHalf_.size() + other.upperHalf_.size());
+    batch.append(other.lowerHalf_.begin(), other.lowerHalf_.end());
+    batch.append(other.upperHalf_.begin(), other.upperHalf_.end());
+    insertBatch(batch);
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::insertBatch(details::HeapStorage<T>& batch)
+{
+    if (batch.empty())
+    {
+        return;
+    }
+    if (lowerHalf_.empty() and upperHalf_.empty())
+    {
+        // initial batch is split in halves by selecting its lower middle element, which ends the lower half,
+        // so the lower half is not empty even if the batch holds a single value
+        const auto middle = batch.begin() + (batch.size() + 1) / 2;
+        details::selectNth(batch.begin(), middle - 1, batch.end());
+        lowerHalf_.insert(batch.begin(), middle);
+        upperHalf_.insert(middle, batch.end());
+        return;
+    }
 
-template <typename T>
-void MedianCalculator<T>::add(T value)
+    // the lower half is never empty if the set is not empty (see add())
+    const auto split = details::partitionByPivot(batch.begin(), batch.end(), lowerHalf_.top());
+    lowerHalf_.insert(batch.begin(), split);
+    upperHalf_.insert(split, batch.end());
+
+    if (lowerHalf_.size() > upperHalf_.size() + 1)
+    {
+        moveTopElements((lowerHalf_.size() - upperHalf_.size()) / 2, lowerHalf_, upperHalf_);
+    }
+    else if (upperHalf_.size() > lowerHalf_.size() + 1)
+    {
+        moveTopElements((upperHalf_.size() - lowerHalf_.size()) / 2, upperHalf_, lowerHalf_);
+    }
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+template <typename From, typename To>
+void MedianCalculator<T, Allocator, Nan, Stats>::moveTopElements(std::size_t count, From& from, To& to)
 {
-    addValue(value, lowerHalf_, upperHalf_);
-    balance(lowerHalf_, upperHalf_);
+    details::HeapStorage<T> moved;
+    moved.resize(count);
+    from.pop(count, moved.data());
+    lowerHalf_.stats().rebalanced(count);
+    to.insert(moved.data(), moved.data() + count);
 }
 
-template <typename T>
-void MedianCalculator<T>::reset() noexcept
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::reset() noexcept
 {
     lowerHalf_.clear();
     upperHalf_.clear();
+    this->setNanAdded(false);
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::release() noexcept
+{
+    lowerHalf_.release();
+    upperHalf_.release();
+    this->setNanAdded(false);
 }
 
-template<typename T>
-void MedianCalculator<T>::reserve(std::size_t capacity)
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::reserve(std::size_t capacity)
 {
     lowerHalf_.reserve(capacity/2);
     upperHalf_.reserve(capacity/2);
 }
 
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+StatsSnapshot MedianCalculator<T, Allocator, Nan, Stats>::stats() const noexcept
+{
+    auto stats = lowerHalf_.stats().snapshot();
+    stats += upperHalf_.stats().snapshot();
+    return stats;
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+std::size_t MedianCalculator<T, Allocator, Nan, Stats>::snapshotSize() const noexcept
+{
+    return sizeof(SnapshotHeader) + (lowerHalf_.size() + upperHalf_.size()) * sizeof(T);
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::saveSnapshot(void* out) const noexcept
+{
+    static_assert(details::IsTriviallyCopyable<T>::value, "Snapshots require trivially copyable values");
+    const auto header = details::makeSnapshotHeader<T>(lowerHalf_.size(), upperHalf_.size(),
+                                                       this->nanAdded() ? SnapshotHeader::nan_added : 0);
+    auto bytes = static_cast<unsigned char*>(out);
+    std::memcpy(bytes, &header, sizeof(header));
+    bytes += sizeof(header);
+    if (not lowerHalf_.empty())
+    {
+        std::memcpy(bytes, lowerHalf_.begin(), lowerHalf_.size() * sizeof(T));
+        bytes += lowerHalf_.size() * sizeof(T);
+    }
+    if (not upperHalf_.empty())
+    {
+        std::memcpy(bytes, upperHalf_.begin(), upperHalf_.size() * sizeof(T));
+    }
+}
+
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void MedianCalculator<T, Allocator, Nan, Stats>::restoreSnapshot(const void* data, std::size_t size)
+{
+    static_assert(details::IsTriviallyCopyable<T>::value, "Snapshots require trivially copyable values");
+    reset();
+    const auto header = details::readSnapshotHeader<T>(data, size);
+    const auto values = reinterpret_cast<const T*>(static_cast<const unsigned char*>(data) + sizeof(header));
+    const auto lowerSize = static_cast<std::size_t>(header.lowerSize);
+    const auto upperSize = static_cast<std::size_t>(header.upperSize);
+    try
+    {
+        // corrupted values would silently give wrong medians: both halves have to be heaps and no value
+        // of the lower half may be greater than any value of the upper one
+        if (not lowerHalf_.tryAssign(values, values + lowerSize) or
+            not upperHalf_.tryAssign(values + lowerSize, values + lowerSize + upperSize) or
+            (not lowerHalf_.empty() and not upperHalf_.empty() and upperHalf_.top() < lowerHalf_.top()))
+        {
+            throw std::invalid_argument("inconsistent snapshot");
+        }
+    }
+    catch (...)
+    {
+        reset();
+        throw;
+    }
+    this->setNanAdded((header.flags & SnapshotHeader::nan_added) != 0);
+}
+
 } // namespace tplx
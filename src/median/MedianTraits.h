@@ -0,0 +1,76 @@
+#pragma once
+
+#include "HeapStorageTypeTraits.h"
+#include <cmath>
+
+namespace tplx
+{
+
+/**
+    \brief Describes how the median of values of type T is expressed (see MedianCalculator).
+        Provided for integral and floating point types: the median is double, the mean of both middle values
+        if the number of values is even and NAN for the empty set.
+
+        Other types (e.g. fixed-point numbers) need a specialization providing:
+        - result_type - type of the median,
+        - static result_type empty() - median of the empty set,
+        - static result_type middle(const T& value) - median of an odd number of values,
+        - static result_type mean(const T& lower, const T& upper) - median of an even number of values.
+        Values themselves need to be ordered by operator<.
+ */
+template <typename T, bool Arithmetic = details::isArithmetic<T>()>
+struct MedianTraits;
+
+template <typename T>
+struct MedianTraits<T, true>
+{
+    using result_type = double;
+
+    static result_type empty() noexcept
+    {
+        return NAN;
+    }
+    static result_type middle(T value) noexcept
+    {
+        return static_cast<double>(value);
+    }
+    static result_type mean(T lower, T upper) noexcept
+    {
+        return (static_cast<double>(lower) + static_cast<double>(upper)) / 2;
+    }
+};
+
+/// \brief Handling of NaN values added to calculators of floating point values.
+enum class NanPolicy
+{
+    skip,      // NaN values are ignored (default)
+    propagate, // the median is NaN since a NaN value is added until the calculator is reset
+    reject     // adding a NaN value throws std::invalid_argument
+};
+
+namespace details
+{
+
+template <typename T>
+constexpr bool isNan(const T&) noexcept
+{
+    return false;
+}
+
+inline bool isNan(float value) noexcept
+{
+    return std::isnan(value);
+}
+
+inline bool isNan(double value) noexcept
+{
+    return std::isnan(value);
+}
+
+inline bool isNan(long double value) noexcept
+{
+    return std::isnan(value);
+}
+
+} // namespace details
+} // namespace tplx
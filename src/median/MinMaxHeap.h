@@ -0,0 +1,251 @@
+#pragma once
+
+#include "Comparators.h"
+#include "HeapStorage.h"
+
+namespace tplx
+{
+
+/**
+    \brief Implementation of the MIN-MAX HEAP data structure (double-ended priority queue)
+        inspired by "Min-Max Heaps and Generalized Priority Queues" (M. D. Atkinson et. all).
+
+        Elements located on even levels of the tree (root level is 0) are less than or equal to all their
+        descendants, elements located on odd levels are greater than or equal to all their descendants.
+        That gives access to both the minimum and the maximum element in O(1) and allows removing each of
+        them in O(log n), while every element is stored only once.
+ */
+template <typename T>
+class MinMaxHeap : private details::HeapStorage<T>
+{
+private:
+    using Storage = details::HeapStorage<T>;
+
+public:
+    using value_type = typename Storage::value_type;
+    using const_iterator = typename Storage::const_iterator;
+    using size_type = typename Storage::size_type;
+
+    /**
+        \brief Inserts new element to the heap.
+        \throws std::bad_alloc if there is not enough memory available
+        \param item - new element to be inserted
+     */
+    void insert(T item);
+
+    /**
+        \brief Returns the minimum element of the heap.
+     */
+    T min() const noexcept;
+
+    /**
+        \brief Returns the maximum element of the heap.
+     */
+    T max() const noexcept;
+
+    /**
+        \brief Removes the minimum element from the heap.
+     */
+    void popMin() noexcept;
+
+    /**
+        \brief Removes the maximum element from the heap.
+     */
+    void popMax() noexcept;
+
+    using Storage::clear;
+    using Storage::reserve;
+
+    using Storage::empty;
+    using Storage::size;
+
+    using Storage::cbegin;
+    using Storage::cend;
+
+    const_iterator begin() const noexcept
+    {
+        return Storage::begin();
+    }
+    const_iterator end() const noexcept
+    {
+        return Storage::end();
+    }
+
+private:
+    static size_type parent(size_type index) noexcept
+    {
+        return (index - 1) / 2;
+    }
+    static bool isMinLevel(size_type index) noexcept
+    {
+        size_type level = 0;
+        for (auto i = index + 1; i > 1; i /= 2)
+        {
+            ++level;
+        }
+        return level % 2 == 0;
+    }
+
+    size_type maxIndex() const noexcept;
+    void erase(size_type index) noexcept;
+
+    template <typename Better>
+    void bubbleUp(size_type index, Better better) noexcept;
+
+    template <typename Better>
+    void trickleDown(size_type index, Better better) noexcept;
+};
+
+// -------------------------------------------------------------------------- //
+
+template <typename T>
+void MinMaxHeap<T>::insert(T item)
+{
+    this->push_back(item);
+    const auto i = this->size() - 1;
+    if (i == 0)
+    {
+        return;
+    }
+    const auto p = parent(i);
+    if (isMinLevel(i))
+    {
+        if (Greater<T>{}(this->operator[](i), this->operator[](p)))
+        {
+            this->swap(i, p);
+            bubbleUp(p, Greater<T>{});
+        }
+        else
+        {
+            bubbleUp(i, Less<T>{});
+        }
+    }
+    else
+    {
+        if (Less<T>{}(this->operator[](i), this->operator[](p)))
+        {
+            this->swap(i, p);
+            bubbleUp(p, Less<T>{});
+        }
+        else
+        {
+            bubbleUp(i, Greater<T>{});
+        }
+    }
+}
+
+template <typename T>
+T MinMaxHeap<T>::min() const noexcept
+{
+    return this->front();
+}
+
+template <typename T>
+T MinMaxHeap<T>::max() const noexcept
+{
+    return this->operator[](maxIndex());
+}
+
+template <typename T>
+void MinMaxHeap<T>::popMin() noexcept
+{
+    erase(0);
+}
+
+template <typename T>
+void MinMaxHeap<T>::popMax() noexcept
+{
+    erase(maxIndex());
+}
+
+template <typename T>
+typename MinMaxHeap<T>::size_type MinMaxHeap<T>::maxIndex() const noexcept
+{
+    assert(not this->empty());
+    if (this->size() == 1)
+    {
+        return 0;
+    }
+    if (this->size() == 2 or not Greater<T>{}(this->operator[](2), this->operator[](1)))
+    {
+        return 1;
+    }
+    return 2;
+}
+
+template <typename T>
+void MinMaxHeap<T>::erase(size_type index) noexcept
+{
+    // erased element is always either the root or one of its children, so the element moved from the back
+    // only has to be trickled down
+    this->swap(index, this->size() - 1);
+    this->pop_back();
+    if (index < this->size())
+    {
+        if (isMinLevel(index))
+        {
+            trickleDown(index, Less<T>{});
+        }
+        else
+        {
+            trickleDown(index, Greater<T>{});
+        }
+    }
+}
+
+/// \brief Moves the element up through the levels of the same kind (i.e. compares it with grandparents)
+template <typename T>
+template <typename Better>
+void MinMaxHeap<T>::bubbleUp(size_type index, Better better) noexcept
+{
+    while (index > 2)
+    {
+        const auto grandparent = parent(parent(index));
+        if (not better(this->operator[](index), this->operator[](grandparent)))
+        {
+            break;
+        }
+        this->swap(index, grandparent);
+        index = grandparent;
+    }
+}
+
+/// \brief Moves the element down selecting the best one among children and grandchildren at each step
+template <typename T>
+template <typename Better>
+void MinMaxHeap<T>::trickleDown(size_type index, Better better) noexcept
+{
+    const auto count = this->size();
+    while (2 * index + 1 < count)
+    {
+        // children: 2i+1, 2i+2; grandchildren: 4i+3 .. 4i+6
+        auto selected = 2 * index + 1;
+        const size_type candidates[] = {2 * index + 2, 4 * index + 3, 4 * index + 4, 4 * index + 5, 4 * index + 6};
+        for (auto candidate : candidates)
+        {
+            if (candidate < count and better(this->operator[](candidate), this->operator[](selected)))
+            {
+                selected = candidate;
+            }
+        }
+        if (not better(this->operator[](selected), this->operator[](index)))
+        {
+            break;
+        }
+        this->swap(selected, index);
+        if (selected <= 2 * index + 2)
+        {
+            // the child is located on the level of the opposite kind, so the element moved there
+            // is on the right side of all its descendants as the child itself was
+            break;
+        }
+        const auto p = parent(selected);
+        if (better(this->operator[](p), this->operator[](selected)))
+        {
+            this->swap(p, selected);
+        }
+        index = selected;
+    }
+}
+
+} // namespace tplx
@@ -0,0 +1,345 @@
+#pragma once
+
+#include "MedianCalculator.h"
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace tplx
+{
+
+namespace details
+{
+
+/// \brief Ranges shorter than that are not split between threads.
+constexpr std::size_t min_parallel_chunk_size = 64 * 1024;
+
+/**
+    \brief Calls task(i) for each i in [0, count) with each call run by a separate thread (the last one by
+        the calling thread) and waits for all of them.
+    \throws the first exception thrown by any of the tasks (once all of them have finished)
+ */
+template <typename Task>
+void runParallel(std::size_t count, Task task)
+{
+    std::unique_ptr<std::exception_ptr[]> errors{new std::exception_ptr[count]};
+    auto guarded = [&task, &errors](std::size_t i) {
+        try
+        {
+            task(i);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::unique_ptr<std::thread[]> workers{new std::thread[count - 1]};
+    std::size_t started = 0;
+    try
+    {
+        for (; started + 1 < count; started++)
+        {
+            workers[started] = std::thread{guarded, started};
+        }
+        guarded(count - 1);
+    }
+    catch (...)
+    {
+        // threads already started have to be joined before they are destroyed
+        for (std::size_t i = 0; i < started; i++)
+        {
+            workers[i].join();
+        }
+        throw;
+    }
+    for (std::size_t i = 0; i < started; i++)
+    {
+        workers[i].join();
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+}
+
+/// \brief Number of values sampled to choose pivots of a selection round.
+constexpr std::size_t parallel_sample_size = 64 * 1024;
+
+/// \brief Distance (in ranks of the sample) of both pivots from the estimated rank of the searched value.
+constexpr std::size_t parallel_pivot_margin = 512;
+
+/// \brief Values remaining in the interval are selected by the calling thread once there are no more of them.
+constexpr std::size_t parallel_gather_size = 4 * 1024 * 1024;
+
+/// \brief Values which are not NaN and lie strictly between the bounds (if any).
+template <typename T>
+struct ValueInterval
+{
+    bool contains(const T& value) const noexcept
+    {
+        // bitwise operators avoid branches mispredicted for values around the bounds
+        return static_cast<bool>(static_cast<int>(not isNan(value)) & static_cast<int>(not hasLower or lower < value) &
+                                 static_cast<int>(not hasUpper or value < upper));
+    }
+
+    T lower;
+    T upper;
+    bool hasLower;
+    bool hasUpper;
+};
+
+/// \brief Numbers of values of the interval (of a chunk) compared with the pivots, lower <= upper.
+struct PivotCounts
+{
+    PivotCounts& operator+=(const PivotCounts& other) noexcept
+    {
+        inside += other.inside;
+        lessThanLower += other.lessThanLower;
+        notGreaterThanLower += other.notGreaterThanLower;
+        lessThanUpper += other.lessThanUpper;
+        notGreaterThanUpper += other.notGreaterThanUpper;
+        return *this;
+    }
+
+    std::size_t inside;
+    std::size_t lessThanLower;
+    std::size_t notGreaterThanLower;
+    std::size_t lessThanUpper;
+    std::size_t notGreaterThanUpper;
+};
+
+/**
+    \brief Finds values of ranks [rank, rank + count) (0-based, NaN values skipped, \a count is 1 or 2) among
+        values of chunks of the range. The interval of values holding the searched ones is narrowed in rounds
+        of two parallel passes over the chunks: values of the interval are sampled (strided within each chunk
+        in proportion to its share of the interval) and two pivots bracketing the estimated rank are selected
+        from the sample, then values of the interval are counted against the pivots. Each round shrinks
+        the interval about parallel_sample_size / (2 * parallel_pivot_margin) times regardless of the order of
+        values and the range is never copied, remaining values are selected by the calling thread.
+    \param chunkBegin - returns pointer to the first value of the given chunk (and past the last one)
+    \param active - numbers of values of each chunk which are not NaN, overwritten
+    \param result - array receiving \a count values
+ */
+template <typename T, typename ChunkBegin>
+void parallelSelect(ChunkBegin chunkBegin, std::size_t threads, std::size_t rank, std::size_t count,
+                    std::size_t* active, T* result)
+{
+    ValueInterval<T> interval{T{}, T{}, false, false};
+    // number of values below the interval and number of values already found
+    std::size_t below = 0;
+    std::size_t found = 0;
+    std::unique_ptr<HeapStorage<T>[]> samples{new HeapStorage<T>[threads]};
+    std::unique_ptr<PivotCounts[]> counts{new PivotCounts[threads]};
+    HeapStorage<T> sample;
+    while (true)
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            total += active[i];
+        }
+        const auto gather = total <= parallel_gather_size;
+        runParallel(threads, [&](std::size_t i) {
+            auto& chunkSample = samples[i];
+            chunkSample.clear();
+            const auto wanted =
+                gather ? active[i]
+                       : static_cast<std::size_t>(static_cast<double>(parallel_sample_size) *
+                                                  static_cast<double>(active[i]) / static_cast<double>(total));
+            if (wanted == 0)
+            {
+                return;
+            }
+            chunkSample.reserve(wanted);
+            if (not interval.hasLower and not interval.hasUpper and not gather)
+            {
+                // the first round samples the whole chunk, so only sampled positions are read
+                const auto chunkSize = static_cast<std::size_t>(chunkBegin(i + 1) - chunkBegin(i));
+                for (std::size_t j = 0; j < wanted; j++)
+                {
+                    const auto value = chunkBegin(i)[chunkSize / wanted * j];
+                    if (not isNan(value))
+                    {
+                        chunkSample.push_back(value);
+                    }
+                }
+                return;
+            }
+            const auto stride = active[i] / wanted;
+            std::size_t skipped = 0;
+            for (auto value = chunkBegin(i), end = chunkBegin(i + 1); value != end and chunkSample.size() < wanted;
+                 ++value)
+            {
+                skipped += static_cast<std::size_t>(interval.contains(*value));
+                if (skipped == stride)
+                {
+                    chunkSample.push_back(*value);
+                    skipped = 0;
+                }
+            }
+        });
+        sample.clear();
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            sample.append(samples[i].begin(), samples[i].end());
+            samples[i].release();
+        }
+
+        auto target = rank + found - below;
+        if (gather)
+        {
+            if (target < sample.size())
+            {
+                details::selectNth(sample.begin(), sample.begin() + target, sample.end());
+                result[found++] = sample[target++];
+                // values following the selected one are not less than it, the least of them is the next one
+                if (found < count and target < sample.size())
+                {
+                    auto least = sample[target];
+                    for (auto i = target + 1; i < sample.size(); i++)
+                    {
+                        least = sample[i] < least ? sample[i] : least;
+                    }
+                    result[found++] = least;
+                }
+            }
+            // the next value above the interval is its upper bound (a pivot found in the range)
+            while (found < count)
+            {
+                result[found++] = interval.upper;
+            }
+            return;
+        }
+
+        auto position =
+            static_cast<std::size_t>(static_cast<double>(target) / static_cast<double>(total) * sample.size());
+        position = position < sample.size() ? position : sample.size() - 1;
+        const auto lowerPosition = position > parallel_pivot_margin ? position - parallel_pivot_margin : 0;
+        const auto upperPosition =
+            position + parallel_pivot_margin < sample.size() ? position + parallel_pivot_margin : sample.size() - 1;
+        details::selectNth(sample.begin(), sample.begin() + upperPosition, sample.end());
+        details::selectNth(sample.begin(), sample.begin() + lowerPosition, sample.begin() + upperPosition + 1);
+        const T lower = sample[lowerPosition];
+        const T upper = sample[upperPosition];
+
+        runParallel(threads, [&](std::size_t i) {
+            // comparisons are summed without branches, as order of values relative to the pivots is random
+            PivotCounts chunkCounts{0, 0, 0, 0, 0};
+            for (auto value = chunkBegin(i), end = chunkBegin(i + 1); value != end; ++value)
+            {
+                const auto inside = static_cast<std::size_t>(interval.contains(*value));
+                chunkCounts.inside += inside;
+                chunkCounts.lessThanLower += inside & static_cast<std::size_t>(*value < lower);
+                chunkCounts.notGreaterThanLower += inside & static_cast<std::size_t>(not(lower < *value));
+                chunkCounts.lessThanUpper += inside & static_cast<std::size_t>(*value < upper);
+                chunkCounts.notGreaterThanUpper += inside & static_cast<std::size_t>(not(upper < *value));
+            }
+            counts[i] = chunkCounts;
+        });
+        PivotCounts sum{0, 0, 0, 0, 0};
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            sum += counts[i];
+        }
+
+        // pivots are values of the interval, so every round removes at least one of them from it
+        if (target < sum.lessThanLower)
+        {
+            interval.upper = lower;
+            interval.hasUpper = true;
+            for (std::size_t i = 0; i < threads; i++)
+            {
+                active[i] = counts[i].lessThanLower;
+            }
+            continue;
+        }
+        if (target < sum.lessThanUpper and sum.notGreaterThanLower <= target)
+        {
+            below += sum.notGreaterThanLower;
+            interval = ValueInterval<T>{lower, upper, true, true};
+            for (std::size_t i = 0; i < threads; i++)
+            {
+                active[i] = counts[i].lessThanUpper - counts[i].notGreaterThanLower;
+            }
+            continue;
+        }
+        // the searched value equals a pivot (the following one may equal it too) or is greater than both
+        const auto atLower = target < sum.notGreaterThanLower;
+        const auto pivot = atLower ? lower : upper;
+        const auto notGreater = atLower ? sum.notGreaterThanLower : sum.notGreaterThanUpper;
+        while (found < count and target < notGreater)
+        {
+            result[found++] = pivot;
+            ++target;
+        }
+        if (found == count)
+        {
+            return;
+        }
+        // values above the pivot hold the rest
+        below += notGreater;
+        interval.lower = pivot;
+        interval.hasLower = true;
+        for (std::size_t i = 0; i < threads; i++)
+        {
+            active[i] = counts[i].inside - (atLower ? counts[i].notGreaterThanLower : counts[i].notGreaterThanUpper);
+        }
+    }
+}
+
+} // namespace details
+
+/**
+    \brief Calculates median of the [first, last) range using up to \a threads threads.
+        The range is split into equal chunks scanned in parallel: values which are not NaN are counted, then
+        the middle values are found by details::parallelSelect(). The range is only read (a few times), so
+        memory usage does not depend on its size and the speedup does not depend on the order of values
+        (e.g. sorted or time-ordered data). Values are handled as by MedianCalculator<T> (NaN values are
+        skipped). Ranges too short to benefit from threads are processed by the calling thread.
+    \throws std::bad_alloc if there is not enough memory available
+    \throws std::system_error if a thread cannot be started
+    \return median value (MedianTraits<T>::empty() for empty range)
+ */
+template <typename T>
+auto medianOf(const T* first, const T* last, std::size_t threads) -> typename MedianTraits<T>::result_type
+{
+    using Traits = MedianTraits<T>;
+    const auto size = static_cast<std::size_t>(last - first);
+    const auto maxThreads = size / details::min_parallel_chunk_size;
+    threads = threads < maxThreads ? threads : maxThreads;
+    if (threads <= 1)
+    {
+        MedianCalculator<T> calculator;
+        calculator.addRange(first, last);
+        return calculator.calculate();
+    }
+    auto chunkBegin = [=](std::size_t i) { return first + size * i / threads; };
+
+    std::unique_ptr<std::size_t[]> active{new std::size_t[threads]};
+    details::runParallel(threads, [&](std::size_t i) {
+        std::size_t count = 0;
+        for (auto value = chunkBegin(i), end = chunkBegin(i + 1); value != end; ++value)
+        {
+            count += details::isNan(*value) ? 0 : 1;
+        }
+        active[i] = count;
+    });
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        total += active[i];
+    }
+    if (total == 0)
+    {
+        return Traits::empty();
+    }
+    T middle[2];
+    details::parallelSelect(chunkBegin, threads, (total - 1) / 2, total % 2 == 0 ? 2 : 1, active.get(), middle);
+    return total % 2 == 0 ? Traits::mean(middle[0], middle[1]) : Traits::middle(middle[0]);
+}
+
+} // namespace tplx
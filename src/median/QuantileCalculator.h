@@ -0,0 +1,370 @@
+#pragma once
+
+#include "Heap.h"
+#include "MinMaxHeap.h"
+#include <cmath>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates running quantiles (e.g. p50, p90, p99) of all so far collected values.
+
+        Generalisation of the two-heap scheme used by MedianCalculator. Tracked quantiles q1 < q2 < ... < qk
+        split all collected values into k+1 ordered buckets: the lowest one is a MaxHeap, the highest one
+        is a MinHeap and the inner ones are MinMaxHeaps, so each bucket gives access to the extreme
+        elements adjacent to the neighbouring split points. Every value is stored exactly once no matter
+        how many quantiles are tracked.
+
+        Quantile q of n values is interpolated linearly between the values of ranks floor(q*(n-1)) and
+        floor(q*(n-1))+1 (0-based), so quantile 0.5 is equal to the median.
+ */
+template <typename T>
+class QuantileCalculator
+{
+public:
+    /**
+        \brief Constructs calculator of a single quantile.
+        \throws std::invalid_argument if the quantile is not within [0, 1] range
+     */
+    explicit QuantileCalculator(double quantile);
+
+    /**
+        \brief Constructs calculator of the given quantiles sharing the same set of values.
+        \throws std::invalid_argument if no quantile is given or any of them is not within [0, 1] range
+     */
+    QuantileCalculator(std::initializer_list<double> quantiles);
+
+    /**
+        \brief Constructs calculator of quantiles from the [first, last) range.
+        \throws std::invalid_argument if the range is empty or any quantile is not within [0, 1] range
+     */
+    QuantileCalculator(const double* first, const double* last);
+
+    QuantileCalculator(QuantileCalculator&& other) noexcept;
+    QuantileCalculator(const QuantileCalculator&) = delete;
+    QuantileCalculator& operator=(const QuantileCalculator&) = delete;
+    QuantileCalculator& operator=(QuantileCalculator&&) = delete;
+
+    /**
+        \brief Adds a new value to the set.
+        \param value - value to add.
+     */
+    void add(T value);
+
+    /**
+        \brief Calculates quantile of all so far collected values.
+            NOTE: Quantile of empty set is NAN.
+
+        \throws std::invalid_argument if the quantile is not tracked by the calculator
+        \param quantile - one of the quantiles provided upon construction
+        \return quantile value
+     */
+    double calculate(double quantile) const;
+
+    /**
+        \brief Reset internal state, so quantiles will be calculated from scratch starting with the
+            nearest added new value.
+     */
+    void reset() noexcept;
+
+    /// \brief Returns number of so far collected values.
+    std::size_t size() const noexcept;
+
+private:
+    void init(const double* first, const double* last);
+
+    /// \brief Returns 0-based rank (and interpolation fraction) of the given quantile among count_ values.
+    std::size_t rank(std::size_t index, double* fraction = nullptr) const noexcept;
+
+    std::size_t bucketSize(std::size_t bucket) const noexcept;
+    T bucketMin(std::size_t bucket) const noexcept;
+    T bucketMax(std::size_t bucket) const noexcept;
+    void insertToBucket(std::size_t bucket, T value);
+    T extractBucketMin(std::size_t bucket) noexcept;
+    T extractBucketMax(std::size_t bucket) noexcept;
+
+    std::unique_ptr<double[]> quantiles_;
+    std::size_t quantilesCount_;
+    MaxHeap<T> lowest_;
+    std::unique_ptr<MinMaxHeap<T>[]> inner_;
+    MinHeap<T> highest_;
+    std::size_t count_;
+};
+
+// -------------------------------------------------------------------------- //
+
+template <typename T>
+QuantileCalculator<T>::QuantileCalculator(double quantile)
+    : quantilesCount_{0}, count_{0}
+{
+    init(&quantile, &quantile + 1);
+}
+
+template <typename T>
+QuantileCalculator<T>::QuantileCalculator(std::initializer_list<double> quantiles)
+    : quantilesCount_{0}, count_{0}
+{
+    init(quantiles.begin(), quantiles.end());
+}
+
+template <typename T>
+QuantileCalculator<T>::QuantileCalculator(const double* first, const double* last)
+    : quantilesCount_{0}, count_{0}
+{
+    init(first, last);
+}
+
+template <typename T>
+QuantileCalculator<T>::QuantileCalculator(QuantileCalculator&& other) noexcept
+    : quantiles_{static_cast<std::unique_ptr<double[]>&&>(other.quantiles_)},
+      quantilesCount_{other.quantilesCount_},
+      lowest_{static_cast<MaxHeap<T>&&>(other.lowest_)},
+      inner_{static_cast<std::unique_ptr<MinMaxHeap<T>[]>&&>(other.inner_)},
+      highest_{static_cast<MinHeap<T>&&>(other.highest_)},
+      count_{other.count_}
+{
+    other.quantilesCount_ = 0;
+    other.count_ = 0;
+}
+
+template <typename T>
+void QuantileCalculator<T>::init(const double* first, const double* last)
+{
+    if (first == last)
+    {
+        throw std::invalid_argument("no quantile given");
+    }
+    quantiles_.reset(new double[last - first]);
+    for (; first != last; ++first)
+    {
+        const auto quantile = *first;
+        if (not(quantile >= 0.0 and quantile <= 1.0))
+        {
+            throw std::invalid_argument("quantile out of [0, 1] range");
+        }
+        // insertion sort skipping duplicates, the list of quantiles is short
+        auto i = quantilesCount_;
+        while (i > 0 and quantiles_[i - 1] > quantile)
+        {
+            --i;
+        }
+        if (i > 0 and quantiles_[i - 1] == quantile)
+        {
+            continue;
+        }
+        for (auto j = quantilesCount_; j > i; j--)
+        {
+            quantiles_[j] = quantiles_[j - 1];
+        }
+        quantiles_[i] = quantile;
+        ++quantilesCount_;
+    }
+    if (quantilesCount_ > 1)
+    {
+        inner_.reset(new MinMaxHeap<T>[quantilesCount_ - 1]);
+    }
+}
+
+template <typename T>
+void QuantileCalculator<T>::add(T value)
+{
+    // the value goes to the lowest bucket whose maximum is greater than the value (see details::addValue)
+    auto target = quantilesCount_;
+    for (std::size_t bucket = 0; bucket < quantilesCount_; bucket++)
+    {
+        if (bucketSize(bucket) > 0 and value < bucketMax(bucket))
+        {
+            target = bucket;
+            break;
+        }
+    }
+    insertToBucket(target, value);
+    ++count_;
+
+    // Moves elements across split points until number of elements below each split point matches its rank.
+    // Split points are processed in ascending order, so moving an element never breaks the preceding ones.
+    std::size_t below = 0;
+    for (std::size_t split = 0; split < quantilesCount_; split++)
+    {
+        below += bucketSize(split);
+        const auto expected = rank(split) + 1;
+        while (below < expected)
+        {
+            auto source = split + 1;
+            while (bucketSize(source) == 0)
+            {
+                ++source;
+            }
+            insertToBucket(split, extractBucketMin(source));
+            ++below;
+        }
+        while (below > expected)
+        {
+            assert(bucketSize(split) > 0);
+            insertToBucket(split + 1, extractBucketMax(split));
+            --below;
+        }
+    }
+}
+
+template <typename T>
+double QuantileCalculator<T>::calculate(double quantile) const
+{
+    std::size_t split = 0;
+    while (split < quantilesCount_ and quantiles_[split] != quantile)
+    {
+        ++split;
+    }
+    if (split == quantilesCount_)
+    {
+        throw std::invalid_argument("quantile is not tracked");
+    }
+    if (count_ == 0)
+    {
+        return NAN;
+    }
+
+    double fraction = 0.0;
+    rank(split, &fraction);
+
+    auto lowerBucket = split;
+    while (bucketSize(lowerBucket) == 0)
+    {
+        --lowerBucket;
+    }
+    const double lower = bucketMax(lowerBucket);
+    if (fraction == 0.0)
+    {
+        return lower;
+    }
+    auto upperBucket = split + 1;
+    while (bucketSize(upperBucket) == 0)
+    {
+        ++upperBucket;
+    }
+    const double upper = bucketMin(upperBucket);
+    return lower + fraction * (upper - lower);
+}
+
+template <typename T>
+void QuantileCalculator<T>::reset() noexcept
+{
+    lowest_.clear();
+    for (std::size_t i = 0; i + 1 < quantilesCount_; i++)
+    {
+        inner_[i].clear();
+    }
+    highest_.clear();
+    count_ = 0;
+}
+
+template <typename T>
+std::size_t QuantileCalculator<T>::size() const noexcept
+{
+    return count_;
+}
+
+template <typename T>
+std::size_t QuantileCalculator<T>::rank(std::size_t index, double* fraction) const noexcept
+{
+    assert(count_ > 0);
+    const auto position = quantiles_[index] * static_cast<double>(count_ - 1);
+    const auto result = static_cast<std::size_t>(position);
+    if (fraction)
+    {
+        *fraction = position - static_cast<double>(result);
+    }
+    return result;
+}
+
+template <typename T>
+std::size_t QuantileCalculator<T>::bucketSize(std::size_t bucket) const noexcept
+{
+    if (bucket == 0)
+    {
+        return lowest_.size();
+    }
+    if (bucket == quantilesCount_)
+    {
+        return highest_.size();
+    }
+    return inner_[bucket - 1].size();
+}
+
+template <typename T>
+T QuantileCalculator<T>::bucketMin(std::size_t bucket) const noexcept
+{
+    // the lowest bucket is never asked for its minimum
+    assert(bucket > 0);
+    if (bucket == quantilesCount_)
+    {
+        return highest_.top();
+    }
+    return inner_[bucket - 1].min();
+}
+
+template <typename T>
+T QuantileCalculator<T>::bucketMax(std::size_t bucket) const noexcept
+{
+    // the highest bucket is never asked for its maximum
+    assert(bucket < quantilesCount_);
+    if (bucket == 0)
+    {
+        return lowest_.top();
+    }
+    return inner_[bucket - 1].max();
+}
+
+template <typename T>
+void QuantileCalculator<T>::insertToBucket(std::size_t bucket, T value)
+{
+    if (bucket == 0)
+    {
+        lowest_.insert(value);
+    }
+    else if (bucket == quantilesCount_)
+    {
+        highest_.insert(value);
+    }
+    else
+    {
+        inner_[bucket - 1].insert(value);
+    }
+}
+
+template <typename T>
+T QuantileCalculator<T>::extractBucketMin(std::size_t bucket) noexcept
+{
+    const auto value = bucketMin(bucket);
+    if (bucket == quantilesCount_)
+    {
+        highest_.pop();
+    }
+    else
+    {
+        inner_[bucket - 1].popMin();
+    }
+    return value;
+}
+
+template <typename T>
+T QuantileCalculator<T>::extractBucketMax(std::size_t bucket) noexcept
+{
+    const auto value = bucketMax(bucket);
+    if (bucket == 0)
+    {
+        lowest_.pop();
+    }
+    else
+    {
+        inner_[bucket - 1].popMax();
+    }
+    return value;
+}
+
+} // namespace tplx
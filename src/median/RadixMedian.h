@@ -0,0 +1,234 @@
+#pragma once
+
+#include "HeapStorageTypeTraits.h"
+#include "MedianTraits.h"
+#include "ParallelMedian.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace tplx
+{
+
+namespace details
+{
+
+template <std::size_t Size>
+struct UnsignedOfSize;
+
+template <>
+struct UnsignedOfSize<2>
+{
+    using type = std::uint16_t;
+};
+
+template <>
+struct UnsignedOfSize<4>
+{
+    using type = std::uint32_t;
+};
+
+template <>
+struct UnsignedOfSize<8>
+{
+    using type = std::uint64_t;
+};
+
+enum class RadixKind
+{
+    unsigned_integer,
+    signed_integer,
+    floating_point
+};
+
+template <typename T>
+constexpr RadixKind radixKindOf()
+{
+    return isFloatingPoint<T>() ? RadixKind::floating_point
+                                : isSigned<T>() ? RadixKind::signed_integer : RadixKind::unsigned_integer;
+}
+
+/**
+    \brief Maps values to unsigned keys of the same size ordered the same way as the values, so the values
+        can be selected digit by digit.
+ */
+template <typename T, RadixKind Kind = radixKindOf<T>()>
+struct RadixKey;
+
+template <typename T>
+struct RadixKey<T, RadixKind::unsigned_integer>
+{
+    using type = typename UnsignedOfSize<sizeof(T)>::type;
+
+    static type encode(T value) noexcept
+    {
+        return static_cast<type>(value);
+    }
+    static T decode(type key) noexcept
+    {
+        return static_cast<T>(key);
+    }
+};
+
+template <typename T>
+struct RadixKey<T, RadixKind::signed_integer>
+{
+    using type = typename UnsignedOfSize<sizeof(T)>::type;
+    static constexpr type sign_bit = static_cast<type>(type{1} << (sizeof(type) * 8 - 1));
+
+    // flipping the sign bit moves negative numbers (two's complement) below the positive ones
+    static type encode(T value) noexcept
+    {
+        return static_cast<type>(static_cast<type>(value) ^ sign_bit);
+    }
+    static T decode(type key) noexcept
+    {
+        return static_cast<T>(static_cast<type>(key ^ sign_bit));
+    }
+};
+
+template <typename T>
+struct RadixKey<T, RadixKind::floating_point>
+{
+    static_assert(sizeof(T) <= sizeof(std::uint64_t), "long double is not supported");
+
+    using type = typename UnsignedOfSize<sizeof(T)>::type;
+    static constexpr type sign_bit = static_cast<type>(type{1} << (sizeof(type) * 8 - 1));
+
+    // IEEE 754: positive numbers are ordered like their bits, negative ones in reverse
+    static type encode(T value) noexcept
+    {
+        type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & sign_bit) ? static_cast<type>(~bits) : static_cast<type>(bits | sign_bit);
+    }
+    static T decode(type key) noexcept
+    {
+        const type bits = (key & sign_bit) ? static_cast<type>(key ^ sign_bit) : static_cast<type>(~key);
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+/// \brief Number of bits of the key selected by a single pass (histogram of 64K buckets fits L2 cache).
+constexpr unsigned radix_digit_bits = 16;
+
+} // namespace details
+
+/**
+    \brief Calculates exact median of the [first, last) range of integral or floating point values using up to
+        \a threads threads, without copying or modifying the range.
+        Values are mapped to order preserving unsigned keys and the middle element is selected digit by digit
+        (16 bits at a time): each pass builds per-thread histograms of the next digit of keys sharing
+        the already selected prefix and picks the bucket holding the middle rank. 32-bit values take
+        2 passes over the range, 64-bit ones 4 passes, one more pass finds the upper middle element
+        if it differs from the lower one. NaN values are skipped (like by MedianCalculator<T>).
+    \throws std::bad_alloc if there is not enough memory available
+    \throws std::system_error if a thread cannot be started
+    \return median value (MedianTraits<T>::empty() for empty range)
+ */
+template <typename T>
+auto radixMedianOf(const T* first, const T* last, std::size_t threads) -> typename MedianTraits<T>::result_type
+{
+    static_assert(details::isArithmetic<T>(), "radixMedianOf supports integral and floating point values only");
+    using Key = details::RadixKey<T>;
+    using KeyType = typename Key::type;
+    constexpr unsigned keyBits = sizeof(KeyType) * 8;
+    constexpr unsigned digitBits = keyBits < details::radix_digit_bits ? keyBits : details::radix_digit_bits;
+    constexpr std::size_t buckets = std::size_t{1} << digitBits;
+
+    const auto size = static_cast<std::size_t>(last - first);
+    const auto maxThreads = size / details::min_parallel_chunk_size;
+    threads = threads < maxThreads ? threads : maxThreads;
+    threads = threads > 0 ? threads : 1;
+    auto chunkBegin = [=](std::size_t i) { return first + size * i / threads; };
+
+    std::unique_ptr<std::size_t[]> histograms{new std::size_t[threads * buckets]};
+    std::unique_ptr<std::size_t[]> total{new std::size_t[buckets]};
+    // keys whose bits above prefixShift equal prefix are still candidates
+    KeyType prefix = 0;
+    unsigned prefixShift = keyBits;
+    std::size_t rank = 0;
+    bool even = false;
+    // number of keys equal to the selected one (the bucket selected by the last pass)
+    std::size_t equal = 0;
+    for (unsigned selected = 0; selected < keyBits; selected += digitBits)
+    {
+        const unsigned shift = prefixShift - digitBits;
+        details::runParallel(threads, [&](std::size_t i) {
+            const auto histogram = histograms.get() + i * buckets;
+            std::memset(histogram, 0, buckets * sizeof(std::size_t));
+            for (auto value = chunkBegin(i); value != chunkBegin(i + 1); ++value)
+            {
+                if (details::isNan(*value))
+                {
+                    continue;
+                }
+                const auto key = Key::encode(*value);
+                // shifting by the width of the key is undefined, the first pass takes all keys
+                if (prefixShift == keyBits or (key >> prefixShift) == prefix)
+                {
+                    ++histogram[(key >> shift) & (buckets - 1)];
+                }
+            }
+        });
+        std::size_t count = 0;
+        for (std::size_t bucket = 0; bucket < buckets; bucket++)
+        {
+            total[bucket] = 0;
+            for (std::size_t i = 0; i < threads; i++)
+            {
+                total[bucket] += histograms[i * buckets + bucket];
+            }
+            count += total[bucket];
+        }
+        if (selected == 0)
+        {
+            if (count == 0)
+            {
+                return MedianTraits<T>::empty();
+            }
+            rank = (count - 1) / 2;
+            even = count % 2 == 0;
+        }
+        std::size_t bucket = 0;
+        while (rank >= total[bucket])
+        {
+            rank -= total[bucket++];
+        }
+        equal = total[bucket];
+        prefix = static_cast<KeyType>((prefix << digitBits) | bucket);
+        prefixShift = shift;
+    }
+    const auto lower = Key::decode(prefix);
+    // the upper middle element is equal to the lower one unless the lower one is the last of equal keys
+    if (not even or rank + 1 < equal)
+    {
+        return MedianTraits<T>::middle(lower);
+    }
+
+    // the upper middle element is the least key greater than the lower middle one
+    std::unique_ptr<KeyType[]> least{new KeyType[threads]};
+    details::runParallel(threads, [&](std::size_t i) {
+        KeyType found = static_cast<KeyType>(~KeyType{0});
+        for (auto value = chunkBegin(i); value != chunkBegin(i + 1); ++value)
+        {
+            const auto key = Key::encode(*value);
+            if (not details::isNan(*value) and prefix < key and key < found)
+            {
+                found = key;
+            }
+        }
+        least[i] = found;
+    });
+    KeyType upper = least[0];
+    for (std::size_t i = 1; i < threads; i++)
+    {
+        upper = least[i] < upper ? least[i] : upper;
+    }
+    return MedianTraits<T>::mean(lower, Key::decode(upper));
+}
+
+} // namespace tplx
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "Algorithms.h"
+#include "HeapStorage.h"
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates approximate median using bounded amount of memory.
+
+        Implementation of the KLL quantile sketch (Z. Karnin, K. Lang, E. Liberty "Optimal Quantile
+        Approximation in Streams"). Values are kept in a hierarchy of compactors. Each value stored at
+        level h represents 2^h original values. Capacity of level h is k * (2/3)^(H-1-h) (but at least 8),
+        where H is number of levels, so the total capacity stays below 3k plus 8 values per level regardless
+        of the stream length. Once the number of retained values reaches the total capacity, the lowest
+        level exceeding its own capacity gets sorted and every other value (starting with randomly chosen
+        one) is promoted to the next level while the rest is discarded.
+
+        Until k values are collected the result is exact. Afterwards the rank of the returned value differs
+        from n/2 by at most rankError() * n with high probability.
+
+        Sketches using the same accuracy parameter can be merged.
+ */
+template <typename T>
+class SketchMedianCalculator
+{
+public:
+    /// \brief Default accuracy parameter giving about 1% rank error.
+    static constexpr std::size_t default_k = 400;
+
+    /**
+        \brief Constructs calculator with the given accuracy parameter.
+        \param k - capacity of the top level compactor, the bigger the more accurate and memory consuming
+     */
+    explicit SketchMedianCalculator(std::size_t k = default_k);
+
+    /**
+        \brief Returns accuracy parameter guaranteeing the given rank error (as a fraction of stream length).
+        \param rankError - requested normalized rank error, e.g. 0.01 for 1%
+     */
+    static std::size_t accuracyForRankError(double rankError) noexcept;
+
+    /**
+        \brief Adds a new value to the set.
+        \throws std::bad_alloc if there is not enough memory available
+        \param value - value to add.
+     */
+    void add(T value);
+
+    /**
+        \brief Calculates approximate median from all so far collected values.
+            NOTE: Median of empty set is NAN.
+            Not const: the lowest level, kept unsorted by add(), is sorted in place, so concurrent readers
+            have to synchronize like writers do.
+
+        \return median value
+     */
+    double calculate() noexcept;
+
+    /**
+        \brief Reset internal state, so median will be calculated from scratch starting with the
+            nearest added new value.
+     */
+    void reset() noexcept;
+
+    /**
+        \brief Merges values summarized by the other sketch into this one.
+        \param other - sketch constructed with the same accuracy parameter
+     */
+    void merge(const SketchMedianCalculator& other);
+
+    /// \brief Returns number of so far collected values.
+    std::uint64_t size() const noexcept;
+
+    /// \brief Returns number of currently retained values.
+    std::size_t retained() const noexcept;
+
+    /// \brief Returns upper limit of the number of retained values.
+    std::size_t maxRetained() const noexcept;
+
+    /// \brief Returns expected upper limit of the normalized rank error.
+    double rankError() const noexcept;
+
+private:
+    static constexpr std::size_t max_levels = 64;
+
+    static constexpr std::size_t min_level_capacity = 8;
+
+    std::size_t levelCapacity(std::size_t level) const noexcept;
+    void addLevel();
+    void compress();
+    void compact(std::size_t level);
+    bool randomBit() noexcept;
+
+    // level 0 is kept unsorted until it is compacted or the median is calculated, other levels are sorted
+    details::HeapStorage<T> levels_[max_levels];
+    details::HeapStorage<T> promoted_;
+    std::size_t levelsCount_;
+    std::size_t k_;
+    std::size_t retained_;
+    std::size_t capacity_;
+    std::uint64_t count_;
+    std::uint64_t randomState_;
+};
+
+// -------------------------------------------------------------------------- //
+
+template <typename T>
+constexpr std::size_t SketchMedianCalculator<T>::default_k;
+
+template <typename T>
+constexpr std::size_t SketchMedianCalculator<T>::max_levels;
+
+template <typename T>
+constexpr std::size_t SketchMedianCalculator<T>::min_level_capacity;
+
+template <typename T>
+SketchMedianCalculator<T>::SketchMedianCalculator(std::size_t k)
+    : levelsCount_{1},
+      k_{k < min_level_capacity ? min_level_capacity : k},
+      retained_{0},
+      capacity_{k_},
+      count_{0},
+      randomState_{0x9E3779B97F4A7C15ULL}
+{
+}
+
+template <typename T>
+std::size_t SketchMedianCalculator<T>::accuracyForRankError(double rankError) noexcept
+{
+    // empirical relation between k and the rank error of the median
+    return static_cast<std::size_t>(std::ceil(4.0 / rankError));
+}
+
+template <typename T>
+double SketchMedianCalculator<T>::rankError() const noexcept
+{
+    return 4.0 / static_cast<double>(k_);
+}
+
+template <typename T>
+void SketchMedianCalculator<T>::add(T value)
+{
+    levels_[0].push_back(value);
+    ++count_;
+    ++retained_;
+    if (retained_ >= capacity_)
+    {
+        compress();
+    }
+}
+
+template <typename T>
+double SketchMedianCalculator<T>::calculate() noexcept
+{
+    if (count_ == 0)
+    {
+        return NAN;
+    }
+    details::sort(levels_[0].begin(), levels_[0].end());
+
+    // k-way merge of sorted levels until both middle ranks are reached
+    const auto lowerRank = (count_ - 1) / 2;
+    const auto upperRank = count_ / 2;
+    std::size_t positions[max_levels] = {};
+    std::uint64_t weightSoFar = 0;
+    double lower = NAN;
+    while (true)
+    {
+        std::size_t selected = max_levels;
+        for (std::size_t level = 0; level < levelsCount_; level++)
+        {
+            if (positions[level] < levels_[level].size() and
+                (selected == max_levels or levels_[level][positions[level]] < levels_[selected][positions[selected]]))
+            {
+                selected = level;
+            }
+        }
+        assert(selected != max_levels);
+        const auto value = levels_[selected][positions[selected]++];
+        weightSoFar += std::uint64_t{1} << selected;
+        if (weightSoFar > lowerRank and std::isnan(lower))
+        {
+            lower = static_cast<double>(value);
+        }
+        if (weightSoFar > upperRank)
+        {
+            return (lower + static_cast<double>(value)) / 2;
+        }
+    }
+}
+
+template <typename T>
+void SketchMedianCalculator<T>::reset() noexcept
+{
+    for (std::size_t level = 0; level < levelsCount_; level++)
+    {
+        levels_[level].clear();
+    }
+    levelsCount_ = 1;
+    retained_ = 0;
+    capacity_ = k_;
+    count_ = 0;
+}
+
+template <typename T>
+void SketchMedianCalculator<T>::merge(const SketchMedianCalculator& other)
+{
+    assert(k_ == other.k_);
+    while (levelsCount_ < other.levelsCount_)
+    {
+        addLevel();
+    }
+    for (std::size_t level = 0; level < other.levelsCount_; level++)
+    {
+        for (auto value : other.levels_[level])
+        {
+            levels_[level].push_back(value);
+        }
+        if (level > 0)
+        {
+            details::sort(levels_[level].begin(), levels_[level].end());
+        }
+    }
+    count_ += other.count_;
+    retained_ += other.retained_;
+    compress();
+}
+
+template <typename T>
+std::uint64_t SketchMedianCalculator<T>::size() const noexcept
+{
+    return count_;
+}
+
+template <typename T>
+std::size_t SketchMedianCalculator<T>::retained() const noexcept
+{
+    return retained_;
+}
+
+template <typename T>
+std::size_t SketchMedianCalculator<T>::maxRetained() const noexcept
+{
+    // sum of k * (2/3)^i is below 3k, capacities of the lowest levels are rounded up to min_level_capacity
+    return 3 * k_ + min_level_capacity * max_levels;
+}
+
+template <typename T>
+std::size_t SketchMedianCalculator<T>::levelCapacity(std::size_t level) const noexcept
+{
+    const auto depth = levelsCount_ - 1 - level;
+    const auto capacity = static_cast<std::size_t>(std::ceil(static_cast<double>(k_) * std::pow(2.0 / 3.0, depth)));
+    return capacity < min_level_capacity ? min_level_capacity : capacity;
+}
+
+template <typename T>
+void SketchMedianCalculator<T>::addLevel()
+{
+    assert(levelsCount_ < max_levels);
+    ++levelsCount_;
+    capacity_ = 0;
+    for (std::size_t level = 0; level < levelsCount_; level++)
+    {
+        capacity_ += levelCapacity(level);
+    }
+}
+
+template <typename T>
+void SketchMedianCalculator<T>::compress()
+{
+    while (retained_ >= capacity_)
+    {
+        // at least one level exceeds its capacity as the total capacity is exceeded
+        std::size_t level = 0;
+        while (levels_[level].size() < levelCapacity(level))
+        {
+            ++level;
+        }
+        if (level + 1 == levelsCount_)
+        {
+            addLevel();
+        }
+        compact(level);
+    }
+}
+
+template <typename T>
+void SketchMedianCalculator<T>::compact(std::size_t level)
+{
+    auto& source = levels_[level];
+    auto& destination = levels_[level + 1];
+    if (level == 0)
+    {
+        details::sort(source.begin(), source.end());
+    }
+
+    // in case of odd number of values either the smallest or the biggest one stays at the current level
+    const auto count = source.size();
+    const bool hasLeftover = count % 2 != 0;
+    std::size_t first = 0;
+    std::size_t last = count;
+    T leftover{};
+    if (hasLeftover)
+    {
+        if (randomBit())
+        {
+            leftover = source[first++];
+        }
+        else
+        {
+            leftover = source[--last];
+        }
+    }
+
+    promoted_.clear();
+    const std::size_t offset = randomBit() ? 1 : 0;
+    for (auto i = first + offset; i < last; i += 2)
+    {
+        promoted_.push_back(source[i]);
+    }
+    source.clear();
+    if (hasLeftover)
+    {
+        source.push_back(leftover);
+    }
+    retained_ -= count - source.size() - promoted_.size();
+
+    // merges promoted values with the sorted content of the next level, starting from the back
+    auto destinationIndex = destination.size();
+    auto promotedIndex = promoted_.size();
+    for (std::size_t i = 0; i < promotedIndex; i++)
+    {
+        destination.push_back(T{});
+    }
+    auto target = destination.size();
+    while (promotedIndex > 0)
+    {
+        if (destinationIndex > 0 and promoted_[promotedIndex - 1] < destination[destinationIndex - 1])
+        {
+            destination[--target] = destination[--destinationIndex];
+        }
+        else
+        {
+            destination[--target] = promoted_[--promotedIndex];
+        }
+    }
+}
+
+template <typename T>
+bool SketchMedianCalculator<T>::randomBit() noexcept
+{
+    // xorshift64
+    randomState_ ^= randomState_ << 13;
+    randomState_ ^= randomState_ >> 7;
+    randomState_ ^= randomState_ << 17;
+    return (randomState_ & 1) != 0;
+}
+
+} // namespace tplx
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "HeapStorageTypeTraits.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace tplx
+{
+
+/**
+    \brief Header of the binary snapshot of MedianCalculator state.
+
+        The snapshot consists of the header followed by the raw arrays of the lower half (max heap) and
+        the upper half (min heap), exactly as they are kept in memory, so restoring the state needs no
+        per-element work. All fields and values are stored in native byte order, snapshots are meant to be
+        restored on the machine (architecture) which has written them.
+ */
+struct SnapshotHeader
+{
+    /// \brief "RMSN" in little endian byte order.
+    static constexpr std::uint32_t magic_value = 0x4E534D52;
+    static constexpr std::uint16_t current_version = 1;
+
+    /// \brief Kinds of values stored in the snapshot.
+    enum ValueKind : std::uint16_t
+    {
+        custom_value = 0,
+        signed_value = 1,
+        unsigned_value = 2,
+        floating_point_value = 3
+    };
+
+    /// \brief Flag set if a NaN value has been added with NanPolicy::propagate.
+    static constexpr std::uint32_t nan_added = 1;
+
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t valueSize;
+    std::uint16_t valueKind;
+    std::uint16_t reserved;
+    std::uint32_t flags;
+    std::uint64_t lowerSize;
+    std::uint64_t upperSize;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "values following the header have to stay aligned");
+
+namespace details
+{
+
+template <typename T>
+constexpr std::uint16_t snapshotValueKind()
+{
+    return isFloatingPoint<T>() ? SnapshotHeader::floating_point_value
+                                : not isIntegral<T>() ? SnapshotHeader::custom_value
+                                                      : isSigned<T>() ? SnapshotHeader::signed_value
+                                                                      : SnapshotHeader::unsigned_value;
+}
+
+template <typename T>
+SnapshotHeader makeSnapshotHeader(std::size_t lowerSize, std::size_t upperSize, std::uint32_t flags) noexcept
+{
+    SnapshotHeader header{};
+    header.magic = SnapshotHeader::magic_value;
+    header.version = SnapshotHeader::current_version;
+    header.valueSize = static_cast<std::uint16_t>(sizeof(T));
+    header.valueKind = snapshotValueKind<T>();
+    header.flags = flags;
+    header.lowerSize = lowerSize;
+    header.upperSize = upperSize;
+    return header;
+}
+
+/**
+    \brief Reads and validates the header of the snapshot of calculator of T values.
+    \throws std::invalid_argument if the snapshot is malformed, has unsupported version or holds values
+        of other type
+ */
+template <typename T>
+SnapshotHeader readSnapshotHeader(const void* data, std::size_t size)
+{
+    SnapshotHeader header;
+    if (size < sizeof(header))
+    {
+        throw std::invalid_argument("snapshot too short");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != SnapshotHeader::magic_value)
+    {
+        throw std::invalid_argument("not a snapshot");
+    }
+    if (header.version != SnapshotHeader::current_version)
+    {
+        throw std::invalid_argument("unsupported snapshot version");
+    }
+    if (header.valueSize != sizeof(T) or header.valueKind != snapshotValueKind<T>())
+    {
+        throw std::invalid_argument("snapshot of values of other type");
+    }
+    const auto capacity = (size - sizeof(header)) / sizeof(T);
+    if ((size - sizeof(header)) % sizeof(T) != 0 or header.lowerSize > capacity or
+        header.upperSize != capacity - header.lowerSize)
+    {
+        throw std::invalid_argument("snapshot size mismatch");
+    }
+    // the lower half is never empty if the set is not empty (see MedianCalculator::add())
+    if (header.lowerSize > header.upperSize + 1 or header.upperSize > header.lowerSize + 1 or
+        (header.lowerSize == 0 and header.upperSize != 0))
+    {
+        throw std::invalid_argument("unbalanced snapshot");
+    }
+    return header;
+}
+
+} // namespace details
+} // namespace tplx
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "MedianCalculator.h"
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace tplx
+{
+namespace details
+{
+
+/// \brief Throws std::system_error of the current errno described as "<action> <path>".
+[[noreturn]] inline void throwSystemError(const char* action, const char* path)
+{
+    const int error = errno;
+    char what[PATH_MAX + 64];
+    std::snprintf(what, sizeof(what), "%s %s", action, path);
+    throw std::system_error{error, std::system_category(), what};
+}
+
+/// \brief Path of a file created next to the \a path file, "<path>.tmp".
+class TemporaryPath
+{
+public:
+    /// \throws std::system_error if the resulting path is too long
+    explicit TemporaryPath(const char* path)
+    {
+        if (std::snprintf(path_, sizeof(path_), "%s.tmp", path) >= static_cast<int>(sizeof(path_)))
+        {
+            errno = ENAMETOOLONG;
+            throwSystemError("cannot create temporary file of", path);
+        }
+    }
+    const char* get() const noexcept
+    {
+        return path_;
+    }
+
+private:
+    char path_[PATH_MAX];
+};
+
+/**
+    \brief Flushes the directory holding the \a path file, so its renaming is persisted. Best effort only,
+        some file systems do not support synchronizing directories.
+ */
+inline void syncParentDirectory(const char* path) noexcept
+{
+    char directory[PATH_MAX];
+    const char* separator = std::strrchr(path, '/');
+    if (separator == nullptr)
+    {
+        std::strcpy(directory, ".");
+    }
+    else if (separator == path)
+    {
+        std::strcpy(directory, "/");
+    }
+    else
+    {
+        const auto length = static_cast<std::size_t>(separator - path);
+        if (length >= sizeof(directory))
+        {
+            return;
+        }
+        std::memcpy(directory, path, length);
+        directory[length] = '\0';
+    }
+    const int fd = ::open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+/// \brief Owns the file descriptor.
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd) noexcept : fd_{fd}
+    {
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    ~FileDescriptor()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+    int get() const noexcept
+    {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+/// \brief Owns the memory mapping of the whole file.
+class FileMapping
+{
+public:
+    /// \throws std::system_error if the file cannot be mapped
+    FileMapping(const FileDescriptor& file, std::size_t size, int protection, int flags, const char* path)
+        : memory_{size == 0 ? nullptr : ::mmap(nullptr, size, protection, flags, file.get(), 0)}, size_{size}
+    {
+        if (memory_ == MAP_FAILED)
+        {
+            throwSystemError("cannot map", path);
+        }
+    }
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+    ~FileMapping()
+    {
+        if (memory_)
+        {
+            ::munmap(memory_, size_);
+        }
+    }
+    void* get() const noexcept
+    {
+        return memory_;
+    }
+    /// \throws std::system_error if writing the mapped pages to the file fails
+    void sync(const char* path) const
+    {
+        if (memory_ and ::msync(memory_, size_, MS_SYNC) != 0)
+        {
+            throwSystemError("cannot sync", path);
+        }
+    }
+
+private:
+    void* memory_;
+    std::size_t size_;
+};
+
+} // namespace details
+
+/**
+    \brief Writes snapshot of the calculator state to the file (see MedianCalculator::saveSnapshot()).
+        The snapshot is written to a temporary file (its blocks allocated up front) mapped to memory,
+        flushed to the storage and then renamed
+        to the \a path file, so after a crash the file holds either the previous or the new snapshot, never
+        a partially written one. The temporary file is removed if any step fails.
+    \throws std::system_error if the file cannot be written
+ */
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void saveSnapshotFile(const MedianCalculator<T, Allocator, Nan, Stats>& calculator, const char* path)
+{
+    const details::TemporaryPath temporaryPath{path};
+    const auto size = calculator.snapshotSize();
+    details::FileDescriptor file{::open(temporaryPath.get(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+    if (file.get() < 0)
+    {
+        details::throwSystemError("cannot create", temporaryPath.get());
+    }
+    try
+    {
+        // ftruncate() would leave a sparse file, so running out of disk space while writing through
+        // the mapping would raise SIGBUS instead of failing here
+        const int error = ::posix_fallocate(file.get(), 0, static_cast<off_t>(size));
+        if (error != 0)
+        {
+            errno = error;
+            details::throwSystemError("cannot allocate", temporaryPath.get());
+        }
+        {
+            details::FileMapping mapping{file, size, PROT_READ | PROT_WRITE, MAP_SHARED, temporaryPath.get()};
+            calculator.saveSnapshot(mapping.get());
+            mapping.sync(temporaryPath.get());
+        }
+        // data has to reach the storage before the rename does
+        if (::fsync(file.get()) != 0)
+        {
+            details::throwSystemError("cannot sync", temporaryPath.get());
+        }
+        if (::rename(temporaryPath.get(), path) != 0)
+        {
+            details::throwSystemError("cannot rename", temporaryPath.get());
+        }
+    }
+    catch (...)
+    {
+        ::unlink(temporaryPath.get());
+        throw;
+    }
+    details::syncParentDirectory(path);
+}
+
+/**
+    \brief Restores the calculator state from the snapshot file written by saveSnapshotFile().
+        The file is mapped to memory (pages populated up front) and its arrays are copied to the heaps
+        at once, so restoring even big states takes milliseconds.
+    \throws std::system_error if the file cannot be read
+    \throws std::invalid_argument if the file is not a valid snapshot of the calculator
+ */
+template <typename T, typename Allocator, NanPolicy Nan, typename Stats>
+void loadSnapshotFile(MedianCalculator<T, Allocator, Nan, Stats>& calculator, const char* path)
+{
+    details::FileDescriptor file{::open(path, O_RDONLY | O_CLOEXEC)};
+    if (file.get() < 0)
+    {
+        details::throwSystemError("cannot open", path);
+    }
+    struct stat status;
+    if (::fstat(file.get(), &status) != 0)
+    {
+        details::throwSystemError("cannot stat", path);
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    details::FileMapping mapping{file, size, PROT_READ, flags, path};
+    calculator.restoreSnapshot(mapping.get(), size);
+}
+
+} // namespace tplx
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tplx
+{
+
+/// \brief Statistics collected by CollectStats policy of heaps and calculators.
+struct StatsSnapshot
+{
+    /// \brief Number of buckets of the depth histograms, the last one counts all deeper operations.
+    static constexpr std::size_t depth_buckets = 64;
+
+    /// \brief Number of allocations of a new buffer by HeapStorage (including the first one).
+    std::uint64_t reallocations;
+    /// \brief Number of bytes copied from old buffers to the new ones.
+    std::uint64_t bytesCopied;
+    /// \brief Number of values moved from one half of MedianCalculator to the other one.
+    std::uint64_t rebalances;
+    /// \brief Histogram of the number of levels an element moved up by a single sift-up.
+    std::uint64_t siftUpDepths[depth_buckets];
+    /// \brief Histogram of the number of levels an element moved down by a single sift-down (heapify).
+    std::uint64_t siftDownDepths[depth_buckets];
+
+    StatsSnapshot& operator+=(const StatsSnapshot& other) noexcept
+    {
+        reallocations += other.reallocations;
+        bytesCopied += other.bytesCopied;
+        rebalances += other.rebalances;
+        for (std::size_t i = 0; i < depth_buckets; i++)
+        {
+            siftUpDepths[i] += other.siftUpDepths[i];
+            siftDownDepths[i] += other.siftDownDepths[i];
+        }
+        return *this;
+    }
+};
+
+/**
+    \brief Statistics policy of HeapStorage, Heap and MedianCalculator collecting nothing (default).
+        All hooks are empty inline functions, so they and the bookkeeping feeding them are optimized out
+        and the policy adds no data members (empty base optimization).
+
+        Every statistics policy provides:
+        - void reallocated(std::size_t bytesCopied) - a new buffer has been allocated,
+        - void siftedUp(std::size_t levels), void siftedDown(std::size_t levels) - heap element has moved,
+        - void rebalanced(std::size_t count) - values have been moved between halves of a calculator,
+        - StatsSnapshot snapshot() const - collected statistics.
+ */
+struct NoStats
+{
+    void reallocated(std::size_t) noexcept
+    {
+    }
+    void siftedUp(std::size_t) noexcept
+    {
+    }
+    void siftedDown(std::size_t) noexcept
+    {
+    }
+    void rebalanced(std::size_t) noexcept
+    {
+    }
+    StatsSnapshot snapshot() const noexcept
+    {
+        return StatsSnapshot{};
+    }
+};
+
+/// \brief Statistics policy counting all reported events (see NoStats).
+class CollectStats
+{
+public:
+    CollectStats() noexcept : stats_{}
+    {
+    }
+
+    void reallocated(std::size_t bytesCopied) noexcept
+    {
+        ++stats_.reallocations;
+        stats_.bytesCopied += bytesCopied;
+    }
+    void siftedUp(std::size_t levels) noexcept
+    {
+        ++stats_.siftUpDepths[bucket(levels)];
+    }
+    void siftedDown(std::size_t levels) noexcept
+    {
+        ++stats_.siftDownDepths[bucket(levels)];
+    }
+    void rebalanced(std::size_t count) noexcept
+    {
+        stats_.rebalances += count;
+    }
+    StatsSnapshot snapshot() const noexcept
+    {
+        return stats_;
+    }
+
+private:
+    static std::size_t bucket(std::size_t levels) noexcept
+    {
+        return levels < StatsSnapshot::depth_buckets ? levels : StatsSnapshot::depth_buckets - 1;
+    }
+
+    StatsSnapshot stats_;
+};
+
+} // namespace tplx
@@ -0,0 +1,356 @@
+#pragma once
+
+#include "Algorithms.h"
+#include "IndexedHeap.h"
+#include "Timestamp.h"
+#include <climits>
+#include <cmath>
+#include <cassert>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates median of values added within the recent period of time (e.g. last 5 seconds).
+
+        Values are kept in two indexed heaps (lower and upper half) and in a FIFO queue ordered by their
+        timestamps. Expired values are located by binary search in the queue and removed as a single batch:
+        either one by one in O(log n) each, or, if most of the retained values expire at once (e.g. after
+        a quiet period), by splitting the surviving values around their median and building both halves
+        bottom-up in O(m), whichever is cheaper.
+ */
+template <typename T>
+class TimeWindowMedianCalculator
+{
+public:
+    /**
+        \brief Constructs calculator of the median of values not older than \a duration.
+        \param duration - length of the window expressed in the same units as timestamps, must be positive
+     */
+    explicit TimeWindowMedianCalculator(Timestamp duration);
+
+    /**
+        \brief Adds a new value to the window and expires values which fall out of it.
+        \throws std::bad_alloc if there is not enough memory available
+        \param value - value to add.
+        \param timestamp - time of the value, must not precede timestamp of the previously added value
+     */
+    void add(T value, Timestamp timestamp);
+
+    /**
+        \brief Removes values which do not belong to the window ending at the given time,
+            i.e. values with timestamp less than or equal to (now - duration).
+        \param now - current time, must not precede timestamp of the previously added value
+     */
+    void expire(Timestamp now);
+
+    /**
+        \brief Calculates median of values currently retained in the window.
+            NOTE: Median of empty set is NAN.
+
+        \return median value
+     */
+    double calculate() const noexcept;
+
+    /**
+        \brief Calculates median of values belonging to the window ending at the given time.
+        \param now - current time, must not precede timestamp of the previously added value
+        \return median value
+     */
+    double calculate(Timestamp now);
+
+    /**
+        \brief Reset internal state, so median will be calculated from scratch starting with the
+            nearest added new value.
+     */
+    void reset() noexcept;
+
+    /// \brief Returns number of values currently retained in the window.
+    std::size_t size() const noexcept;
+
+    /// \brief Returns length of the window.
+    Timestamp duration() const noexcept;
+
+private:
+    using handle_type = typename IndexedMaxHeap<T>::handle_type;
+
+    void insert(handle_type handle, T value);
+    void balance();
+    void rebuild(std::size_t expired);
+    void compact();
+
+    IndexedMaxHeap<T> lowerHalf_;
+    IndexedMinHeap<T> upperHalf_;
+
+    // FIFO queue of retained values, valid elements start at head_
+    details::HeapStorage<T> values_;
+    details::HeapStorage<Timestamp> timestamps_;
+    details::HeapStorage<handle_type> handles_;
+    std::size_t head_;
+
+    // buffers of rebuild(), kept to avoid allocations
+    details::HeapStorage<T> scratchValues_;
+    details::HeapStorage<handle_type> scratchHandles_;
+
+    // handles released by expired values, reused by the new ones
+    details::HeapStorage<handle_type> freeHandles_;
+    handle_type nextHandle_;
+
+    Timestamp duration_;
+};
+
+template <typename T>
+TimeWindowMedianCalculator<T>::TimeWindowMedianCalculator(Timestamp duration)
+    : head_{0}, nextHandle_{0}, duration_{duration}
+{
+    assert(duration_ > 0);
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::add(T value, Timestamp timestamp)
+{
+    assert(size() == 0 or timestamps_.back() <= timestamp);
+    expire(timestamp);
+
+    handle_type handle;
+    if (freeHandles_.empty())
+    {
+        handle = nextHandle_++;
+    }
+    else
+    {
+        handle = freeHandles_.back();
+        freeHandles_.pop_back();
+    }
+    values_.push_back(value);
+    timestamps_.push_back(timestamp);
+    handles_.push_back(handle);
+    insert(handle, value);
+    balance();
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::expire(Timestamp now)
+{
+    const auto retained = size();
+    if (retained == 0)
+    {
+        return;
+    }
+    if (now < LLONG_MIN + duration_)
+    {
+        // the window reaches before the earliest representable timestamp, nothing expires
+        return;
+    }
+    const auto horizon = now - duration_;
+    if (timestamps_.back() <= horizon)
+    {
+        // everything expired, e.g. after a quiet period
+        reset();
+        return;
+    }
+
+    // binary search of the first value which is still within the window
+    auto first = head_;
+    auto last = timestamps_.size();
+    while (first < last)
+    {
+        const auto middle = first + (last - first) / 2;
+        if (timestamps_[middle] <= horizon)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    const auto expired = first - head_;
+    if (expired == 0)
+    {
+        return;
+    }
+
+    if (expired > retained - expired)
+    {
+        rebuild(expired);
+        return;
+    }
+    for (auto i = head_; i < first; i++)
+    {
+        const auto handle = handles_[i];
+        if (lowerHalf_.contains(handle))
+        {
+            lowerHalf_.erase(handle);
+        }
+        else
+        {
+            upperHalf_.erase(handle);
+        }
+        freeHandles_.push_back(handle);
+    }
+    head_ = first;
+    balance();
+    compact();
+}
+
+template <typename T>
+double TimeWindowMedianCalculator<T>::calculate() const noexcept
+{
+    if (lowerHalf_.empty() and upperHalf_.empty())
+    {
+        return NAN;
+    }
+    if (lowerHalf_.size() == upperHalf_.size())
+    {
+        return (static_cast<double>(lowerHalf_.top()) + upperHalf_.top()) / 2;
+    }
+    if (lowerHalf_.size() > upperHalf_.size())
+    {
+        return lowerHalf_.top();
+    }
+    return upperHalf_.top();
+}
+
+template <typename T>
+double TimeWindowMedianCalculator<T>::calculate(Timestamp now)
+{
+    expire(now);
+    return calculate();
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::reset() noexcept
+{
+    lowerHalf_.clear();
+    upperHalf_.clear();
+    values_.clear();
+    timestamps_.clear();
+    handles_.clear();
+    head_ = 0;
+    freeHandles_.clear();
+    nextHandle_ = 0;
+}
+
+template <typename T>
+std::size_t TimeWindowMedianCalculator<T>::size() const noexcept
+{
+    return timestamps_.size() - head_;
+}
+
+template <typename T>
+Timestamp TimeWindowMedianCalculator<T>::duration() const noexcept
+{
+    return duration_;
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::insert(handle_type handle, T value)
+{
+    if (lowerHalf_.empty() or (value < lowerHalf_.top()))
+    {
+        lowerHalf_.insert(handle, value);
+    }
+    else
+    {
+        upperHalf_.insert(handle, value);
+    }
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::balance()
+{
+    // batch expiration may remove many values from a single half
+    while (lowerHalf_.size() >= upperHalf_.size() + 2)
+    {
+        upperHalf_.insert(lowerHalf_.topHandle(), lowerHalf_.top());
+        lowerHalf_.pop();
+    }
+    while (upperHalf_.size() >= lowerHalf_.size() + 2)
+    {
+        lowerHalf_.insert(upperHalf_.topHandle(), upperHalf_.top());
+        upperHalf_.pop();
+    }
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::rebuild(std::size_t expired)
+{
+    lowerHalf_.clear();
+    upperHalf_.clear();
+    freeHandles_.clear();
+
+    head_ += expired;
+    compact();
+    assert(head_ == 0);
+
+    // surviving values get consecutive handles starting from 0
+    const auto count = values_.size();
+    nextHandle_ = count;
+    if (count == 0)
+    {
+        return;
+    }
+    scratchValues_.resize(count);
+    scratchHandles_.resize(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        handles_[i] = i;
+        scratchValues_[i] = values_[i];
+    }
+    // the lower half takes the smaller ceil(m/2) values, ties with the pivot go to the lower half first
+    const auto lowerSize = (count + 1) / 2;
+    auto* pivot = scratchValues_.data() + lowerSize - 1;
+    details::selectNth(scratchValues_.data(), pivot, scratchValues_.data() + count);
+    const auto middle = *pivot;
+    std::size_t equal = lowerSize;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        equal -= values_[i] < middle ? 1 : 0;
+    }
+    std::size_t lower = 0;
+    auto upper = count;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const auto value = values_[i];
+        auto toLower = value < middle;
+        if (not toLower and not(middle < value) and equal > 0)
+        {
+            toLower = true;
+            --equal;
+        }
+        const auto position = toLower ? lower++ : --upper;
+        scratchValues_[position] = value;
+        scratchHandles_[position] = i;
+    }
+    assert(lower == lowerSize and upper == lowerSize);
+    lowerHalf_.assign(scratchHandles_.data(), scratchValues_.data(), lowerSize);
+    upperHalf_.assign(scratchHandles_.data() + lowerSize, scratchValues_.data() + lowerSize, count - lowerSize);
+}
+
+template <typename T>
+void TimeWindowMedianCalculator<T>::compact()
+{
+    // Moving retained values to the front once the expired prefix outgrows them keeps
+    // the queue bounded by twice the window population at amortized O(1) per value.
+    const auto retained = size();
+    if (head_ == 0 or head_ < retained)
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < retained; i++)
+    {
+        values_[i] = values_[head_ + i];
+        timestamps_[i] = timestamps_[head_ + i];
+        handles_[i] = handles_[head_ + i];
+    }
+    for (std::size_t i = 0; i < head_; i++)
+    {
+        values_.pop_back();
+        timestamps_.pop_back();
+        handles_.pop_back();
+    }
+    head_ = 0;
+}
+
+} // namespace tplx
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace tplx
+{
+
+/// \brief Point in time expressed in arbitrary but monotonic units (e.g. milliseconds since epoch).
+using Timestamp = long long;
+
+} // namespace tplx
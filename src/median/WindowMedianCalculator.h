@@ -0,0 +1,181 @@
+#pragma once
+
+#include "IndexedHeap.h"
+#include <cmath>
+#include <cassert>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates median of the most recently added values limited to the fixed size window.
+
+        Values are kept in two indexed heaps (lower and upper half) in which handle of each element is
+        its slot in the window. Once the window is full every new value evicts the oldest one which costs
+        O(log n) regardless of the stream length, and memory usage stays at the window size.
+ */
+template <typename T>
+class WindowMedianCalculator
+{
+public:
+    /**
+        \brief Constructs calculator of the median of the last \a windowSize values.
+        \throws std::bad_alloc if there is not enough memory available
+        \param windowSize - maximum number of values taken into account, must be greater than 0
+     */
+    explicit WindowMedianCalculator(std::size_t windowSize);
+
+    /**
+        \brief Adds a new value to the window evicting the oldest one if the window is already full.
+        \param value - value to add.
+     */
+    void add(T value);
+
+    /**
+        \brief Calculates median of values currently present in the window.
+            NOTE: Median of empty set is NAN.
+
+        \return median value
+     */
+    double calculate() const noexcept;
+
+    /**
+        \brief Reset internal state, so median will be calculated from scratch starting with the
+            nearest added new value.
+     */
+    void reset() noexcept;
+
+    /// \brief Returns number of values currently present in the window.
+    std::size_t size() const noexcept;
+
+    /// \brief Returns maximum number of values taken into account.
+    std::size_t windowSize() const noexcept;
+
+private:
+    using handle_type = typename IndexedMaxHeap<T>::handle_type;
+
+    void balance();
+
+    IndexedMaxHeap<T> lowerHalf_;
+    IndexedMinHeap<T> upperHalf_;
+    std::size_t windowSize_;
+    std::size_t count_;
+    handle_type oldest_;
+};
+
+template <typename T>
+WindowMedianCalculator<T>::WindowMedianCalculator(std::size_t windowSize)
+    : windowSize_{windowSize}, count_{0}, oldest_{0}
+{
+    assert(windowSize_ > 0);
+    // balancing may temporarily make one half bigger by one element than the other one
+    lowerHalf_.reserve(windowSize_ / 2 + 2, windowSize_);
+    upperHalf_.reserve(windowSize_ / 2 + 2, windowSize_);
+}
+
+template <typename T>
+double WindowMedianCalculator<T>::calculate() const noexcept
+{
+    if (lowerHalf_.empty() and upperHalf_.empty())
+    {
+        return NAN;
+    }
+    if (lowerHalf_.size() == upperHalf_.size())
+    {
+        return (static_cast<double>(lowerHalf_.top()) + upperHalf_.top()) / 2;
+    }
+    if (lowerHalf_.size() > upperHalf_.size())
+    {
+        return lowerHalf_.top();
+    }
+    return upperHalf_.top();
+}
+
+template <typename T>
+void WindowMedianCalculator<T>::add(T value)
+{
+    if (count_ < windowSize_)
+    {
+        const auto handle = count_++;
+        if (lowerHalf_.empty() or (value < lowerHalf_.top()))
+        {
+            lowerHalf_.insert(handle, value);
+        }
+        else
+        {
+            upperHalf_.insert(handle, value);
+        }
+        balance();
+        return;
+    }
+
+    const auto handle = oldest_;
+    oldest_ = (oldest_ + 1) == windowSize_ ? 0 : oldest_ + 1;
+
+    // The slot of the evicted value is reused by the new one. If the new value belongs to the same half
+    // the evicted one has been taken from, updating it in place keeps halves equal in size.
+    if (lowerHalf_.contains(handle))
+    {
+        if (upperHalf_.empty() or not(upperHalf_.top() < value))
+        {
+            lowerHalf_.update(handle, value);
+            return;
+        }
+        lowerHalf_.erase(handle);
+        upperHalf_.insert(handle, value);
+    }
+    else
+    {
+        assert(upperHalf_.contains(handle));
+        if (lowerHalf_.empty() or not(value < lowerHalf_.top()))
+        {
+            upperHalf_.update(handle, value);
+            return;
+        }
+        upperHalf_.erase(handle);
+        lowerHalf_.insert(handle, value);
+    }
+    balance();
+}
+
+template <typename T>
+void WindowMedianCalculator<T>::balance()
+{
+    // Halves differ by at most three elements here (eviction from one half followed by insertion
+    // to the other one), so moving a single element is enough to make them differ by at most one.
+    if (lowerHalf_.size() >= upperHalf_.size() + 2)
+    {
+        upperHalf_.insert(lowerHalf_.topHandle(), lowerHalf_.top());
+        lowerHalf_.pop();
+    }
+    else if (upperHalf_.size() >= lowerHalf_.size() + 2)
+    {
+        lowerHalf_.insert(upperHalf_.topHandle(), upperHalf_.top());
+        upperHalf_.pop();
+    }
+    assert(lowerHalf_.size() <= upperHalf_.size() + 1);
+    assert(upperHalf_.size() <= lowerHalf_.size() + 1);
+}
+
+template <typename T>
+void WindowMedianCalculator<T>::reset() noexcept
+{
+    lowerHalf_.clear();
+    upperHalf_.clear();
+    count_ = 0;
+    oldest_ = 0;
+}
+
+template <typename T>
+std::size_t WindowMedianCalculator<T>::size() const noexcept
+{
+    return count_;
+}
+
+template <typename T>
+std::size_t WindowMedianCalculator<T>::windowSize() const noexcept
+{
+    return windowSize_;
+}
+
+} // namespace tplx
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DoubleFormatter.h"
+#include <cstddef>
+#include <ostream>
+
+namespace tplx
+{
+
+/**
+    \brief Collects formatted output in a fixed buffer and passes it to the stream in big chunks.
+        Doubles are formatted by formatDouble, so the output is identical to writing them to the stream
+        directly, but without locale-aware formatting and stream call per value. No memory is allocated.
+        Buffered output is flushed once the buffer gets full, on flush() and upon destruction.
+ */
+class BufferedWriter
+{
+public:
+    /// \brief Size of the internal buffer.
+    static constexpr std::size_t capacity = 64 * 1024;
+
+    explicit BufferedWriter(std::ostream& out) noexcept : out_{out}, size_{0}
+    {
+    }
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+    ~BufferedWriter()
+    {
+        flush();
+    }
+
+    /// \brief Writes the value formatted as std::ostream with default flags would do.
+    void write(double value)
+    {
+        reserve(max_formatted_double_length);
+        size_ = static_cast<std::size_t>(formatDouble(value, buffer_ + size_) - buffer_);
+    }
+
+    /// \brief Writes single character.
+    void write(char ch)
+    {
+        reserve(1);
+        buffer_[size_++] = ch;
+    }
+
+    /// \brief Passes buffered output to the stream.
+    void flush()
+    {
+        if (size_ > 0)
+        {
+            out_.write(buffer_, static_cast<std::streamsize>(size_));
+            size_ = 0;
+        }
+    }
+
+private:
+    void reserve(std::size_t count)
+    {
+        if (capacity - size_ < count)
+        {
+            flush();
+        }
+    }
+
+    std::ostream& out_;
+    char buffer_[capacity];
+    std::size_t size_;
+};
+
+} // namespace tplx
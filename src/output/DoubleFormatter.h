@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+namespace tplx
+{
+
+/// \brief Maximum number of characters written by formatDouble (e.g. "-1.79769e+308").
+constexpr std::size_t max_formatted_double_length = 16;
+
+namespace details
+{
+
+/// \brief Writes decimal digits of the value, returns pointer past the last written character.
+inline char* formatInteger(unsigned long long value, char* out) noexcept
+{
+    char digits[20];
+    std::size_t count = 0;
+    do
+    {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count > 0)
+    {
+        *out++ = digits[--count];
+    }
+    return out;
+}
+
+/**
+    \brief Formats non-negative multiple of 0.5 given as its doubled value, as "%g" does.
+        The value is rounded to 6 significant digits, ties are rounded to even, as glibc does.
+ */
+inline char* formatHalves(unsigned long long doubled, char* out) noexcept
+{
+    constexpr unsigned long long significant = 1000000; // 10^6, i.e. default precision
+    const auto integral = doubled / 2;
+    const bool half = doubled % 2 != 0;
+    if (integral < significant / 10 or (integral < significant and not half))
+    {
+        out = formatInteger(integral, out);
+        if (half)
+        {
+            *out++ = '.';
+            *out++ = '5';
+        }
+        return out;
+    }
+
+    // the value has at least 6 integral digits, the ones beyond the 6th one are rounded
+    int exponent = 5;
+    unsigned long long scale = 1;
+    while (integral / scale >= significant)
+    {
+        scale *= 10;
+        ++exponent;
+    }
+    auto mantissa = integral / scale;
+    const auto remainder = doubled - mantissa * scale * 2; // expressed in halves, scale/2 is a tie
+    if (remainder > scale or (remainder == scale and mantissa % 2 != 0))
+    {
+        ++mantissa;
+    }
+    if (mantissa == significant)
+    {
+        mantissa /= 10;
+        ++exponent;
+    }
+    if (exponent < 6)
+    {
+        return formatInteger(mantissa, out);
+    }
+
+    // exponent notation with trailing zeros removed, e.g. 1.23457e+09
+    while (mantissa % 10 == 0)
+    {
+        mantissa /= 10;
+    }
+    char digits[8] = {};
+    const auto end = formatInteger(mantissa, digits);
+    *out++ = digits[0];
+    if (end - digits > 1)
+    {
+        *out++ = '.';
+        for (auto digit = digits + 1; digit != end; ++digit)
+        {
+            *out++ = *digit;
+        }
+    }
+    *out++ = 'e';
+    *out++ = '+';
+    if (exponent < 10)
+    {
+        *out++ = '0';
+    }
+    return formatInteger(static_cast<unsigned long long>(exponent), out);
+}
+
+} // namespace details
+
+/**
+    \brief Formats the value exactly as std::ostream with default flags and precision does
+        (i.e. as printf "%g" with 6 significant digits in the "C" locale).
+
+        Medians of integral values are multiples of 0.5, such values (up to 2^52) are formatted directly
+        using integer arithmetic. Any other value is formatted by snprintf.
+    \param value - value to format
+    \param out - destination buffer of at least max_formatted_double_length characters
+    \return pointer past the last written character
+ */
+inline char* formatDouble(double value, char* out) noexcept
+{
+    const auto doubled = std::fabs(value) * 2;
+    if (doubled < 9007199254740992.0 and doubled == std::floor(doubled))
+    {
+        if (std::signbit(value))
+        {
+            *out++ = '-';
+        }
+        return details::formatHalves(static_cast<unsigned long long>(doubled), out);
+    }
+    const auto length = std::snprintf(out, max_formatted_double_length, "%g", value);
+    return out + length;
+}
+
+} // namespace tplx
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "SpscQueue.h"
+#include "events/Event.h"
+#include "events/EventListener.h"
+#include "median/KeyedMedianEngine.h"
+#include "output/BufferedWriter.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <thread>
+
+namespace tplx
+{
+
+/**
+    \brief Calculates running medians of many streams using several worker threads.
+
+        The pipeline is an EventListener fed by the event loop running in the caller's thread (the parser).
+        Each stream is assigned to one of the shards by its identifier, every shard is served by a worker
+        thread owning calculators of its streams (KeyedMedianEngine) and receives events of its streams
+        through a lock-free single producer single consumer queue. Workers push calculated medians to their
+        own result queues.
+
+        Results are written in input order by a dedicated writer thread: for each median request the parser
+        records the shard which is going to answer it, so the writer takes the next result from that shard's
+        result queue. Results of a single shard are produced in input order, so no reordering is needed.
+
+        Events of a single stream are always processed by a single worker, so throughput scales with the
+        number of workers as long as the input contains many streams.
+ */
+template <typename T>
+class ShardedMedianPipeline : public EventListener<T>
+{
+public:
+    /// \brief Default capacity of the queues (in events) between the parser and each worker.
+    static constexpr std::size_t default_queue_capacity = 64 * 1024;
+
+    /**
+        \brief Starts the worker threads and the writer thread.
+        \param out - stream the results are written to
+        \param workers - number of worker threads (shards), must be positive
+        \param queueCapacity - capacity of each queue
+     */
+    ShardedMedianPipeline(std::ostream& out, std::size_t workers, std::size_t queueCapacity = default_queue_capacity);
+
+    ShardedMedianPipeline(const ShardedMedianPipeline&) = delete;
+    ShardedMedianPipeline& operator=(const ShardedMedianPipeline&) = delete;
+
+    /// \brief Waits until all received events are processed (see finish()).
+    ~ShardedMedianPipeline();
+
+    bool newEvent(Event<T>&& event) override;
+    bool newEvents(const Event<T>* events, std::size_t count) override;
+
+    /**
+        \brief Waits until all received events are processed and all results are written to the stream.
+            No event may be passed to the pipeline afterwards.
+     */
+    void finish();
+
+    /// \brief Returns number of the shard processing events of the given stream.
+    std::size_t shardOf(StreamId stream) const noexcept;
+
+private:
+    struct Shard
+    {
+        explicit Shard(std::size_t queueCapacity) : events{queueCapacity}, results{queueCapacity}
+        {
+        }
+
+        SpscQueue<Event<T>> events;
+        SpscQueue<double> results;
+        KeyedMedianEngine<StreamId, T> calculators;
+        std::thread worker;
+    };
+
+    void dispatch(const Event<T>& event);
+    void runWorker(Shard& shard);
+    void runWriter();
+
+    std::ostream& out_;
+    std::unique_ptr<std::unique_ptr<Shard>[]> shards_;
+    std::size_t shardsCount_;
+    SpscQueue<std::uint32_t> order_;
+    std::atomic<bool> closed_;
+    std::thread writer_;
+};
+
+// -------------------------------------------------------------------------- //
+
+template <typename T>
+constexpr std::size_t ShardedMedianPipeline<T>::default_queue_capacity;
+
+template <typename T>
+ShardedMedianPipeline<T>::ShardedMedianPipeline(std::ostream& out, std::size_t workers, std::size_t queueCapacity)
+    : out_{out}, shards_{new std::unique_ptr<Shard>[workers]}, shardsCount_{workers}, order_{queueCapacity},
+      closed_{false}
+{
+    assert(workers > 0);
+    for (std::size_t i = 0; i < workers; i++)
+    {
+        shards_[i].reset(new Shard{queueCapacity});
+    }
+    for (std::size_t i = 0; i < workers; i++)
+    {
+        auto& current = *shards_[i];
+        current.worker = std::thread{[this, &current] { runWorker(current); }};
+    }
+    writer_ = std::thread{[this] { runWriter(); }};
+}
+
+template <typename T>
+ShardedMedianPipeline<T>::~ShardedMedianPipeline()
+{
+    finish();
+}
+
+template <typename T>
+bool ShardedMedianPipeline<T>::newEvent(Event<T>&& event)
+{
+    dispatch(event);
+    return true;
+}
+
+template <typename T>
+bool ShardedMedianPipeline<T>::newEvents(const Event<T>* events, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        dispatch(events[i]);
+    }
+    return true;
+}
+
+template <typename T>
+void ShardedMedianPipeline<T>::finish()
+{
+    if (closed_.exchange(true))
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < shardsCount_; i++)
+    {
+        shards_[i]->worker.join();
+    }
+    writer_.join();
+}
+
+template <typename T>
+std::size_t ShardedMedianPipeline<T>::shardOf(StreamId stream) const noexcept
+{
+    // multiplicative hashing spreads consecutive identifiers, multiply-shift maps the hash to the shard number
+    const std::uint64_t hash = static_cast<std::uint32_t>(stream * 2654435761U);
+    return static_cast<std::size_t>((hash * shardsCount_) >> 32);
+}
+
+template <typename T>
+void ShardedMedianPipeline<T>::dispatch(const Event<T>& event)
+{
+    const auto shard = shardOf(event.stream);
+    // the request is recorded only after the event is queued, so the writer never waits for an event
+    // which has not been passed to the worker yet
+    shards_[shard]->events.push(event);
+    if (event.type == EventType::calculate_median)
+    {
+        order_.push(static_cast<std::uint32_t>(shard));
+    }
+}
+
+template <typename T>
+void ShardedMedianPipeline<T>::runWorker(Shard& shard)
+{
+    Event<T> event;
+    Backoff backoff;
+    while (true)
+    {
+        if (not shard.events.tryPop(event))
+        {
+            if (not closed_.load(std::memory_order_acquire))
+            {
+                backoff.wait();
+                continue;
+            }
+            // events queued before closing are visible once the flag is observed
+            if (not shard.events.tryPop(event))
+            {
+                return;
+            }
+        }
+        backoff.reset();
+        switch (event.type)
+        {
+        case EventType::new_value:
+            shard.calculators.add(event.stream, event.value);
+            break;
+        case EventType::calculate_median:
+            shard.results.push(shard.calculators.calculate(event.stream));
+            break;
+        case EventType::sequence_end:
+            shard.calculators.reset(event.stream);
+            break;
+        }
+    }
+}
+
+template <typename T>
+void ShardedMedianPipeline<T>::runWriter()
+{
+    BufferedWriter writer{out_};
+    std::uint32_t shard;
+    Backoff backoff;
+    while (true)
+    {
+        if (not order_.tryPop(shard))
+        {
+            if (not closed_.load(std::memory_order_acquire))
+            {
+                backoff.wait();
+                continue;
+            }
+            if (not order_.tryPop(shard))
+            {
+                return;
+            }
+        }
+        backoff.reset();
+        writer.write(shards_[shard]->results.pop());
+        writer.write(' ');
+    }
+}
+
+} // namespace tplx
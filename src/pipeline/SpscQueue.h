@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace tplx
+{
+
+/**
+    \brief Waiting strategy of threads polling queues: the processor is yielded for a bounded number of rounds
+        (short waits of a busy pipeline), then the thread sleeps for exponentially growing periods up to
+        \a max_sleep_microseconds, so threads waiting for slow (e.g. interactive) input do not keep cores busy.
+ */
+class Backoff
+{
+public:
+    static constexpr unsigned spin_rounds = 1024;
+    static constexpr unsigned max_sleep_microseconds = 1000;
+
+    /// \brief Waits a little longer than the previous call did (since the last reset()).
+    void wait() noexcept
+    {
+        if (rounds_ < spin_rounds)
+        {
+            ++rounds_;
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds{sleep_});
+        sleep_ = sleep_ * 2 < max_sleep_microseconds ? sleep_ * 2 : max_sleep_microseconds;
+    }
+
+    /// \brief Restarts spinning once the awaited condition is met.
+    void reset() noexcept
+    {
+        rounds_ = 0;
+        sleep_ = 1;
+    }
+
+private:
+    unsigned rounds_ = 0;
+    unsigned sleep_ = 1;
+};
+
+/**
+    \brief Bounded lock-free queue passing items from a single producer thread to a single consumer thread.
+
+        Items are kept in a ring buffer of power of two capacity. The producer owns the tail index,
+        the consumer owns the head index, each of them publishes its index with release semantics and keeps
+        a cached copy of the other one, so the shared cache line is touched only when the cached copy
+        suggests the queue is full (producer) or empty (consumer). Both sides are kept on separate cache lines.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    /**
+        \brief Constructs queue able to hold at least \a capacity items.
+        \throws std::bad_alloc if there is not enough memory available
+     */
+    explicit SpscQueue(std::size_t capacity);
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    ~SpscQueue();
+
+    /**
+        \brief Appends the item unless the queue is full. To be called by the producer only.
+        \return \a true if the item was appended
+     */
+    bool tryPush(const T& item) noexcept;
+
+    /**
+        \brief Appends the item, waits (see Backoff) as long as the queue is full. To be called by the producer only.
+     */
+    void push(const T& item) noexcept;
+
+    /**
+        \brief Removes the oldest item unless the queue is empty. To be called by the consumer only.
+        \return \a true if the item was removed and stored in \a item
+     */
+    bool tryPop(T& item) noexcept;
+
+    /**
+        \brief Removes the oldest item, waits (see Backoff) as long as the queue is empty.
+            To be called by the consumer only.
+     */
+    T pop() noexcept;
+
+    /// \brief Returns capacity of the queue.
+    std::size_t capacity() const noexcept;
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+
+    /// \brief Index owned by one side of the queue and cached copy of the index owned by the other side.
+    struct Side
+    {
+        // separates the side from the preceding data, so they never share a cache line
+        char padding[cache_line_size];
+        std::atomic<std::size_t> index;
+        std::size_t cachedOther;
+    };
+
+    T* items_;
+    std::size_t mask_;
+    Side consumer_; // index of the oldest item
+    Side producer_; // index past the newest item
+};
+
+// -------------------------------------------------------------------------- //
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t capacity) : items_{nullptr}, mask_{0}
+{
+    consumer_.index.store(0, std::memory_order_relaxed);
+    consumer_.cachedOther = 0;
+    producer_.index.store(0, std::memory_order_relaxed);
+    producer_.cachedOther = 0;
+    std::size_t rounded = 2;
+    while (rounded < capacity)
+    {
+        rounded *= 2;
+    }
+    items_ = new T[rounded];
+    mask_ = rounded - 1;
+}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue()
+{
+    delete[] items_;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPush(const T& item) noexcept
+{
+    const auto tail = producer_.index.load(std::memory_order_relaxed);
+    if (tail - producer_.cachedOther > mask_)
+    {
+        producer_.cachedOther = consumer_.index.load(std::memory_order_acquire);
+        if (tail - producer_.cachedOther > mask_)
+        {
+            return false;
+        }
+    }
+    items_[tail & mask_] = item;
+    producer_.index.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+void SpscQueue<T>::push(const T& item) noexcept
+{
+    Backoff backoff;
+    while (not tryPush(item))
+    {
+        backoff.wait();
+    }
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPop(T& item) noexcept
+{
+    const auto head = consumer_.index.load(std::memory_order_relaxed);
+    if (head == consumer_.cachedOther)
+    {
+        consumer_.cachedOther = producer_.index.load(std::memory_order_acquire);
+        if (head == consumer_.cachedOther)
+        {
+            return false;
+        }
+    }
+    item = items_[head & mask_];
+    consumer_.index.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+T SpscQueue<T>::pop() noexcept
+{
+    T item;
+    Backoff backoff;
+    while (not tryPop(item))
+    {
+        backoff.wait();
+    }
+    return item;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::capacity() const noexcept
+{
+    return mask_ + 1;
+}
+
+} // namespace tplx
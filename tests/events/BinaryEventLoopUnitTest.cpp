@@ -0,0 +1,221 @@
+#include "events/BinaryEventLoop.h"
+#include "events/BufferedEventLoop.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+/// \brief Records received events, stops accepting them after the given number of events.
+class RecordingEventListener : public EventListener<int>
+{
+public:
+    explicit RecordingEventListener(std::size_t limit = std::numeric_limits<std::size_t>::max()) : limit_{limit} {}
+    bool newEvent(Event<int>&& event) override
+    {
+        events.push_back(event);
+        return events.size() < limit_;
+    }
+
+    std::vector<Event<int>> events;
+
+private:
+    std::size_t limit_;
+};
+
+MATCHER_P(SameEvents, expected, "")
+{
+    if(arg.size() != expected.size())
+    {
+        return false;
+    }
+    for(std::size_t i = 0; i < arg.size(); i++)
+    {
+        if(arg[i].type != expected[i].type or arg[i].value != expected[i].value or
+           arg[i].stream != expected[i].stream or arg[i].timestamp != expected[i].timestamp)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Event<int>> parseText(const std::string& input)
+{
+    RecordingEventListener listener;
+    runEventLoop(input.data(), input.data() + input.size(), listener);
+    return listener.events;
+}
+
+/// \brief Converts the text input to the binary format using blocks of the given size.
+std::string convert(const std::string& input, std::size_t blockSize)
+{
+    std::FILE* file = std::tmpfile();
+    {
+        BinaryEventWriter<int> writer{fileno(file), blockSize};
+        runEventLoop(input.data(), input.data() + input.size(), writer);
+        writer.flush();
+    }
+    std::string output(static_cast<std::size_t>(::lseek(fileno(file), 0, SEEK_END)), '\0');
+    ::pread(fileno(file), &output[0], output.size(), 0);
+    std::fclose(file);
+    return output;
+}
+
+/// \brief Runs the binary event loop reading the input through a pipe (not memory mapped).
+RecordingEventListener runPipe(const std::string& input, std::size_t limit = std::numeric_limits<std::size_t>::max())
+{
+    int fds[2];
+    EXPECT_EQ(0, ::pipe(fds));
+    EXPECT_EQ(static_cast<ssize_t>(input.size()), ::write(fds[1], input.data(), input.size()));
+    ::close(fds[1]);
+    RecordingEventListener listener{limit};
+    try
+    {
+        runBinaryEventLoop(fds[0], listener, 3);
+    }
+    catch(...)
+    {
+        ::close(fds[0]);
+        throw;
+    }
+    ::close(fds[0]);
+    return listener;
+}
+
+const std::string text_input{"3 5 m 8 7:4 m 7:m q 1000 m 2:q 12 13 14 m"};
+
+TEST(BinaryEventLoop, converted_input_gives_the_same_events)
+{
+    const auto expected = parseText(text_input);
+    for(std::size_t blockSize : {1, 2, 5, 4096})
+    {
+        const auto binary = convert(text_input, blockSize);
+
+        // std::string data is aligned for any fundamental type, so records are passed in place
+        RecordingEventListener inPlace;
+        runBinaryEventLoop(binary.data(), binary.data() + binary.size(), inPlace);
+        EXPECT_THAT(inPlace.events, SameEvents(expected)) << "block size " << blockSize;
+
+        EXPECT_THAT(runPipe(binary).events, SameEvents(expected)) << "block size " << blockSize;
+    }
+}
+
+TEST(BinaryEventLoop, misaligned_records_are_copied)
+{
+    const auto binary = convert(text_input, 4);
+    std::vector<char> shifted(binary.size() + 1);
+    std::memcpy(shifted.data() + 1, binary.data(), binary.size());
+    RecordingEventListener listener;
+    runBinaryEventLoop(shifted.data() + 1, shifted.data() + shifted.size(), listener);
+    EXPECT_THAT(listener.events, SameEvents(parseText(text_input)));
+}
+
+TEST(BinaryEventLoop, timestamps_are_preserved)
+{
+    std::FILE* file = std::tmpfile();
+    {
+        BinaryEventWriter<int> writer{fileno(file)};
+        writer.newEvent(Event<int>{7, 123456789LL});
+        writer.flush();
+    }
+    ::lseek(fileno(file), 0, SEEK_SET);
+    EXPECT_TRUE(isBinaryEventFile(fileno(file)));
+    RecordingEventListener listener;
+    runBinaryEventLoop(fileno(file), listener);
+    std::fclose(file);
+    ASSERT_EQ(1U, listener.events.size());
+    EXPECT_EQ(7, listener.events[0].value);
+    EXPECT_EQ(123456789LL, listener.events[0].timestamp);
+}
+
+TEST(BinaryEventLoop, text_file_is_not_recognized_as_binary)
+{
+    std::FILE* file = std::tmpfile();
+    std::fwrite(text_input.data(), 1, text_input.size(), file);
+    std::fflush(file);
+    ::lseek(fileno(file), 0, SEEK_SET);
+    EXPECT_FALSE(isBinaryEventFile(fileno(file)));
+    std::fclose(file);
+}
+
+TEST(BinaryEventLoop, listener_stops_the_loop)
+{
+    const auto binary = convert(text_input, 2);
+    RecordingEventListener listener{4};
+    runBinaryEventLoop(binary.data(), binary.data() + binary.size(), listener);
+    EXPECT_EQ(4U, listener.events.size()) << "the block the listener stopped in is not delivered further";
+    EXPECT_EQ(3U, runPipe(binary, 3).events.size());
+}
+
+TEST(BinaryEventLoop, malformed_input_is_rejected)
+{
+    const auto binary = convert(text_input, 4);
+    RecordingEventListener listener;
+    EXPECT_THROW(runBinaryEventLoop(text_input.data(), text_input.data() + text_input.size(), listener),
+                 std::invalid_argument);
+    EXPECT_THROW(runBinaryEventLoop(binary.data(), binary.data() + binary.size() - 1, listener),
+                 std::invalid_argument);
+    EXPECT_THROW(runBinaryEventLoop(binary.data(), binary.data() + sizeof(BinaryEventsHeader) + 1, listener),
+                 std::invalid_argument);
+    EXPECT_THROW(runPipe(binary.substr(0, binary.size() - 1)), std::invalid_argument);
+    EXPECT_THROW(runPipe(""), std::invalid_argument);
+
+    auto otherVersion = binary;
+    otherVersion[4] = 2;
+    EXPECT_THROW(runBinaryEventLoop(otherVersion.data(), otherVersion.data() + otherVersion.size(), listener),
+                 std::invalid_argument);
+
+    RecordingEventListener empty;
+    const auto header = binary.substr(0, sizeof(BinaryEventsHeader));
+    runBinaryEventLoop(header.data(), header.data() + header.size(), empty);
+    EXPECT_TRUE(empty.events.empty());
+    EXPECT_TRUE(runPipe(header).events.empty());
+}
+
+TEST(BinaryEventLoop, records_of_unknown_type_are_rejected)
+{
+    auto binary = convert(text_input, 4);
+    // type tag of the second record of the first block
+    const auto offset = sizeof(BinaryEventsHeader) + sizeof(BinaryBlockHeader) + sizeof(Event<int>) +
+                        offsetof(Event<int>, type);
+    const int unknown = 9;
+    std::memcpy(&binary[offset], &unknown, sizeof(unknown));
+
+    RecordingEventListener inPlace;
+    EXPECT_THROW(runBinaryEventLoop(binary.data(), binary.data() + binary.size(), inPlace), std::invalid_argument);
+    EXPECT_TRUE(inPlace.events.empty()) << "block holding the record is not delivered";
+
+    std::vector<char> shifted(binary.size() + 1);
+    std::memcpy(shifted.data() + 1, binary.data(), binary.size());
+    RecordingEventListener copied;
+    EXPECT_THROW(runBinaryEventLoop(shifted.data() + 1, shifted.data() + shifted.size(), copied),
+                 std::invalid_argument);
+    EXPECT_THROW(runPipe(binary), std::invalid_argument);
+}
+
+TEST(BinaryEventLoop, events_of_other_type_are_rejected)
+{
+    class LongListener : public EventListener<long long>
+    {
+    public:
+        bool newEvent(Event<long long>&&) override
+        {
+            return true;
+        }
+    } listener;
+    const auto binary = convert(text_input, 4);
+    EXPECT_THROW(runBinaryEventLoop(binary.data(), binary.data() + binary.size(), listener), std::invalid_argument);
+}
+
+} // anonymous namespace
@@ -0,0 +1,230 @@
+#include "events/BufferedEventLoop.h"
+#include "MockEventListener.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+/// \brief Records received events, stops accepting them after the given number of events.
+class RecordingEventListener : public EventListener<int>
+{
+public:
+    explicit RecordingEventListener(std::size_t limit = std::numeric_limits<std::size_t>::max()) : limit_{limit} {}
+    bool newEvent(Event<int>&& event) override
+    {
+        events.push_back(event);
+        return events.size() < limit_;
+    }
+
+    std::vector<Event<int>> events;
+    std::string error;
+
+private:
+    std::size_t limit_;
+};
+
+/// \brief Runs istream based event loop, which defines the expected behaviour.
+RecordingEventListener runReference(const std::string& input, std::size_t limit)
+{
+    RecordingEventListener listener{limit};
+    std::istringstream source{input};
+    try
+    {
+        runEventLoop(source, listener);
+    }
+    catch(std::invalid_argument& e)
+    {
+        listener.error = e.what();
+    }
+    return listener;
+}
+
+/// \brief Feeds the parser with blocks of the given size.
+RecordingEventListener runChunked(const std::string& input, std::size_t limit, std::size_t blockSize)
+{
+    RecordingEventListener listener{limit};
+    details::EventParser<int> parser{listener};
+    try
+    {
+        auto first = input.data();
+        const auto last = input.data() + input.size();
+        bool proceed = true;
+        while(proceed and first != last)
+        {
+            const auto next = first + std::min(blockSize, static_cast<std::size_t>(last - first));
+            proceed = parser.parse(first, next);
+            first = next;
+        }
+        if(proceed)
+        {
+            parser.finish();
+        }
+    }
+    catch(std::invalid_argument& e)
+    {
+        listener.error = e.what();
+    }
+    return listener;
+}
+
+TEST(BufferedEventLoop, empty_input)
+{
+    StrictMock<MockEventListener<int>> listener;
+    runEventLoop<int>(nullptr, nullptr, listener);
+}
+
+TEST(BufferedEventLoop, eol_input)
+{
+    const char input[] = "\n3";
+    StrictMock<MockEventListener<int>> listener;
+    runEventLoop(std::begin(input), std::end(input) - 1, listener);
+}
+
+TEST(BufferedEventLoop, valid_input)
+{
+    InSequence s;
+
+    const std::string input{"3 5 m 8 m q 1000 m"};
+    StrictMock<MockEventListener<int>> listener;
+    EXPECT_CALL(listener, newEvent(newValueEvent(3))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(5))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(8))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(seqEndEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(1000))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    runEventLoop(input.data(), input.data() + input.size(), listener);
+}
+
+TEST(BufferedEventLoop, out_of_range_number)
+{
+    NiceMock<MockEventListener<int>> listener;
+    const std::string input{"2147483648"};
+    EXPECT_THROW(runEventLoop(input.data(), input.data() + input.size(), listener), std::invalid_argument);
+}
+
+struct BufferedEventLoopTest : TestWithParam<const char*>
+{
+};
+
+TEST_P(BufferedEventLoopTest, behaves_like_istream_event_loop)
+{
+    const std::string input{GetParam()};
+    for(std::size_t limit : {std::size_t{1}, std::size_t{2}, std::size_t{3}, std::numeric_limits<std::size_t>::max()})
+    {
+        const auto expected = runReference(input, limit);
+        for(std::size_t blockSize = 1; blockSize <= input.size() + 1; blockSize++)
+        {
+            const auto actual = runChunked(input, limit, blockSize);
+            EXPECT_EQ(expected.error, actual.error) << '"' << input << "\" block size: " << blockSize;
+            EXPECT_EQ(expected.events, actual.events) << '"' << input << "\" block size: " << blockSize;
+        }
+    }
+}
+
+const char* inputs[] = {"",
+                        "\n",
+                        "3 5 m 8 m 6 m q 1000 m",
+                        "12345 m\n67 m",
+                        "987654321 123456789 m q m",
+                        "2147483647 m",
+                        "2147483648 m",
+                        "99999999999999999999",
+                        "1 2 3\r4",
+                        "1 ",
+                        " ",
+                        "1m",
+                        "o",
+                        "mm",
+                        "1  ",
+                        " 2",
+                        "1 02",
+                        "1 -2",
+                        "1.5",
+                        "q\tm",
+                        "7:3 7:5 7:m 8:4 8:m 7:q m",
+                        "3 12:5 m 12:m",
+                        "1:2:3",
+                        "1:",
+                        "1: 2",
+                        "1:\n",
+                        "1:x",
+                        "1:0",
+                        "m:1",
+                        ":1",
+                        "4294967295:1 m",
+                        "4294967296:1 m",
+                        "1:2147483648"};
+
+/// \brief Creates temporary file with the given content, which is removed once the test is done.
+class TemporaryFile
+{
+public:
+    explicit TemporaryFile(const std::string& content) : file_{std::tmpfile()}
+    {
+        std::fwrite(content.data(), 1, content.size(), file_);
+        std::fflush(file_);
+        std::rewind(file_);
+    }
+    ~TemporaryFile()
+    {
+        std::fclose(file_);
+    }
+    int descriptor() const
+    {
+        return fileno(file_);
+    }
+
+private:
+    std::FILE* file_;
+};
+
+TEST(BufferedEventLoop, reads_memory_mapped_file)
+{
+    InSequence s;
+
+    TemporaryFile file{"3 5 m 8 m"};
+    StrictMock<MockEventListener<int>> listener;
+    EXPECT_CALL(listener, newEvent(newValueEvent(3))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(5))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(8))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    runBufferedEventLoop(file.descriptor(), listener);
+}
+
+TEST(BufferedEventLoop, reads_pipe_in_blocks)
+{
+    InSequence s;
+
+    int descriptors[2];
+    ASSERT_EQ(0, ::pipe(descriptors));
+    const char input[] = "31 57 m 8 m";
+    ASSERT_EQ(static_cast<ssize_t>(std::strlen(input)), ::write(descriptors[1], input, std::strlen(input)));
+    ::close(descriptors[1]);
+
+    StrictMock<MockEventListener<int>> listener;
+    EXPECT_CALL(listener, newEvent(newValueEvent(31))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(57))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(8))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    runBufferedEventLoop(descriptors[0], listener, 2);
+    ::close(descriptors[0]);
+}
+
+} // anonymous namespace
+
+INSTANTIATE_TEST_CASE_P(BufferedEventLoopTestParametrized,
+                        BufferedEventLoopTest,
+                        ValuesIn(inputs));
@@ -1,83 +1,130 @@
 #include "events/EventLoop.h"
+#include "MockEventListener.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <limits>
 #include <sstream>
+#include <string>
+#include <vector>
 
-namespace tplx
+namespace
 {
 
-template<typename T>
-bool operator==(const Event<T>& lhs, const Event<T>& rhs)
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(EventLoop, empty_input)
 {
-    return lhs.value == rhs.value and lhs.type == rhs.type;
+    std::istringstream input;
+    StrictMock<MockEventListener<int>> listener;
+    runEventLoop(input, listener);
 }
 
-} // namespace tplx
+TEST(EventLoop, eol_input)
+{
+    std::istringstream input{"\n"};
+    StrictMock<MockEventListener<int>> listener;
+    runEventLoop(input, listener);
+}
 
-namespace
+TEST(EventLoop, valid_input)
 {
+    InSequence s;
 
-using namespace ::tplx;
-using namespace ::testing;
+    std::istringstream input{"3 5 m 8 m 6 m q 1000 m"};
+    StrictMock<MockEventListener<int>> listener;
+    EXPECT_CALL(listener, newEvent(newValueEvent(3))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(5))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(8))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(6))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(seqEndEvent(0))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(newValueEvent(1000))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
+    runEventLoop(input, listener);
+}
 
-template<typename T>
-class MockEventListener : public EventListener<T>
+/// \brief Listener receiving whole batches, stops after the given number of events.
+class BatchRecordingEventListener : public EventListener<int>
 {
 public:
-    bool newEvent(Event<T>&& e) override
+    explicit BatchRecordingEventListener(std::size_t limit) : limit_{limit} {}
+    bool newEvent(Event<int>&&) override
     {
-        return newEvent(e);
+        ADD_FAILURE() << "events are expected to be delivered in batches";
+        return false;
     }
-    MOCK_METHOD1_T(newEvent, bool(const Event<T>&));
+    bool newEvents(const Event<int>* events, std::size_t count) override
+    {
+        batchSizes.push_back(count);
+        received += count;
+        lastValue = events[count - 1].value;
+        return received < limit_;
+    }
+
+    std::vector<std::size_t> batchSizes;
+    std::size_t received = 0;
+    int lastValue = 0;
+
+private:
+    std::size_t limit_;
 };
 
-template<typename T>
-Event<T> newValueEvent(T value)
+std::string generateValues(std::size_t count)
 {
-    return Event<T>(value);
+    std::string input;
+    for(std::size_t i = 1; i <= count; i++)
+    {
+        input += std::to_string(i) + ' ';
+    }
+    return input;
 }
 
-template<typename T>
-Event<T> calcMedianEvent(T)
+TEST(EventLoop, events_are_delivered_in_batches)
 {
-    return Event<T>(EventType::calculate_median);
+    std::istringstream input{generateValues(default_event_batch_size * 2 + 10)};
+    BatchRecordingEventListener listener{std::numeric_limits<std::size_t>::max()};
+    runEventLoop(input, listener);
+    EXPECT_THAT(listener.batchSizes, ElementsAre(default_event_batch_size, default_event_batch_size, 10U));
+    EXPECT_EQ(static_cast<int>(default_event_batch_size * 2 + 10), listener.lastValue);
 }
 
-template<typename T>
-Event<T> seqEndEvent(T)
+TEST(EventLoop, listener_stops_processing_after_the_batch)
 {
-    return Event<T>(EventType::sequence_end);
+    std::istringstream input{generateValues(default_event_batch_size * 3)};
+    BatchRecordingEventListener listener{default_event_batch_size};
+    runEventLoop(input, listener);
+    EXPECT_THAT(listener.batchSizes, ElementsAre(default_event_batch_size));
 }
 
-TEST(EventLoop, empty_input)
+TEST(EventLoop, events_preceding_malformed_input_are_delivered)
 {
-    std::istringstream input;
+    std::istringstream input{"1 2 3 m x"};
     StrictMock<MockEventListener<int>> listener;
-    runEventLoop(input, listener);
+    EXPECT_CALL(listener, newEvent(_)).Times(4).WillRepeatedly(Return(true));
+    EXPECT_THROW(runEventLoop(input, listener), std::invalid_argument);
 }
 
-TEST(EventLoop, eol_input)
+TEST(EventLoop, malformed_input_following_last_processed_event_is_ignored)
 {
-    std::istringstream input{"\n"};
+    std::istringstream input{"1 2 3 m x"};
     StrictMock<MockEventListener<int>> listener;
-    runEventLoop(input, listener);
+    EXPECT_CALL(listener, newEvent(_)).WillOnce(Return(true)).WillOnce(Return(false));
+    EXPECT_NO_THROW(runEventLoop(input, listener));
 }
 
-TEST(EventLoop, valid_input)
+TEST(EventLoop, events_of_identified_streams)
 {
     InSequence s;
 
-    std::istringstream input{"3 5 m 8 m 6 m q 1000 m"};
+    std::istringstream input{"3 12:5 12:m 7:q m"};
     StrictMock<MockEventListener<int>> listener;
     EXPECT_CALL(listener, newEvent(newValueEvent(3))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(newValueEvent(5))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(newValueEvent(8))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(newValueEvent(6))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(seqEndEvent(0))).WillOnce(Return(true));
-    EXPECT_CALL(listener, newEvent(newValueEvent(1000))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(inStream(newValueEvent(5), 12))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(inStream(calcMedianEvent(0), 12))).WillOnce(Return(true));
+    EXPECT_CALL(listener, newEvent(inStream(seqEndEvent(0), 7))).WillOnce(Return(true));
     EXPECT_CALL(listener, newEvent(calcMedianEvent(0))).WillOnce(Return(true));
     runEventLoop(input, listener);
 }
@@ -94,10 +141,10 @@ TEST_P(EventLoopTest, invalid_input)
     EXPECT_THROW(runEventLoop(input, listener), std::invalid_argument) << GetParam();
 }
 
-const char* invalid_inputs[] = {" ", "1m", "o", "mm", "1  ", " 2"};
+const char* invalid_inputs[] = {" ", "1m", "o", "mm", "1  ", " 2", "1:", "1:2:3", "1: 2", "m:1", "4294967296:1"};
 
 } // anonymous namespace
 
 INSTANTIATE_TEST_CASE_P(EventLoopTestParametrized,
                         EventLoopTest,
-                        ValuesIn(invalid_inputs),);
+                        ValuesIn(invalid_inputs));
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "events/Event.h"
+#include "events/EventListener.h"
+#include <gmock/gmock.h>
+
+namespace tplx
+{
+
+template<typename T>
+bool operator==(const Event<T>& lhs, const Event<T>& rhs)
+{
+    return lhs.value == rhs.value and lhs.type == rhs.type and lhs.stream == rhs.stream;
+}
+
+template<typename T>
+class MockEventListener : public EventListener<T>
+{
+public:
+    bool newEvent(Event<T>&& e) override
+    {
+        return newEvent(e);
+    }
+    MOCK_METHOD1_T(newEvent, bool(const Event<T>&));
+};
+
+template<typename T>
+Event<T> newValueEvent(T value)
+{
+    return Event<T>(value);
+}
+
+template<typename T>
+Event<T> calcMedianEvent(T)
+{
+    return Event<T>(EventType::calculate_median);
+}
+
+template<typename T>
+Event<T> seqEndEvent(T)
+{
+    return Event<T>(EventType::sequence_end);
+}
+
+template<typename T>
+Event<T> inStream(Event<T> event, StreamId stream)
+{
+    event.stream = stream;
+    return event;
+}
+
+} // namespace tplx
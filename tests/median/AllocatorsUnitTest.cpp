@@ -0,0 +1,133 @@
+#include "median/Allocators.h"
+#include "median/HeapStorage.h"
+#include "median/MedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+
+namespace
+{
+
+using namespace ::testing;
+using namespace ::tplx;
+
+bool isAligned(const void* memory)
+{
+    return reinterpret_cast<std::uintptr_t>(memory) % alignof(std::max_align_t) == 0;
+}
+
+TEST(MonotonicArena, allocates_aligned_blocks_from_slabs)
+{
+    MonotonicArena arena{256};
+    auto first = static_cast<char*>(arena.allocate(10));
+    auto second = static_cast<char*>(arena.allocate(20));
+    EXPECT_TRUE(isAligned(first));
+    EXPECT_TRUE(isAligned(second));
+    EXPECT_GE(second - first, 10);
+    // bigger than the slab size
+    auto big = arena.allocate(1000);
+    EXPECT_TRUE(isAligned(big));
+    EXPECT_GE(arena.allocated(), 1030U);
+    arena.release();
+    EXPECT_EQ(0U, arena.allocated());
+    EXPECT_TRUE(isAligned(arena.allocate(8)));
+}
+
+TEST(SizeClassPool, reuses_released_blocks_of_the_same_size_class)
+{
+    SizeClassPool pool;
+    auto first = pool.allocate(100);
+    auto second = pool.allocate(128);
+    EXPECT_NE(first, second);
+    pool.deallocate(first, 100);
+    EXPECT_EQ(first, pool.allocate(120));
+    pool.deallocate(second, 128);
+    EXPECT_NE(second, pool.allocate(256));
+    EXPECT_EQ(second, pool.allocate(65));
+}
+
+TEST(SizeClassPool, passes_big_blocks_to_global_allocator)
+{
+    SizeClassPool pool;
+    const auto size = SizeClassPool::max_pooled_size + 1;
+    auto block = pool.allocate(size);
+    EXPECT_TRUE(isAligned(block));
+    pool.deallocate(block, size);
+}
+
+TEST(HeapStorage, uses_provided_allocator)
+{
+    MonotonicArena arena;
+    details::HeapStorage<int, ArenaAllocator> storage{ArenaAllocator{arena}};
+    for (int i = 0; i < 100; i++)
+    {
+        storage.push_back(i);
+    }
+    EXPECT_EQ(100U, storage.size());
+    EXPECT_EQ(99, storage.back());
+    // all intermediate buffers come from the arena: 1 + 2 + 4 + ... + 128 values rounded up to the alignment
+    EXPECT_GE(arena.allocated(), 255 * sizeof(int));
+
+    auto copy = storage;
+    EXPECT_THAT(copy, ElementsAreArray(storage.begin(), storage.end()));
+    const auto allocated = arena.allocated();
+    auto moved = static_cast<details::HeapStorage<int, ArenaAllocator>&&>(copy);
+    EXPECT_EQ(allocated, arena.allocated());
+    EXPECT_EQ(100U, moved.size());
+}
+
+TEST(HeapStorage, release_returns_memory_to_allocator)
+{
+    SizeClassPool pool;
+    details::HeapStorage<int, PoolAllocator> storage{PoolAllocator{pool}};
+    storage.reserve(64);
+    const auto buffer = storage.data();
+    storage.push_back(1);
+    storage.release();
+    EXPECT_TRUE(storage.empty());
+    EXPECT_EQ(0U, storage.capacity());
+
+    details::HeapStorage<int, PoolAllocator> other{PoolAllocator{pool}};
+    other.reserve(64);
+    EXPECT_EQ(buffer, other.data());
+}
+
+TEST(MedianCalculator, calculators_share_pool)
+{
+    SizeClassPool pool;
+    MedianCalculator<int, PoolAllocator> first{PoolAllocator{pool}};
+    MedianCalculator<int, PoolAllocator> second{PoolAllocator{pool}};
+    for (int i = 1; i <= 1000; i++)
+    {
+        first.add(i);
+        second.add(-i);
+    }
+    EXPECT_THAT(first.calculate(), DoubleEq(500.5));
+    EXPECT_THAT(second.calculate(), DoubleEq(-500.5));
+
+    first.release();
+    EXPECT_TRUE(std::isnan(first.calculate()));
+    first.add(7);
+    EXPECT_THAT(first.calculate(), DoubleEq(7));
+    const int values[] = {5, 3, 9, 1, 8, 2, 7, 4, 6, 10, 11, 12, 13, 14, 15, 16,
+                          17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+    second.reset();
+    second.addRange(std::begin(values), std::end(values));
+    EXPECT_THAT(second.calculate(), DoubleEq(16.5));
+}
+
+TEST(MedianCalculator, calculators_share_arena)
+{
+    MonotonicArena arena;
+    using Calculator = MedianCalculator<int, ArenaAllocator>;
+    Calculator calculators[] = {Calculator{ArenaAllocator{arena}}, Calculator{ArenaAllocator{arena}}};
+    for (int i = 0; i < 100; i++)
+    {
+        calculators[i % 2].add(i);
+    }
+    EXPECT_THAT(calculators[0].calculate(), DoubleEq(49));
+    EXPECT_THAT(calculators[1].calculate(), DoubleEq(50));
+    EXPECT_GT(arena.allocated(), 0U);
+}
+
+} // anonymous namespace
@@ -0,0 +1,138 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/CountingMedianCalculator.h"
+#include "median/MedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(CountingMedianCalculator, median_of_empty_set_is_nan)
+{
+    EXPECT_TRUE(std::isnan(CountingMedianCalculator<int>(0, 10).calculate()));
+}
+
+TEST(CountingMedianCalculator, median_of_added_values)
+{
+    CountingMedianCalculator<int> c{-10, 10};
+    c.add(5);
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+    c.add(-10);
+    EXPECT_THAT(c.calculate(), DoubleEq(-2.5));
+    c.add(10);
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+    c.add(5);
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+    c.add(-3);
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+    c.add(-3);
+    EXPECT_THAT(c.calculate(), DoubleEq(1));
+    EXPECT_EQ(6U, c.size());
+}
+
+TEST(CountingMedianCalculator, middle_values_in_distant_blocks)
+{
+    CountingMedianCalculator<unsigned> c{0, 100000};
+    c.add(100000);
+    c.add(0);
+    EXPECT_THAT(c.calculate(), DoubleEq(50000));
+    c.add(70000);
+    EXPECT_THAT(c.calculate(), DoubleEq(70000));
+    c.add(300);
+    EXPECT_THAT(c.calculate(), DoubleEq(35150));
+}
+
+TEST(CountingMedianCalculator, range_bounds_of_the_type)
+{
+    CountingMedianCalculator<short> c{std::numeric_limits<short>::min(), std::numeric_limits<short>::max()};
+    c.add(-32768);
+    c.add(32767);
+    EXPECT_THAT(c.calculate(), DoubleEq(-0.5));
+    c.add(32767);
+    EXPECT_THAT(c.calculate(), DoubleEq(32767));
+    EXPECT_EQ(-32768, c.min());
+    EXPECT_EQ(32767, c.max());
+}
+
+TEST(CountingMedianCalculator, values_out_of_range_are_rejected)
+{
+    CountingMedianCalculator<int> c{1, 3};
+    EXPECT_THROW(c.add(0), std::out_of_range);
+    EXPECT_THROW(c.add(4), std::out_of_range);
+    EXPECT_EQ(0U, c.size());
+    EXPECT_THROW((CountingMedianCalculator<int>{3, 1}), std::invalid_argument);
+    EXPECT_THROW((CountingMedianCalculator<long long>{std::numeric_limits<long long>::min(),
+                                                      std::numeric_limits<long long>::max()}),
+                 std::invalid_argument);
+}
+
+TEST(CountingMedianCalculator, overflowing_count_is_rejected)
+{
+    CountingMedianCalculator<int, unsigned char> c{0, 10};
+    for (int i = 0; i < 255; i++)
+    {
+        c.add(3);
+    }
+    EXPECT_THROW(c.add(3), std::overflow_error);
+    EXPECT_EQ(255U, c.size());
+    c.add(10);
+    c.add(10);
+    EXPECT_THAT(c.calculate(), DoubleEq(3));
+}
+
+TEST(CountingMedianCalculator, reset_restarts_calculation)
+{
+    CountingMedianCalculator<int> c{0, 1000};
+    const int values[] = {1000, 3, 500, 7};
+    c.addRange(values, values + 4);
+    EXPECT_THAT(c.calculate(), DoubleEq(253.5));
+    c.reset();
+    EXPECT_TRUE(std::isnan(c.calculate()));
+    EXPECT_EQ(0U, c.size());
+    c.add(999);
+    EXPECT_THAT(c.calculate(), DoubleEq(999));
+}
+
+// range width and number of values the values are generated from (few values make buckets sparse)
+struct CountingMedianCalculatorRegression : TestWithParam<std::tuple<int, int>>
+{
+};
+
+TEST_P(CountingMedianCalculatorRegression, running_median_for_randomly_generated_numbers)
+{
+    const auto width = std::get<0>(GetParam());
+    const auto distinct = std::get<1>(GetParam());
+    CountingMedianCalculator<int> c{-width / 2, width - width / 2};
+    MedianCalculator<int> reference;
+
+    std::mt19937 generator(static_cast<unsigned>(width + distinct));
+    std::uniform_int_distribution<> distribution(-width / 2, width - width / 2);
+    std::vector<int> candidates;
+    for (int i = 0; i < distinct; i++)
+    {
+        candidates.push_back(distribution(generator));
+    }
+    std::uniform_int_distribution<std::size_t> pick(0, candidates.size() - 1);
+    for (std::size_t i = 0; i < 20000; i++)
+    {
+        const auto randomizedValue = candidates[pick(generator)];
+        c.add(randomizedValue);
+        reference.add(randomizedValue);
+        ASSERT_THAT(c.calculate(), DoubleEq(reference.calculate())) << "after " << i + 1 << " values";
+    }
+}
+
+} // anonymous namespace
+
+INSTANTIATE_TEST_CASE_P(CountingMedianCalculatorRegressionParametrized,
+                        CountingMedianCalculatorRegression,
+                        Values(std::make_tuple(0, 1), std::make_tuple(10, 5), std::make_tuple(1000, 1000),
+                               std::make_tuple(100000, 20), std::make_tuple(1000000, 20000)));
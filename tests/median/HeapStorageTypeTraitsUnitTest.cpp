@@ -1,5 +1,6 @@
 #include "median/HeapStorageTypeTraits.h"
 #include <gtest/gtest.h>
+#include <string>
 
 namespace
 {
@@ -17,4 +18,39 @@ TEST(HeapStorageTypeTraits, isTypeInTheList)
     EXPECT_TRUE((isTypeInTheList<const volatile int, int>()));
 }
 
+TEST(HeapStorageTypeTraits, arithmetic_types)
+{
+    EXPECT_TRUE(isIntegral<unsigned long>());
+    EXPECT_FALSE(isIntegral<float>());
+    EXPECT_TRUE(isFloatingPoint<const double>());
+    EXPECT_FALSE(isFloatingPoint<int>());
+    EXPECT_TRUE(isArithmetic<long double>());
+    EXPECT_FALSE(isArithmetic<std::string>());
+}
+
+TEST(HeapStorageTypeTraits, isSigned)
+{
+    EXPECT_TRUE(isSigned<short>());
+    EXPECT_TRUE(isSigned<const long long>());
+    EXPECT_TRUE(isSigned<double>());
+    EXPECT_TRUE(isSigned<signed char>());
+    EXPECT_FALSE(isSigned<unsigned>());
+    EXPECT_FALSE(isSigned<unsigned char>());
+    EXPECT_FALSE(isSigned<char32_t>());
+    EXPECT_EQ(static_cast<wchar_t>(-1) < 0, isSigned<wchar_t>());
+    EXPECT_EQ(static_cast<char>(-1) < 0, isSigned<char>());
+    EXPECT_FALSE(isSigned<std::string>());
+}
+
+TEST(HeapStorageTypeTraits, IsTriviallyCopyable)
+{
+    struct FixedPoint
+    {
+        long raw;
+    };
+    EXPECT_TRUE(IsTriviallyCopyable<float>::value);
+    EXPECT_TRUE(IsTriviallyCopyable<FixedPoint>::value);
+    EXPECT_FALSE(IsTriviallyCopyable<std::string>::value);
+}
+
 } // anonymous namespace
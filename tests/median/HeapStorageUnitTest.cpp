@@ -1,6 +1,7 @@
 #include "median/HeapStorage.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <string>
 
 namespace
 {
@@ -130,6 +131,34 @@ TEST(HeapStorage, new_element_doubles_capacity_if_is_already_full)
     EXPECT_EQ(20U, storage.capacity());
 }
 
+TEST(HeapStorage, append_copies_the_range_and_grows_capacity_at_once)
+{
+    HeapStorage<int> storage;
+    storage.push_back(1);
+    const int values[] = {2, 3, 4, 5, 6};
+    storage.append(values, values + 5);
+    EXPECT_EQ(6U, storage.size());
+    EXPECT_EQ(6U, storage.capacity());
+    EXPECT_THAT(storage, ElementsAreArray(std::initializer_list<int>{1, 2, 3, 4, 5, 6}));
+
+    storage.append(values, values + 1);
+    EXPECT_EQ(7U, storage.size());
+    EXPECT_EQ(12U, storage.capacity()) << "capacity is doubled if it is enough";
+    storage.append(values, values);
+    EXPECT_EQ(7U, storage.size());
+}
+
+TEST(HeapStorage, pop_back_many_elements)
+{
+    HeapStorage<int> storage;
+    const int values[] = {2, 3, 4, 5, 6};
+    storage.append(values, values + 5);
+    storage.pop_back(3);
+    EXPECT_THAT(storage, ElementsAreArray(std::initializer_list<int>{2, 3}));
+    storage.pop_back(2);
+    EXPECT_TRUE(storage.empty());
+}
+
 TEST(HeapStorage, clear_changes_size_but_capacity)
 {
     HeapStorage<int> storage;
@@ -391,4 +420,43 @@ TEST(HeapStorage, swap)
     EXPECT_THAT(storage, ElementsAreArray(std::initializer_list<int>{9, 8, 7, 3, 4, 5, 6, 2, 1, 0}));
 }
 
+TEST(HeapStorage, floating_point_values)
+{
+    HeapStorage<double> storage;
+    storage.push_back(0.5);
+    storage.push_back(-1.25);
+    auto copy = storage;
+    copy.push_back(2.0);
+    EXPECT_THAT(storage, ElementsAre(0.5, -1.25));
+    EXPECT_THAT(copy, ElementsAre(0.5, -1.25, 2.0));
+}
+
+TEST(HeapStorage, non_trivially_copyable_values_are_constructed_and_destroyed)
+{
+    // strings longer than the small string buffer own heap memory, so leaks and double frees are detectable
+    const std::string prefix(32, 'x');
+    HeapStorage<std::string> storage;
+    for (int i = 0; i < 10; i++)
+    {
+        storage.push_back(prefix + std::to_string(i));
+    }
+    storage.swap(0, 9);
+    storage.pop_back(7);
+    EXPECT_THAT(storage, ElementsAre(prefix + "9", prefix + "1", prefix + "2"));
+
+    auto copy = storage;
+    copy.shrink_to_fit();
+    storage.clear();
+    EXPECT_THAT(copy, ElementsAre(prefix + "9", prefix + "1", prefix + "2"));
+
+    storage = copy;
+    auto moved = static_cast<HeapStorage<std::string>&&>(copy);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_THAT(moved, ElementsAre(prefix + "9", prefix + "1", prefix + "2"));
+    moved.resize(4);
+    EXPECT_THAT(moved, ElementsAre(prefix + "9", prefix + "1", prefix + "2", ""));
+    storage.release();
+    EXPECT_EQ(0U, storage.capacity());
+}
+
 } // anonymous namespace
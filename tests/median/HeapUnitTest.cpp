@@ -1,6 +1,9 @@
 #include "median/Heap.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -108,6 +111,184 @@ TEST(MaxHeap, pop)
     EXPECT_TRUE(h.empty());
 }
 
+template <typename Heap>
+std::vector<typename Heap::value_type> drain(Heap& h)
+{
+    std::vector<typename Heap::value_type> drained;
+    while (not h.empty())
+    {
+        drained.push_back(h.top());
+        h.pop();
+    }
+    return drained;
+}
+
+TEST(MaxHeap, replace_top)
+{
+    MaxHeap<int> h;
+    for (int value : {10, 7, 9, 3})
+    {
+        h.insert(value);
+    }
+    EXPECT_EQ(10, h.replaceTop(1));
+    EXPECT_EQ(4U, h.size());
+    EXPECT_EQ(9, h.replaceTop(20));
+    EXPECT_THAT(drain(h), ElementsAre(20, 7, 3, 1));
+}
+
+TEST(MaxHeap, push_pop)
+{
+    MaxHeap<int> h;
+    EXPECT_EQ(5, h.pushPop(5));
+    EXPECT_TRUE(h.empty());
+    for (int value : {10, 7, 9})
+    {
+        h.insert(value);
+    }
+    EXPECT_EQ(12, h.pushPop(12));
+    EXPECT_EQ(10, h.pushPop(10));
+    EXPECT_EQ(10, h.pushPop(8));
+    EXPECT_THAT(drain(h), ElementsAre(9, 8, 7));
+}
+
+TEST(MinHeap, push_pop)
+{
+    MinHeap<int, 4> h;
+    for (int value : {10, 7, 9, 3, 12})
+    {
+        h.insert(value);
+    }
+    EXPECT_EQ(1, h.pushPop(1));
+    EXPECT_EQ(3, h.pushPop(8));
+    EXPECT_THAT(drain(h), ElementsAre(7, 8, 9, 10, 12));
+}
+
+TEST(MaxHeap, insert_range_into_empty_heap_builds_it_bottom_up)
+{
+    MaxHeap<int> h;
+    const int values[] = {21, 63, 75, 15, 89, 13, 73, 100, 2, 13, 73, 65, 22, 21, 74};
+    h.insert(std::begin(values), std::end(values));
+    EXPECT_THAT(
+        h, ElementsAreArray(std::initializer_list<int>{100, 89, 75, 63, 73, 65, 74, 15, 2, 13, 21, 13, 22, 21, 73}));
+    EXPECT_THAT(drain(h), ElementsAre(100, 89, 75, 74, 73, 73, 65, 63, 22, 21, 21, 15, 13, 13, 2));
+}
+
+TEST(MaxHeap, insert_short_range_into_big_heap)
+{
+    MaxHeap<int> h;
+    for (int i = 0; i < 100; i++)
+    {
+        h.insert(i);
+    }
+    const int values[] = {1000, -1, 50};
+    h.insert(std::begin(values), std::end(values));
+    EXPECT_EQ(103U, h.size());
+    EXPECT_EQ(1000, h.top());
+    const auto drained = drain(h);
+    EXPECT_TRUE(std::is_sorted(drained.rbegin(), drained.rend()));
+}
+
+TEST(MaxHeap, pop_many_elements)
+{
+    for (std::size_t count : {0U, 1U, 3U, 50U, 99U, 100U})
+    {
+        MaxHeap<int> h;
+        for (int i = 0; i < 100; i++)
+        {
+            h.insert((i * 37) % 100);
+        }
+        std::vector<int> popped(count);
+        h.pop(count, popped.data());
+        std::sort(popped.begin(), popped.end());
+        for (std::size_t i = 0; i < count; i++)
+        {
+            EXPECT_EQ(static_cast<int>(100 - count + i), popped[i]);
+        }
+        EXPECT_EQ(100U - count, h.size());
+        const auto drained = drain(h);
+        ASSERT_EQ(100U - count, drained.size());
+        for (std::size_t i = 0; i < drained.size(); i++)
+        {
+            EXPECT_EQ(static_cast<int>(100 - count - 1 - i), drained[i]);
+        }
+    }
+}
+
+TEST(MaxHeap, four_ary_layout)
+{
+    MaxHeap<int, 4> h;
+    for (int value : {3, 1, 4, 1, 5, 9, 2, 6})
+    {
+        h.insert(value);
+    }
+    // children of the node i are located at indices 4i+1 .. 4i+4
+    EXPECT_THAT(h, ElementsAre(9, 6, 3, 1, 4, 1, 2, 5));
+    h.pop();
+    EXPECT_THAT(h, ElementsAre(6, 5, 3, 1, 4, 1, 2));
+}
+
+TEST(Heap, select_child)
+{
+    const int children[] = {4, 9, 2, 9, 1, 0, 7, 3};
+    EXPECT_EQ(1U, details::selectChild<8>(children, 8, Less<int>{}));
+    EXPECT_EQ(5U, details::selectChild<8>(children, 8, Greater<int>{}));
+    EXPECT_EQ(0U, details::selectChild<8>(children, 1, Less<int>{}));
+    EXPECT_EQ(4U, details::selectChild<8>(children, 5, Greater<int>{}));
+}
+
+template <typename HeapType>
+class HeapArityTest : public Test
+{
+};
+
+using HeapTypes = Types<MaxHeap<int, 2>, MaxHeap<int, 3>, MaxHeap<int, 4>, MaxHeap<long, 8>, MinHeap<int, 4>,
+                        MinHeap<long, 8>, MinHeap<unsigned, 16>>;
+TYPED_TEST_CASE(HeapArityTest, HeapTypes);
+
+TYPED_TEST(HeapArityTest, drains_values_in_heap_order)
+{
+    using value_type = typename TypeParam::value_type;
+    std::vector<value_type> values;
+    for (int i = 0; i < 1000; i++)
+    {
+        values.push_back(static_cast<value_type>((i * 7919) % 211));
+    }
+    TypeParam incremental;
+    for (auto value : values)
+    {
+        incremental.insert(value);
+    }
+    TypeParam bulk;
+    bulk.insert(values.data(), values.data() + values.size());
+    std::vector<value_type> popped(300);
+    bulk.pop(popped.size(), popped.data());
+
+    auto drained = drain(incremental);
+    ASSERT_EQ(values.size(), drained.size());
+    // the first elements of the drained sequence are the popped ones
+    std::sort(popped.begin(), popped.end());
+    std::vector<value_type> expectedPopped(drained.begin(), drained.begin() + 300);
+    std::sort(expectedPopped.begin(), expectedPopped.end());
+    EXPECT_EQ(expectedPopped, popped);
+    EXPECT_EQ(std::vector<value_type>(drained.begin() + 300, drained.end()), drain(bulk));
+    // max heap drains in descending order, min heap in ascending one
+    EXPECT_TRUE(std::is_sorted(drained.begin(), drained.end()) or std::is_sorted(drained.rbegin(), drained.rend()));
+    std::sort(values.begin(), values.end());
+    std::sort(drained.begin(), drained.end());
+    EXPECT_EQ(values, drained);
+}
+
+TEST(MinHeap, pop_many_elements)
+{
+    MinHeap<int> h;
+    const int values[] = {5, 1, 9, 3, 7, 2, 8, 6, 4, 0};
+    h.insert(std::begin(values), std::end(values));
+    int popped[6];
+    h.pop(6, popped);
+    EXPECT_THAT(popped, UnorderedElementsAre(0, 1, 2, 3, 4, 5));
+    EXPECT_THAT(drain(h), ElementsAre(6, 7, 8, 9));
+}
+
 TEST(MinHeap, insert)
 {
     MinHeap<int> h;
@@ -209,4 +390,22 @@ TEST(MinHeap, pop)
     EXPECT_TRUE(h.empty());
 }
 
+TEST(MaxHeap, non_trivially_copyable_values)
+{
+    MaxHeap<std::string, 4> heap;
+    const std::string words[] = {"delta", "alpha", "echo", "charlie", "bravo", "foxtrot", "golf"};
+    heap.insert(std::begin(words), std::end(words));
+    heap.insert("hotel");
+    EXPECT_EQ("india", heap.pushPop("india"));
+    EXPECT_EQ("hotel", heap.pushPop("beta"));
+    EXPECT_EQ("golf", heap.replaceTop("a"));
+    std::vector<std::string> popped;
+    while (not heap.empty())
+    {
+        popped.push_back(heap.top());
+        heap.pop();
+    }
+    EXPECT_THAT(popped, ElementsAre("foxtrot", "echo", "delta", "charlie", "bravo", "beta", "alpha", "a"));
+}
+
 } // anonymous namespace
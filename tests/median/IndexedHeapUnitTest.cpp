@@ -0,0 +1,156 @@
+#include "median/IndexedHeap.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+
+using namespace ::testing;
+using namespace ::tplx;
+
+template <typename Heap>
+std::vector<int> drain(Heap& h)
+{
+    std::vector<int> drained;
+    while (not h.empty())
+    {
+        drained.push_back(h.top());
+        h.pop();
+    }
+    return drained;
+}
+
+TEST(IndexedMaxHeap, default_constructed_heap_is_empty)
+{
+    IndexedMaxHeap<int> h;
+    EXPECT_TRUE(h.empty());
+    EXPECT_EQ(0U, h.size());
+    EXPECT_FALSE(h.contains(0));
+    EXPECT_EQ(IndexedMaxHeap<int>::npos, h.position(10));
+}
+
+TEST(IndexedMaxHeap, insert_and_pop)
+{
+    IndexedMaxHeap<int> h;
+    h.insert(0, 21);
+    h.insert(1, 63);
+    h.insert(2, 75);
+    h.insert(3, 15);
+    h.insert(4, 89);
+    EXPECT_EQ(5U, h.size());
+    EXPECT_EQ(89, h.top());
+    EXPECT_EQ(4U, h.topHandle());
+    EXPECT_THAT(drain(h), ElementsAre(89, 75, 63, 21, 15));
+    EXPECT_FALSE(h.contains(4));
+}
+
+TEST(IndexedMaxHeap, erase_by_handle)
+{
+    IndexedMaxHeap<int> h;
+    for (int i = 0; i < 10; i++)
+    {
+        h.insert(i, i * 10);
+    }
+    h.erase(9);
+    h.erase(0);
+    h.erase(5);
+    EXPECT_FALSE(h.contains(9));
+    EXPECT_FALSE(h.contains(0));
+    EXPECT_FALSE(h.contains(5));
+    EXPECT_TRUE(h.contains(4));
+    EXPECT_EQ(7U, h.size());
+    EXPECT_THAT(drain(h), ElementsAre(80, 70, 60, 40, 30, 20, 10));
+}
+
+TEST(IndexedMaxHeap, erase_by_position)
+{
+    IndexedMaxHeap<int> h;
+    for (int i = 0; i < 10; i++)
+    {
+        h.insert(i, i);
+    }
+    EXPECT_EQ(0U, h.position(9));
+    h.eraseAt(0);
+    h.eraseAt(h.size() - 1);
+    EXPECT_EQ(8U, h.size());
+    EXPECT_EQ(8, h.top());
+}
+
+TEST(IndexedMaxHeap, erase_of_inner_element_may_require_sift_up)
+{
+    IndexedMaxHeap<int> h;
+    // the last element (45) replaces the erased one (10) and is greater than its new parent (40)
+    h.insert(0, 100);
+    h.insert(1, 50);
+    h.insert(2, 40);
+    h.insert(3, 49);
+    h.insert(4, 48);
+    h.insert(5, 10);
+    h.insert(6, 30);
+    h.insert(7, 47);
+    h.insert(8, 46);
+    h.insert(9, 45);
+    h.erase(5);
+    EXPECT_THAT(drain(h), ElementsAre(100, 50, 49, 48, 47, 46, 45, 40, 30));
+}
+
+TEST(IndexedMaxHeap, update_moves_element_up_and_down)
+{
+    IndexedMaxHeap<int> h;
+    for (int i = 0; i < 8; i++)
+    {
+        h.insert(i, i);
+    }
+    h.update(0, 100);
+    EXPECT_EQ(100, h.top());
+    EXPECT_EQ(0U, h.topHandle());
+    h.update(0, -1);
+    EXPECT_EQ(7, h.top());
+    EXPECT_THAT(drain(h), ElementsAre(7, 6, 5, 4, 3, 2, 1, -1));
+}
+
+TEST(IndexedMaxHeap, clear_removes_all_handles)
+{
+    IndexedMaxHeap<int> h;
+    h.insert(3, 1);
+    h.insert(7, 2);
+    h.clear();
+    EXPECT_TRUE(h.empty());
+    EXPECT_FALSE(h.contains(3));
+    EXPECT_FALSE(h.contains(7));
+    h.insert(3, 5);
+    EXPECT_EQ(5, h.top());
+}
+
+TEST(IndexedMaxHeap, assign_replaces_content_and_tracks_handles)
+{
+    IndexedMaxHeap<int> h;
+    h.insert(9, 100);
+    const std::size_t handles[] = {4, 0, 2, 7, 1, 3};
+    const int items[] = {21, 63, 75, 15, 89, 40};
+    h.assign(handles, items, 6);
+    EXPECT_EQ(6U, h.size());
+    EXPECT_FALSE(h.contains(9));
+    EXPECT_EQ(89, h.top());
+    EXPECT_EQ(1U, h.topHandle());
+    h.erase(2);
+    h.update(7, 70);
+    EXPECT_THAT(drain(h), ElementsAre(89, 70, 63, 40, 21));
+}
+
+TEST(IndexedMinHeap, insert_erase_and_pop)
+{
+    IndexedMinHeap<int> h;
+    h.insert(0, 5);
+    h.insert(1, -3);
+    h.insert(2, 8);
+    h.insert(3, 0);
+    EXPECT_EQ(-3, h.top());
+    EXPECT_EQ(1U, h.topHandle());
+    h.erase(1);
+    EXPECT_EQ(0, h.top());
+    EXPECT_THAT(drain(h), ElementsAre(0, 5, 8));
+}
+
+} // anonymous namespace
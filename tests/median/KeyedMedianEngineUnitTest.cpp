@@ -0,0 +1,96 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/KeyedMedianEngine.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(KeyedMedianEngine, median_of_unknown_stream_is_nan)
+{
+    KeyedMedianEngine<unsigned, int> engine;
+    EXPECT_TRUE(std::isnan(engine.calculate(7)));
+    EXPECT_EQ(nullptr, engine.find(7));
+    EXPECT_EQ(0U, engine.size());
+}
+
+TEST(KeyedMedianEngine, streams_are_independent)
+{
+    KeyedMedianEngine<unsigned, int> engine;
+    engine.add(1, 10);
+    engine.add(2, 100);
+    engine.add(1, 20);
+    engine.add(2, 300);
+    engine.add(2, 200);
+    EXPECT_EQ(2U, engine.size());
+    EXPECT_DOUBLE_EQ(15.0, engine.calculate(1));
+    EXPECT_DOUBLE_EQ(200.0, engine.calculate(2));
+
+    engine.reset(1);
+    EXPECT_TRUE(std::isnan(engine.calculate(1)));
+    EXPECT_DOUBLE_EQ(200.0, engine.calculate(2));
+    EXPECT_EQ(2U, engine.size()) << "reset stream keeps its slot";
+
+    engine.clear();
+    EXPECT_EQ(0U, engine.size());
+    EXPECT_TRUE(std::isnan(engine.calculate(2)));
+    engine.add(2, 5);
+    EXPECT_DOUBLE_EQ(5.0, engine.calculate(2));
+}
+
+TEST(KeyedMedianEngine, bulk_add_to_stream)
+{
+    KeyedMedianEngine<long long, int> engine{4};
+    const int values[] = {5, 1, 9, 3, 7};
+    engine.addRange(-3, std::begin(values), std::end(values));
+    EXPECT_DOUBLE_EQ(5.0, engine.calculate(-3));
+}
+
+TEST(KeyedMedianEngine, streams_share_allocator)
+{
+    MonotonicArena arena;
+    KeyedMedianEngine<unsigned, int, ArenaAllocator> engine{0, ArenaAllocator{arena}};
+    for (int i = 0; i < 100; i++)
+    {
+        engine.add(static_cast<unsigned>(i % 20), i);
+    }
+    EXPECT_EQ(20U, engine.size());
+    EXPECT_DOUBLE_EQ(40.0, engine.calculate(0));
+    EXPECT_DOUBLE_EQ(59.0, engine.calculate(19));
+    EXPECT_GT(arena.allocated(), 0U) << "values of the streams come from the arena";
+}
+
+TEST(KeyedMedianEngineRegression, many_streams_of_randomly_generated_numbers)
+{
+    KeyedMedianEngine<unsigned, int> engine;
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<unsigned> keys(0, 20000);
+    std::uniform_int_distribution<int> values(-1000, 1000);
+
+    std::map<unsigned, std::vector<int>> reference;
+    for (std::size_t i = 0; i < 200000; i++)
+    {
+        const auto key = keys(generator);
+        const auto value = values(generator);
+        engine.add(key, value);
+        reference[key].push_back(value);
+    }
+    ASSERT_EQ(reference.size(), engine.size());
+    for (auto& stream : reference)
+    {
+        ASSERT_THAT(engine.calculate(stream.first),
+                    DoubleEq(calculateReferenceMedianValue_nth_element_based(stream.second)))
+            << stream.first;
+    }
+}
+
+} // anonymous namespace
@@ -0,0 +1,121 @@
+#include "median/CountingMedianCalculator.h"
+#include "median/LazyMedianCalculator.h"
+#include "median/MedianCalculator.h"
+#include "median/WindowMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(LazyMedianCalculator, median_of_empty_set_is_not_a_change)
+{
+    LazyMedianCalculator<MedianCalculator<int>> c;
+    EXPECT_FALSE(c.changed());
+    EXPECT_TRUE(std::isnan(c.calculate()));
+}
+
+TEST(LazyMedianCalculator, change_is_relative_to_the_last_taken_median)
+{
+    LazyMedianCalculator<MedianCalculator<int>> c;
+    c.add(5);
+    EXPECT_TRUE(c.changed());
+    EXPECT_TRUE(c.changed()) << "checking does not acknowledge the change";
+    EXPECT_THAT(c.take(), DoubleEq(5));
+    EXPECT_FALSE(c.changed());
+    c.add(5);
+    EXPECT_FALSE(c.changed());
+    c.add(7); // 5 5 7
+    EXPECT_FALSE(c.changed());
+    c.add(9); // 5 5 7 9
+    EXPECT_TRUE(c.changed());
+    c.add(1); // 1 5 5 7 9
+    EXPECT_FALSE(c.changed()) << "the median has returned to the last taken value";
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+}
+
+TEST(LazyMedianCalculator, calculating_median_does_not_acknowledge_the_change)
+{
+    LazyMedianCalculator<MedianCalculator<int>> c;
+    c.add(5);
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+    EXPECT_TRUE(c.changed());
+    EXPECT_THAT(c.calculate(), DoubleEq(5));
+    c.add(7);
+    EXPECT_THAT(c.calculate(), DoubleEq(6)) << "values added after the last check are included";
+    EXPECT_TRUE(c.changed());
+}
+
+TEST(LazyMedianCalculator, ranges_are_added_to_the_wrapped_calculator)
+{
+    LazyMedianCalculator<MedianCalculator<int>> c;
+    const int values[] = {4, 8, 15, 16, 23, 42};
+    c.addRange(values, values + 6);
+    EXPECT_TRUE(c.changed());
+    EXPECT_THAT(c.calculate(), DoubleEq(15.5));
+    EXPECT_EQ(6U * sizeof(int), c.calculator().snapshotSize() - sizeof(SnapshotHeader));
+}
+
+TEST(LazyMedianCalculator, reset_changes_median_to_nan)
+{
+    LazyMedianCalculator<MedianCalculator<int>> c;
+    c.reset();
+    EXPECT_FALSE(c.changed());
+    c.add(3);
+    EXPECT_THAT(c.take(), DoubleEq(3));
+    c.reset();
+    EXPECT_TRUE(c.changed());
+    EXPECT_TRUE(std::isnan(c.take()));
+    EXPECT_FALSE(c.changed()) << "NaN medians are equal";
+}
+
+TEST(LazyMedianCalculator, wraps_calculators_constructed_with_arguments)
+{
+    LazyMedianCalculator<CountingMedianCalculator<int>> counting{0, 10};
+    counting.add(10);
+    EXPECT_TRUE(counting.changed());
+    EXPECT_THAT(counting.take(), DoubleEq(10));
+    EXPECT_EQ(10, counting.calculator().max());
+
+    LazyMedianCalculator<WindowMedianCalculator<int>> window{std::size_t{1}};
+    window.add(2);
+    EXPECT_THAT(window.take(), DoubleEq(2));
+    window.add(2);
+    EXPECT_FALSE(window.changed());
+    window.add(3);
+    EXPECT_TRUE(window.changed());
+}
+
+TEST(LazyMedianCalculator, copies_values_and_reference_median)
+{
+    LazyMedianCalculator<MedianCalculator<int>> c;
+    c.add(5);
+    EXPECT_THAT(c.take(), DoubleEq(5));
+    c.add(9);
+    LazyMedianCalculator<MedianCalculator<int>> copy{c}; // non-const lvalue is copied, not forwarded
+    EXPECT_TRUE(copy.changed());
+    EXPECT_THAT(copy.take(), DoubleEq(7));
+    const auto& constRef = c;
+    LazyMedianCalculator<MedianCalculator<int>> constCopy{constRef};
+    EXPECT_THAT(constCopy.calculate(), DoubleEq(7));
+    EXPECT_TRUE(c.changed()) << "taking the median of a copy does not acknowledge it in the original";
+}
+
+TEST(LazyMedianCalculator, only_tracking_calculators_report_unchanged_median)
+{
+    MedianCalculator<int> plain;
+    EXPECT_TRUE(details::medianChanged(plain));
+    LazyMedianCalculator<MedianCalculator<int>> lazy;
+    EXPECT_FALSE(details::medianChanged(lazy));
+    lazy.add(4);
+    EXPECT_TRUE(details::medianChanged(lazy));
+    EXPECT_THAT(details::takeMedian(lazy), DoubleEq(4));
+    EXPECT_FALSE(details::medianChanged(lazy));
+    plain.add(4);
+    EXPECT_THAT(details::takeMedian(plain), DoubleEq(4));
+}
+
+} // anonymous namespace
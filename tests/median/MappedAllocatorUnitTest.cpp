@@ -0,0 +1,111 @@
+#include "median/MappedAllocator.h"
+#include "median/HeapStorage.h"
+#include "median/MedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace
+{
+
+using namespace ::testing;
+using namespace ::tplx;
+
+constexpr std::size_t big_block = MappedAllocator::min_mapped_size;
+
+static_assert(details::HasReallocate<MappedAllocator>::value, "MappedAllocator resizes blocks in place");
+static_assert(not details::HasReallocate<NewAllocator>::value, "NewAllocator has no reallocate()");
+
+TEST(MappedAllocator, reallocate_preserves_contents_of_mapped_blocks)
+{
+    MappedAllocator allocator;
+    auto memory = static_cast<char*>(allocator.allocate(big_block));
+    std::memset(memory, 'x', big_block);
+    memory = static_cast<char*>(allocator.reallocate(memory, big_block, 4 * big_block));
+    EXPECT_EQ('x', memory[0]);
+    EXPECT_EQ('x', memory[big_block - 1]);
+    memory[4 * big_block - 1] = 'y';
+    memory = static_cast<char*>(allocator.reallocate(memory, 4 * big_block, big_block));
+    EXPECT_EQ('x', memory[big_block - 1]);
+    allocator.deallocate(memory, big_block);
+}
+
+TEST(MappedAllocator, reallocate_moves_blocks_between_heap_and_mappings)
+{
+    MappedAllocator allocator{false};
+    auto memory = static_cast<char*>(allocator.allocate(16));
+    std::memcpy(memory, "0123456789abcdef", 16);
+    memory = static_cast<char*>(allocator.reallocate(memory, 16, big_block));
+    EXPECT_EQ(0, std::memcmp(memory, "0123456789abcdef", 16));
+    memory = static_cast<char*>(allocator.reallocate(memory, big_block, 8));
+    EXPECT_EQ(0, std::memcmp(memory, "01234567", 8));
+    allocator.deallocate(memory, 8);
+}
+
+TEST(MappedAllocator, heap_storage_keeps_elements_while_growing_and_shrinking)
+{
+    details::HeapStorage<int, MappedAllocator> storage;
+    const int count = 3 * static_cast<int>(big_block / sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        storage.push_back(i);
+    }
+    storage.pop_back(static_cast<std::size_t>(count) - 10);
+    storage.shrink_to_fit();
+    ASSERT_EQ(10U, storage.capacity());
+    EXPECT_THAT(storage, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+
+    auto copy = storage;
+    EXPECT_THAT(copy, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+    storage.release();
+    EXPECT_EQ(0U, storage.capacity());
+}
+
+TEST(MappedAllocator, median_calculator_uses_mapped_storage)
+{
+    MedianCalculator<int, MappedAllocator> calculator{MappedAllocator{}};
+    const int count = static_cast<int>(big_block / sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        calculator.add(i);
+    }
+    EXPECT_DOUBLE_EQ((count - 1) / 2.0, calculator.calculate());
+}
+
+TEST(ReservedAllocator, grows_blocks_in_place_within_the_reservation)
+{
+    ReservedAllocator allocator{4 * big_block};
+    auto memory = static_cast<char*>(allocator.allocate(16));
+    std::memcpy(memory, "0123456789abcdef", 16);
+    EXPECT_EQ(memory, allocator.reallocate(memory, 16, 3 * big_block));
+    memory[3 * big_block - 1] = 'x';
+    EXPECT_EQ(memory, allocator.reallocate(memory, 3 * big_block, 100));
+    EXPECT_EQ(0, std::memcmp(memory, "0123456789abcdef", 16));
+
+    // beyond the reservation
+    memory = static_cast<char*>(allocator.reallocate(memory, 100, 8 * big_block));
+    EXPECT_EQ(0, std::memcmp(memory, "0123456789abcdef", 16));
+    memory[8 * big_block - 1] = 'x';
+    memory = static_cast<char*>(allocator.reallocate(memory, 8 * big_block, 16));
+    EXPECT_EQ(0, std::memcmp(memory, "0123456789abcdef", 16));
+    allocator.deallocate(memory, 16);
+}
+
+TEST(ReservedAllocator, heap_storage_never_moves_its_elements)
+{
+    details::HeapStorage<int, ReservedAllocator> storage{ReservedAllocator{8 * big_block}};
+    storage.push_back(0);
+    const auto data = storage.data();
+    const int count = static_cast<int>(big_block / sizeof(int));
+    for (int i = 1; i < count; i++)
+    {
+        storage.push_back(i);
+    }
+    EXPECT_EQ(data, storage.data());
+    EXPECT_EQ(count - 1, storage.back());
+    storage.shrink_to_fit();
+    EXPECT_EQ(data, storage.data());
+    EXPECT_EQ(count - 1, storage.back());
+}
+
+} // namespace
@@ -4,6 +4,7 @@
 #include "ReferenceMedianCalculator.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <cstdint>
 #include <random>
 
 namespace
@@ -71,4 +72,81 @@ TEST(MedianCalculatorRegression, running_median_for_randomly_generated_numbers)
     }
 }
 
+TEST(MedianCalculatorRegression, bulk_add_of_randomly_generated_numbers)
+{
+    MedianCalculator<int> c;
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(-10000, 10000);
+    std::uniform_int_distribution<> batchSizes(0, 3000);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        std::vector<int> batch(batchSizes(generator));
+        for (auto& value : batch)
+        {
+            // every other batch is shifted to make halves unbalanced after partitioning
+            value = distribution(generator) + (i % 2 == 0 ? 5000 : -5000);
+        }
+        c.addRange(batch.data(), batch.data() + batch.size());
+        collected.insert(collected.end(), batch.begin(), batch.end());
+        EXPECT_THAT(c.calculate(), DoubleEq(calculateReferenceMedianValue_nth_element_based(collected)));
+        c.add(static_cast<int>(i));
+        collected.push_back(static_cast<int>(i));
+        EXPECT_THAT(c.calculate(), DoubleEq(calculateReferenceMedianValue_nth_element_based(collected)));
+    }
+}
+
+TEST(MedianCalculatorRegression, restored_snapshots_continue_randomly_generated_streams)
+{
+    MedianCalculator<int> c;
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(-10000, 10000);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 2000; i++)
+    {
+        const auto randomizedValue = distribution(generator);
+        c.add(randomizedValue);
+        collected.push_back(randomizedValue);
+        if (i % 97 == 0)
+        {
+            std::vector<std::int64_t> snapshot((c.snapshotSize() + sizeof(std::int64_t) - 1) / sizeof(std::int64_t));
+            c.saveSnapshot(snapshot.data());
+            MedianCalculator<int> restored;
+            restored.restoreSnapshot(snapshot.data(), c.snapshotSize());
+            EXPECT_EQ(c.snapshotSize(), restored.snapshotSize());
+            c = restored;
+        }
+        EXPECT_THAT(c.calculate(), DoubleEq(calculateReferenceMedianValue_sort_based(collected)));
+    }
+}
+
+TEST(MedianCalculatorRegression, merge_of_randomly_generated_partial_results)
+{
+    MedianCalculator<int> c;
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(-10000, 10000);
+    std::uniform_int_distribution<> sizes(0, 2000);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        MedianCalculator<int> partial;
+        const auto size = i % 3 == 0 ? sizes(generator) % 10 : sizes(generator);
+        for (int j = 0; j < size; j++)
+        {
+            // partial results cover shifted ranges to make halves unbalanced after partitioning
+            const auto value = distribution(generator) + (i % 2 == 0 ? 3000 : -3000);
+            partial.add(value);
+            collected.push_back(value);
+        }
+        c.merge(partial);
+        EXPECT_THAT(c.calculate(), DoubleEq(calculateReferenceMedianValue_nth_element_based(collected)));
+    }
+}
+
 } // anonymous namespace
@@ -1,6 +1,48 @@
 #include "median/MedianCalculator.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+/// \brief Decimal fixed-point number with 3 fractional digits.
+struct Milli
+{
+    long raw;
+};
+
+bool operator<(Milli lhs, Milli rhs)
+{
+    return lhs.raw < rhs.raw;
+}
+
+} // anonymous namespace
+
+namespace tplx
+{
+
+template <>
+struct MedianTraits<Milli>
+{
+    using result_type = Milli;
+
+    static Milli empty() noexcept
+    {
+        return Milli{0};
+    }
+    static Milli middle(Milli value) noexcept
+    {
+        return value;
+    }
+    static Milli mean(Milli lower, Milli upper) noexcept
+    {
+        return Milli{lower.raw + (upper.raw - lower.raw) / 2};
+    }
+};
+
+} // namespace tplx
 
 namespace
 {
@@ -8,6 +50,13 @@ namespace
 using namespace ::tplx;
 using namespace ::testing;
 
+static_assert(sizeof(MedianCalculator<int>) == 2 * sizeof(MaxHeap<int>),
+              "calculators which do not propagate NaN values store nothing besides their halves");
+static_assert(sizeof(MedianCalculator<double, NewAllocator, NanPolicy::skip, CollectStats>) ==
+                  sizeof(MaxHeap<double, 2, NewAllocator, CollectStats>) +
+                      sizeof(MinHeap<double, 2, NewAllocator, CollectStats>),
+              "statistics of the calculator are collected by its halves");
+
 TEST(MedianCalculator, lowerHalf_and_upperHalf_selection)
 {
     MaxHeap<int> lowerHalf;
@@ -35,104 +84,6 @@ TEST(MedianCalculator, lowerHalf_and_upperHalf_selection)
     EXPECT_EQ(10, upperHalf.top());
 }
 
-TEST(MedianCalculator, balance_does_nothing_if_sizes_are_equal)
-{
-    MaxHeap<int> lowerHalf;
-    MinHeap<int> upperHalf;
-
-    details::addValue(10, lowerHalf, upperHalf);
-    details::addValue(20, lowerHalf, upperHalf);
-
-    EXPECT_EQ(1U, lowerHalf.size());
-    EXPECT_EQ(1U, upperHalf.size());
-    EXPECT_EQ(10, lowerHalf.top());
-    EXPECT_EQ(20, upperHalf.top());
-
-    details::balance(lowerHalf, upperHalf);
-
-    EXPECT_EQ(1U, lowerHalf.size());
-    EXPECT_EQ(1U, upperHalf.size());
-    EXPECT_EQ(10, lowerHalf.top());
-    EXPECT_EQ(20, upperHalf.top());
-}
-
-TEST(MedianCalculator, balance_does_nothing_if_sizes_differs_in_less_than_2)
-{
-    MaxHeap<int> lowerHalf;
-    MinHeap<int> upperHalf;
-
-    details::addValue(10, lowerHalf, upperHalf);
-    details::addValue(20, lowerHalf, upperHalf);
-    details::addValue(5, lowerHalf, upperHalf);
-
-    EXPECT_EQ(2U, lowerHalf.size());
-    EXPECT_EQ(1U, upperHalf.size());
-    EXPECT_EQ(10, lowerHalf.top());
-    EXPECT_EQ(20, upperHalf.top());
-
-    details::balance(lowerHalf, upperHalf);
-
-    EXPECT_EQ(2U, lowerHalf.size());
-    EXPECT_EQ(1U, upperHalf.size());
-    EXPECT_EQ(10, lowerHalf.top());
-    EXPECT_EQ(20, upperHalf.top());
-
-    details::addValue(30, lowerHalf, upperHalf);
-    details::addValue(40, lowerHalf, upperHalf);
-
-    EXPECT_EQ(2U, lowerHalf.size());
-    EXPECT_EQ(3U, upperHalf.size());
-    EXPECT_EQ(10, lowerHalf.top());
-    EXPECT_EQ(20, upperHalf.top());
-
-    details::balance(lowerHalf, upperHalf);
-
-    EXPECT_EQ(2U, lowerHalf.size());
-    EXPECT_EQ(3U, upperHalf.size());
-    EXPECT_EQ(10, lowerHalf.top());
-    EXPECT_EQ(20, upperHalf.top());
-}
-
-TEST(MedianCalculator, balance_moves_values_from_lowerHalf_to_upperHalf_if_lowerHalf_is_bigger)
-{
-    MaxHeap<int> lowerHalf;
-    MinHeap<int> upperHalf;
-
-    details::addValue(10, lowerHalf, upperHalf);
-    details::addValue(5, lowerHalf, upperHalf);
-
-    EXPECT_EQ(2U, lowerHalf.size());
-    EXPECT_EQ(0U, upperHalf.size());
-
-    details::balance(lowerHalf, upperHalf);
-
-    EXPECT_EQ(1U, lowerHalf.size());
-    EXPECT_EQ(1U, upperHalf.size());
-    EXPECT_EQ(5, lowerHalf.top());
-    EXPECT_EQ(10, upperHalf.top());
-}
-
-TEST(MedianCalculator, balance_moves_values_from_upperHalf_to_lowerHalf_if_upperHalf_is_bigger)
-{
-    MaxHeap<int> lowerHalf;
-    MinHeap<int> upperHalf;
-
-    details::addValue(10, lowerHalf, upperHalf);
-    details::addValue(20, lowerHalf, upperHalf);
-    details::addValue(30, lowerHalf, upperHalf);
-    details::addValue(40, lowerHalf, upperHalf);
-
-    EXPECT_EQ(1U, lowerHalf.size());
-    EXPECT_EQ(3U, upperHalf.size());
-
-    details::balance(lowerHalf, upperHalf);
-
-    EXPECT_EQ(2U, lowerHalf.size());
-    EXPECT_EQ(2U, upperHalf.size());
-    EXPECT_EQ(20, lowerHalf.top());
-    EXPECT_EQ(30, upperHalf.top());
-}
-
 TEST(MedianCalculator, median_of_empty_set_is_nan)
 {
     EXPECT_TRUE(std::isnan(MedianCalculator<int>{}.calculate()));
@@ -166,6 +117,24 @@ TEST(MedianCalculator, running_median_for_fixed_values)
     EXPECT_THAT(c.calculate(), DoubleEq(4));
 }
 
+TEST(MedianCalculator, running_median_when_each_value_crosses_the_median)
+{
+    // values alternate between both ends of the set, so every other value is moved between halves
+    MedianCalculator<int> c;
+    const int values[] = {50, 100, 0, 99, 1, 98, 2, 97, 3};
+    const double medians[] = {50, 75, 50, 74.5, 50, 74, 50, 73.5, 50};
+    for (std::size_t i = 0; i < 9; i++)
+    {
+        c.add(values[i]);
+        EXPECT_THAT(c.calculate(), DoubleEq(medians[i]));
+    }
+    for (int value = 200; value < 210; value++)
+    {
+        c.add(value);
+    }
+    EXPECT_THAT(c.calculate(), DoubleEq(200));
+}
+
 TEST(MedianCalculator, reset_restarts_calculation)
 {
     MedianCalculator<int> c;
@@ -179,4 +148,137 @@ TEST(MedianCalculator, reset_restarts_calculation)
     EXPECT_THAT(c.calculate(), DoubleEq(100));
 }
 
+TEST(MedianCalculator, floating_point_values)
+{
+    MedianCalculator<float> calculator;
+    calculator.add(1.5f);
+    EXPECT_DOUBLE_EQ(1.5, calculator.calculate());
+    calculator.add(-0.5f);
+    EXPECT_DOUBLE_EQ(0.5, calculator.calculate());
+    const double values[] = {0.25, 3.0, 2.5, -7.0, 1e300, -1e300, 0.75, 0.5, 0.125, 1.0, 2.0, 1.5, 1.25,
+                             0.375, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0,
+                             16.0, 17.0, 18.0, 19.0, 20.0, 21.0, 22.0};
+    MedianCalculator<double> doubles;
+    doubles.addRange(std::begin(values), std::end(values));
+    EXPECT_DOUBLE_EQ(7.0, doubles.calculate());
+}
+
+TEST(MedianCalculator, nan_values_are_skipped_by_default)
+{
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    MedianCalculator<double> calculator;
+    calculator.add(nan);
+    EXPECT_TRUE(std::isnan(calculator.calculate()));
+    calculator.add(2.0);
+    calculator.add(nan);
+    calculator.add(4.0);
+    EXPECT_DOUBLE_EQ(3.0, calculator.calculate());
+
+    std::vector<double> values(100, nan);
+    values[10] = 10.0;
+    values[20] = 20.0;
+    values[30] = 30.0;
+    calculator.addRange(values.data(), values.data() + values.size());
+    EXPECT_DOUBLE_EQ(10.0, calculator.calculate());
+}
+
+TEST(MedianCalculator, batch_reduced_to_single_value_by_skipped_nans)
+{
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values(31, nan);
+    values.push_back(5.0);
+    MedianCalculator<double> calculator;
+    calculator.addRange(values.data(), values.data() + values.size());
+    EXPECT_DOUBLE_EQ(5.0, calculator.calculate());
+
+    std::vector<double> ints;
+    for (int i = 1; i <= 40; i++)
+    {
+        ints.push_back(i);
+    }
+    calculator.addRange(ints.data(), ints.data() + ints.size());
+    EXPECT_DOUBLE_EQ(20.0, calculator.calculate());
+    calculator.add(0.5);
+    EXPECT_DOUBLE_EQ(19.5, calculator.calculate());
+}
+
+TEST(MedianCalculator, nan_values_propagate_until_reset)
+{
+    MedianCalculator<float, NewAllocator, NanPolicy::propagate> calculator;
+    calculator.add(1.0f);
+    calculator.add(std::numeric_limits<float>::quiet_NaN());
+    calculator.add(2.0f);
+    EXPECT_TRUE(std::isnan(calculator.calculate()));
+    calculator.reset();
+    calculator.add(2.0f);
+    EXPECT_DOUBLE_EQ(2.0, calculator.calculate());
+}
+
+TEST(MedianCalculator, nan_values_are_rejected)
+{
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    MedianCalculator<double, NewAllocator, NanPolicy::reject> calculator;
+    calculator.add(1.0);
+    EXPECT_THROW(calculator.add(nan), std::invalid_argument);
+    std::vector<double> values(100, 5.0);
+    values.back() = nan;
+    EXPECT_THROW(calculator.addRange(values.data(), values.data() + values.size()), std::invalid_argument);
+    EXPECT_DOUBLE_EQ(1.0, calculator.calculate()) << "no value of the rejected range is added";
+}
+
+TEST(MedianCalculator, custom_value_type_described_by_median_traits)
+{
+    MedianCalculator<Milli> calculator;
+    EXPECT_EQ(0, calculator.calculate().raw);
+    calculator.add(Milli{1500});
+    calculator.add(Milli{-250});
+    EXPECT_EQ(625, calculator.calculate().raw);
+    std::vector<Milli> values;
+    for (long i = 0; i < 100; i++)
+    {
+        values.push_back(Milli{i * 1000});
+    }
+    calculator.addRange(values.data(), values.data() + values.size());
+    EXPECT_EQ(48500, calculator.calculate().raw);
+}
+
+TEST(MedianCalculator, merge)
+{
+    MedianCalculator<int> calculator;
+    MedianCalculator<int> other;
+    calculator.merge(other);
+    EXPECT_TRUE(std::isnan(calculator.calculate()));
+
+    other.add(3);
+    other.add(10);
+    calculator.merge(other);
+    EXPECT_DOUBLE_EQ(6.5, calculator.calculate());
+
+    other.reset();
+    for (int i = 1; i <= 5; i++)
+    {
+        other.add(i);
+    }
+    calculator.merge(other);
+    EXPECT_DOUBLE_EQ(3.0, calculator.calculate()) << "1 2 3 3 4 5 10";
+    EXPECT_DOUBLE_EQ(3.0, other.calculate()) << "merged calculator is not changed";
+
+    calculator.merge(calculator);
+    EXPECT_DOUBLE_EQ(3.0, calculator.calculate());
+    calculator.add(100);
+    calculator.add(100);
+    calculator.add(100);
+    EXPECT_DOUBLE_EQ(4.0, calculator.calculate()) << "1 1 2 2 3 3 3 3 4 4 5 5 10 10 100 100 100";
+}
+
+TEST(MedianCalculator, merge_propagates_nan)
+{
+    MedianCalculator<double, NewAllocator, NanPolicy::propagate> calculator;
+    MedianCalculator<double, NewAllocator, NanPolicy::propagate> other;
+    calculator.add(1.0);
+    other.add(std::numeric_limits<double>::quiet_NaN());
+    calculator.merge(other);
+    EXPECT_TRUE(std::isnan(calculator.calculate()));
+}
+
 } // anonymous namespace
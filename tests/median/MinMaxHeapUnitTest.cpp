@@ -0,0 +1,98 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/MinMaxHeap.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace ::testing;
+using namespace ::tplx;
+
+TEST(MinMaxHeap, default_constructed_heap_is_empty)
+{
+    MinMaxHeap<int> h;
+    EXPECT_TRUE(h.empty());
+    EXPECT_EQ(0U, h.size());
+}
+
+TEST(MinMaxHeap, min_and_max)
+{
+    MinMaxHeap<int> h;
+    h.insert(21);
+    EXPECT_EQ(21, h.min());
+    EXPECT_EQ(21, h.max());
+    h.insert(63);
+    EXPECT_EQ(21, h.min());
+    EXPECT_EQ(63, h.max());
+    h.insert(15);
+    EXPECT_EQ(15, h.min());
+    EXPECT_EQ(63, h.max());
+    h.insert(75);
+    EXPECT_EQ(15, h.min());
+    EXPECT_EQ(75, h.max());
+    h.insert(-4);
+    EXPECT_EQ(-4, h.min());
+    EXPECT_EQ(75, h.max());
+}
+
+TEST(MinMaxHeap, popMin_and_popMax)
+{
+    MinMaxHeap<int> h;
+    for (int value : {5, 1, 9, 3, 7, 2, 8, 6, 4, 0})
+    {
+        h.insert(value);
+    }
+    h.popMin();
+    EXPECT_EQ(1, h.min());
+    h.popMax();
+    EXPECT_EQ(8, h.max());
+    h.popMax();
+    EXPECT_EQ(7, h.max());
+    h.popMin();
+    EXPECT_EQ(2, h.min());
+    EXPECT_EQ(6U, h.size());
+    EXPECT_THAT(h, UnorderedElementsAre(2, 3, 4, 5, 6, 7));
+}
+
+TEST(MinMaxHeapRegression, random_operations_match_sorted_reference)
+{
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<> values(-50, 50);
+    std::uniform_int_distribution<> operations(0, 3);
+
+    MinMaxHeap<int> h;
+    std::vector<int> reference;
+    for (int i = 0; i < 5000; i++)
+    {
+        const auto operation = operations(generator);
+        if (reference.empty() or operation < 2)
+        {
+            const auto value = values(generator);
+            h.insert(value);
+            reference.push_back(value);
+        }
+        else if (operation == 2)
+        {
+            h.popMin();
+            reference.erase(std::min_element(reference.begin(), reference.end()));
+        }
+        else
+        {
+            h.popMax();
+            reference.erase(std::max_element(reference.begin(), reference.end()));
+        }
+        ASSERT_EQ(reference.size(), h.size());
+        if (not reference.empty())
+        {
+            ASSERT_EQ(*std::min_element(reference.begin(), reference.end()), h.min());
+            ASSERT_EQ(*std::max_element(reference.begin(), reference.end()), h.max());
+        }
+    }
+}
+
+} // anonymous namespace
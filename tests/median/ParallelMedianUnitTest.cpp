@@ -0,0 +1,124 @@
+#include "median/ParallelMedian.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+std::vector<int> randomValues(std::size_t count)
+{
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(-1000000, 1000000);
+    std::vector<int> values(count);
+    for (auto& value : values)
+    {
+        value = distribution(generator);
+    }
+    return values;
+}
+
+TEST(ParallelMedian, empty_range)
+{
+    EXPECT_TRUE(std::isnan(medianOf<int>(nullptr, nullptr, 4)));
+}
+
+TEST(ParallelMedian, short_range_is_processed_by_single_thread)
+{
+    const int values[] = {7, 1, 3, 10};
+    EXPECT_THAT(medianOf(std::begin(values), std::end(values), 8), DoubleEq(5.0));
+}
+
+TEST(ParallelMedian, matches_reference_for_any_number_of_threads)
+{
+    for (std::size_t count : {details::min_parallel_chunk_size * 7 + 3, details::min_parallel_chunk_size * 8})
+    {
+        auto values = randomValues(count);
+        const auto reference = calculateReferenceMedianValue_nth_element_based(values);
+        for (std::size_t threads : {0, 1, 2, 3, 5, 7, 8, 64})
+        {
+            EXPECT_THAT(medianOf(values.data(), values.data() + values.size(), threads), DoubleEq(reference))
+                << count << " values, " << threads << " threads";
+        }
+    }
+}
+
+TEST(ParallelMedian, sorted_chunks)
+{
+    std::vector<double> values(details::min_parallel_chunk_size * 4);
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        values[i] = static_cast<double>(values.size() - i);
+    }
+    EXPECT_THAT(medianOf(values.data(), values.data() + values.size(), 4),
+                DoubleEq(static_cast<double>(values.size() + 1) / 2));
+}
+
+TEST(ParallelMedian, nan_values_are_skipped)
+{
+    std::vector<double> values(details::min_parallel_chunk_size * 4, std::numeric_limits<double>::quiet_NaN());
+    EXPECT_TRUE(std::isnan(medianOf(values.data(), values.data() + values.size(), 4)));
+    for (std::size_t i = values.size() / 2; i < values.size(); i++)
+    {
+        values[i] = static_cast<double>(i % 1000);
+    }
+    std::vector<double> numbers(values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2), values.end());
+    const auto expected = calculateReferenceMedianValue_nth_element_based(numbers);
+    EXPECT_THAT(medianOf(values.data(), values.data() + values.size(), 4), DoubleEq(expected));
+}
+
+TEST(ParallelMedian, chunks_of_different_distributions)
+{
+    // the first chunk holds duplicates of a single value, the remaining ones spread values far above it
+    std::vector<int> values(details::min_parallel_chunk_size * 4, -5);
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(0, 100);
+    for (std::size_t i = values.size() / 4; i < values.size(); i++)
+    {
+        values[i] = distribution(generator);
+    }
+    auto reference = values;
+    const auto expected = calculateReferenceMedianValue_nth_element_based(reference);
+    EXPECT_THAT(medianOf(values.data(), values.data() + values.size(), 4), DoubleEq(expected));
+}
+
+TEST(ParallelMedian, ranges_bigger_than_gathered_values_are_narrowed_in_rounds)
+{
+    // ascending runs of duplicates make the pivots fall on equal values, NaN values shift the ranks
+    std::vector<double> values(details::parallel_gather_size * 3 + 5);
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        values[i] = i % 1001 == 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(i / 7);
+    }
+    std::vector<double> numbers;
+    for (auto value : values)
+    {
+        if (not std::isnan(value))
+        {
+            numbers.push_back(value);
+        }
+    }
+    for (std::size_t count : {numbers.size(), numbers.size() - 1})
+    {
+        std::vector<double> reference(numbers.begin(), numbers.begin() + static_cast<std::ptrdiff_t>(count));
+        const auto expected = calculateReferenceMedianValue_nth_element_based(reference);
+        const auto end = values.data() + values.size() - (numbers.size() - count);
+        for (std::size_t threads : {2, 3, 8})
+        {
+            EXPECT_THAT(medianOf(values.data(), end, threads), DoubleEq(expected)) << count << " values";
+        }
+    }
+    std::vector<int> random = randomValues(details::parallel_gather_size * 2 + 1);
+    auto reference = random;
+    EXPECT_THAT(medianOf(random.data(), random.data() + random.size(), 4),
+                DoubleEq(calculateReferenceMedianValue_nth_element_based(reference)));
+}
+
+} // anonymous namespace
@@ -0,0 +1,113 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/QuantileCalculator.h"
+#include "median/MedianCalculator.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(QuantileCalculator, quantiles_out_of_range_are_rejected)
+{
+    EXPECT_THROW(QuantileCalculator<int>{-0.1}, std::invalid_argument);
+    EXPECT_THROW(QuantileCalculator<int>{1.5}, std::invalid_argument);
+    EXPECT_THROW((QuantileCalculator<int>{0.5, NAN}), std::invalid_argument);
+    EXPECT_THROW((QuantileCalculator<int>{nullptr, nullptr}), std::invalid_argument);
+}
+
+TEST(QuantileCalculator, not_tracked_quantile_is_rejected)
+{
+    QuantileCalculator<int> c{0.5, 0.9};
+    c.add(1);
+    EXPECT_THROW(c.calculate(0.99), std::invalid_argument);
+}
+
+TEST(QuantileCalculator, quantile_of_empty_set_is_nan)
+{
+    QuantileCalculator<int> c{0.5, 0.99};
+    EXPECT_TRUE(std::isnan(c.calculate(0.5)));
+    EXPECT_TRUE(std::isnan(c.calculate(0.99)));
+}
+
+TEST(QuantileCalculator, quantile_0_5_is_median)
+{
+    QuantileCalculator<int> c{0.5};
+    c.add(10);
+    EXPECT_THAT(c.calculate(0.5), DoubleEq(10));
+    c.add(5);
+    EXPECT_THAT(c.calculate(0.5), DoubleEq(7.5));
+    c.add(20);
+    EXPECT_THAT(c.calculate(0.5), DoubleEq(10));
+    c.add(3);
+    EXPECT_THAT(c.calculate(0.5), DoubleEq(7.5));
+}
+
+TEST(QuantileCalculator, extreme_quantiles_are_min_and_max)
+{
+    QuantileCalculator<int> c{0.0, 1.0};
+    for (int value : {4, -2, 17, 8, 3})
+    {
+        c.add(value);
+    }
+    EXPECT_THAT(c.calculate(0.0), DoubleEq(-2));
+    EXPECT_THAT(c.calculate(1.0), DoubleEq(17));
+}
+
+TEST(QuantileCalculator, quantiles_are_interpolated)
+{
+    QuantileCalculator<int> c{0.25, 0.5, 0.9};
+    for (int value = 1; value <= 11; value++)
+    {
+        c.add(value * 10);
+    }
+    EXPECT_THAT(c.calculate(0.25), DoubleEq(35));
+    EXPECT_THAT(c.calculate(0.5), DoubleEq(60));
+    EXPECT_THAT(c.calculate(0.9), DoubleEq(100));
+}
+
+TEST(QuantileCalculator, reset_restarts_calculation)
+{
+    QuantileCalculator<int> c{0.1, 0.5};
+    c.add(20);
+    c.add(10);
+    c.add(30);
+    EXPECT_THAT(c.calculate(0.5), DoubleEq(20));
+    c.reset();
+    EXPECT_EQ(0U, c.size());
+    EXPECT_TRUE(std::isnan(c.calculate(0.5)));
+    c.add(100);
+    EXPECT_THAT(c.calculate(0.1), DoubleEq(100));
+}
+
+TEST(QuantileCalculatorRegression, running_quantiles_for_randomly_generated_numbers)
+{
+    const double quantiles[] = {0.999, 0.5, 0.0, 0.9, 0.99, 0.5, 0.25, 0.3};
+    QuantileCalculator<int> c{std::begin(quantiles), std::end(quantiles)};
+    MedianCalculator<int> median;
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> distribution(-10000, 10000);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 1500; i++)
+    {
+        const auto randomizedValue = distribution(generator) / ((i % 3) + 1);
+        c.add(randomizedValue);
+        median.add(randomizedValue);
+        collected.push_back(randomizedValue);
+        for (auto quantile : quantiles)
+        {
+            EXPECT_THAT(c.calculate(quantile), DoubleEq(calculateReferenceQuantileValue_sort_based(collected, quantile)))
+                << quantile;
+        }
+        EXPECT_THAT(c.calculate(0.5), DoubleEq(median.calculate()));
+    }
+}
+
+} // anonymous namespace
@@ -0,0 +1,96 @@
+#include "median/RadixMedian.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+template <typename T>
+double reference(std::vector<T> values)
+{
+    return calculateReferenceMedianValue_nth_element_based(values);
+}
+
+TEST(RadixMedian, keys_preserve_order)
+{
+    using IntKey = details::RadixKey<int>;
+    EXPECT_LT(IntKey::encode(std::numeric_limits<int>::min()), IntKey::encode(-1));
+    EXPECT_LT(IntKey::encode(-1), IntKey::encode(0));
+    EXPECT_LT(IntKey::encode(0), IntKey::encode(std::numeric_limits<int>::max()));
+    EXPECT_EQ(-12345, IntKey::decode(IntKey::encode(-12345)));
+
+    using DoubleKey = details::RadixKey<double>;
+    const double ordered[] = {-std::numeric_limits<double>::infinity(), -1e300, -2.5, -1e-300, 0.0, 1e-300, 2.5,
+                              1e300, std::numeric_limits<double>::infinity()};
+    for (std::size_t i = 1; i < sizeof(ordered) / sizeof(ordered[0]); i++)
+    {
+        EXPECT_LT(DoubleKey::encode(ordered[i - 1]), DoubleKey::encode(ordered[i])) << ordered[i];
+        EXPECT_EQ(ordered[i], DoubleKey::decode(DoubleKey::encode(ordered[i])));
+    }
+}
+
+TEST(RadixMedian, small_ranges)
+{
+    EXPECT_TRUE(std::isnan(radixMedianOf<int>(nullptr, nullptr, 4)));
+    const int odd[] = {7, -1, 3};
+    EXPECT_THAT(radixMedianOf(std::begin(odd), std::end(odd), 1), DoubleEq(3.0));
+    const int even[] = {7, -1, 3, -100};
+    EXPECT_THAT(radixMedianOf(std::begin(even), std::end(even), 1), DoubleEq(1.0));
+    const short duplicates[] = {5, 5, 5, 5};
+    EXPECT_THAT(radixMedianOf(std::begin(duplicates), std::end(duplicates), 1), DoubleEq(5.0));
+    const unsigned long long big[] = {std::numeric_limits<unsigned long long>::max(), 1, 2};
+    EXPECT_THAT(radixMedianOf(std::begin(big), std::end(big), 1), DoubleEq(2.0));
+}
+
+TEST(RadixMedian, nan_values_are_skipped)
+{
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const float values[] = {nan, 2.5f, -1.0f, nan, 4.0f, 8.0f};
+    EXPECT_THAT(radixMedianOf(std::begin(values), std::end(values), 1), DoubleEq(3.25));
+    const float onlyNan[] = {nan, nan};
+    EXPECT_TRUE(std::isnan(radixMedianOf(std::begin(onlyNan), std::end(onlyNan), 1)));
+}
+
+template <typename T, typename Distribution>
+void expectReferenceMedian(Distribution distribution, std::size_t count)
+{
+    std::mt19937 generator(2019);
+    std::vector<T> values(count);
+    for (auto& value : values)
+    {
+        value = static_cast<T>(distribution(generator));
+    }
+    const auto expected = reference(values);
+    for (std::size_t threads : {1, 3, 8})
+    {
+        EXPECT_THAT(radixMedianOf(values.data(), values.data() + values.size(), threads), DoubleEq(expected))
+            << count << " values, " << threads << " threads";
+    }
+}
+
+TEST(RadixMedian, matches_reference)
+{
+    const auto count = details::min_parallel_chunk_size * 8;
+    for (std::size_t size : {count, count + 1, std::size_t{1001}})
+    {
+        expectReferenceMedian<int>(std::uniform_int_distribution<int>{std::numeric_limits<int>::min(),
+                                                                      std::numeric_limits<int>::max()},
+                                   size);
+        expectReferenceMedian<int>(std::uniform_int_distribution<int>{-3, 3}, size);
+        expectReferenceMedian<long long>(std::uniform_int_distribution<long long>{-1000000000000LL, 1000000000000LL},
+                                         size);
+        expectReferenceMedian<unsigned>(std::uniform_int_distribution<unsigned>{}, size);
+        expectReferenceMedian<double>(std::normal_distribution<double>{0.0, 1e6}, size);
+        expectReferenceMedian<float>(std::normal_distribution<float>{-5.0f, 0.001f}, size);
+    }
+}
+
+} // anonymous namespace
@@ -49,9 +49,36 @@ double calculateReferenceMedianValue_nth_element_based(std::vector<T>& values)
     {
         return *middle;
     }
+    // the second selection may reorder elements following beforeMiddle, so the upper one is read first
+    const auto upper = *middle;
     auto beforeMiddle = std::prev(middle);
     std::nth_element(values.begin(), beforeMiddle, values.end());
-    return (static_cast<double>(*beforeMiddle) + *middle)/2;
+    return (static_cast<double>(*beforeMiddle) + upper)/2;
+}
+
+/**
+    \brief Straightforward but inefficient quantile algorithm used as a reference implementation.
+        Interpolates linearly between values of ranks floor(q*(n-1)) and floor(q*(n-1))+1.
+        Uses std::sort algorithm underneath.
+ */
+template <typename T>
+double calculateReferenceQuantileValue_sort_based(std::vector<T>& values, double quantile)
+{
+    if (values.empty())
+    {
+        return NAN;
+    }
+    std::sort(values.begin(), values.end());
+    const auto position = quantile * static_cast<double>(values.size() - 1);
+    const auto rank = static_cast<std::size_t>(position);
+    const auto fraction = position - static_cast<double>(rank);
+    const double lower = values[rank];
+    if (fraction == 0.0)
+    {
+        return lower;
+    }
+    const double upper = values[rank + 1];
+    return lower + fraction * (upper - lower);
 }
 
 } // namespace tplx
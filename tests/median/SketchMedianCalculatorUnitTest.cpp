@@ -0,0 +1,142 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/SketchMedianCalculator.h"
+#include "median/MedianCalculator.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+/// \brief Returns normalized distance between the rank of the estimate and the rank of the median.
+double medianRankError(std::vector<int>& values, double estimate)
+{
+    std::sort(values.begin(), values.end());
+    const auto less = std::lower_bound(values.begin(), values.end(), estimate) - values.begin();
+    const auto lessOrEqual = std::upper_bound(values.begin(), values.end(), estimate) - values.begin();
+    const auto n = static_cast<double>(values.size());
+    // any rank between less and lessOrEqual is valid for the estimate
+    const auto middle = n / 2;
+    if (middle < less)
+    {
+        return (less - middle) / n;
+    }
+    if (middle > lessOrEqual)
+    {
+        return (middle - lessOrEqual) / n;
+    }
+    return 0.0;
+}
+
+TEST(SketchMedianCalculator, median_of_empty_set_is_nan)
+{
+    EXPECT_TRUE(std::isnan(SketchMedianCalculator<int>{}.calculate()));
+}
+
+TEST(SketchMedianCalculator, accuracy_parameter_follows_rank_error)
+{
+    const auto k = SketchMedianCalculator<int>::accuracyForRankError(0.01);
+    SketchMedianCalculator<int> c{k};
+    EXPECT_LE(c.rankError(), 0.01);
+    EXPECT_LT(SketchMedianCalculator<int>{2 * k}.maxRetained(), SketchMedianCalculator<int>{4 * k}.maxRetained());
+}
+
+TEST(SketchMedianCalculator, result_is_exact_until_k_values_are_collected)
+{
+    SketchMedianCalculator<int> c{100};
+    MedianCalculator<int> reference;
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<> distribution(-10000, 10000);
+    for (int i = 0; i < 99; i++)
+    {
+        const auto value = distribution(generator);
+        c.add(value);
+        reference.add(value);
+        EXPECT_THAT(c.calculate(), DoubleEq(reference.calculate()));
+    }
+}
+
+TEST(SketchMedianCalculator, reset_restarts_calculation)
+{
+    SketchMedianCalculator<int> c{8};
+    for (int i = 0; i < 1000; i++)
+    {
+        c.add(i);
+    }
+    c.reset();
+    EXPECT_EQ(0U, c.size());
+    EXPECT_EQ(0U, c.retained());
+    EXPECT_TRUE(std::isnan(c.calculate()));
+    c.add(100);
+    EXPECT_THAT(c.calculate(), DoubleEq(100));
+}
+
+struct SketchMedianCalculatorRegression : TestWithParam<double>
+{
+};
+
+TEST_P(SketchMedianCalculatorRegression, rank_error_and_memory_are_bounded)
+{
+    const auto rankError = GetParam();
+    SketchMedianCalculator<int> c{SketchMedianCalculator<int>::accuracyForRankError(rankError)};
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> uniform(-1000000, 1000000);
+    std::normal_distribution<> normal(5000, 300);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 300000; i++)
+    {
+        // the first part of the stream is skewed towards lower values, the next one is a mix
+        const auto value = i < 100000 ? uniform(generator) / 1000 : static_cast<int>(normal(generator));
+        c.add(value);
+        collected.push_back(value);
+        ASSERT_LE(c.retained(), c.maxRetained());
+        if (i % 50000 == 49999)
+        {
+            EXPECT_LE(medianRankError(collected, c.calculate()), rankError) << "after " << i + 1 << " values";
+        }
+    }
+    EXPECT_EQ(collected.size(), c.size());
+    EXPECT_LE(medianRankError(collected, c.calculate()), rankError);
+    EXPECT_THAT(calculateReferenceMedianValue_nth_element_based(collected), DoubleNear(c.calculate(), 1000));
+}
+
+TEST(SketchMedianCalculatorRegression, merged_sketches_summarize_all_values)
+{
+    constexpr double rankError = 0.01;
+    const auto k = SketchMedianCalculator<int>::accuracyForRankError(rankError);
+    SketchMedianCalculator<int> first{k};
+    SketchMedianCalculator<int> second{k};
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<> lower(0, 100000);
+    std::uniform_int_distribution<> upper(50000, 200000);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 100000; i++)
+    {
+        const auto a = lower(generator);
+        const auto b = upper(generator);
+        first.add(a);
+        second.add(b);
+        collected.push_back(a);
+        collected.push_back(b);
+    }
+    first.merge(second);
+    EXPECT_EQ(collected.size(), first.size());
+    EXPECT_LE(first.retained(), first.maxRetained());
+    EXPECT_LE(medianRankError(collected, first.calculate()), rankError);
+}
+
+} // anonymous namespace
+
+INSTANTIATE_TEST_CASE_P(SketchMedianCalculatorRegressionParametrized,
+                        SketchMedianCalculatorRegression,
+                        Values(0.05, 0.01, 0.005));
@@ -0,0 +1,240 @@
+#include "median/Snapshot.h"
+#include "median/SnapshotFile.h"
+#include "median/MedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <csignal>
+#include <system_error>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+using namespace ::testing;
+using namespace ::tplx;
+
+constexpr std::uint32_t magic_value = SnapshotHeader::magic_value;
+constexpr std::uint16_t current_version = SnapshotHeader::current_version;
+constexpr std::uint32_t nan_added = SnapshotHeader::nan_added;
+
+template <typename Calculator>
+std::vector<std::uint64_t> saveSnapshot(const Calculator& c)
+{
+    std::vector<std::uint64_t> buffer((c.snapshotSize() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    c.saveSnapshot(buffer.data());
+    return buffer;
+}
+
+template <typename Calculator, typename T>
+void addAll(Calculator& c, std::initializer_list<T> values)
+{
+    c.addRange(values.begin(), values.end());
+}
+
+SnapshotHeader headerOf(const std::vector<std::uint64_t>& snapshot)
+{
+    SnapshotHeader header;
+    std::memcpy(&header, snapshot.data(), sizeof(header));
+    return header;
+}
+
+void storeHeader(std::vector<std::uint64_t>& snapshot, const SnapshotHeader& header)
+{
+    std::memcpy(snapshot.data(), &header, sizeof(header));
+}
+
+std::string temporaryPath(const char* name)
+{
+    return std::string{::testing::TempDir()} + name;
+}
+
+TEST(Snapshot, header_describes_the_state)
+{
+    MedianCalculator<int> c;
+    addAll(c, {5, 1, 9, 3, 7});
+    EXPECT_EQ(sizeof(SnapshotHeader) + 5 * sizeof(int), c.snapshotSize());
+    const auto header = headerOf(saveSnapshot(c));
+    EXPECT_EQ(magic_value, header.magic);
+    EXPECT_EQ(current_version, header.version);
+    EXPECT_EQ(sizeof(int), header.valueSize);
+    EXPECT_EQ(SnapshotHeader::signed_value, header.valueKind);
+    EXPECT_EQ(0U, header.flags);
+    EXPECT_EQ(5U, header.lowerSize + header.upperSize);
+}
+
+TEST(Snapshot, empty_calculator_round_trip)
+{
+    MedianCalculator<int> c;
+    const auto snapshot = saveSnapshot(c);
+    MedianCalculator<int> restored;
+    restored.add(3);
+    restored.restoreSnapshot(snapshot.data(), c.snapshotSize());
+    EXPECT_TRUE(std::isnan(restored.calculate()));
+    restored.add(4);
+    EXPECT_THAT(restored.calculate(), DoubleEq(4));
+}
+
+TEST(Snapshot, restored_calculator_continues_the_stream)
+{
+    MedianCalculator<double, NewAllocator, NanPolicy::propagate> c;
+    addAll(c, {1.5, -2.0, 8.25, 4.0});
+    MedianCalculator<double, NewAllocator, NanPolicy::propagate> restored;
+    restored.restoreSnapshot(saveSnapshot(c).data(), c.snapshotSize());
+    EXPECT_THAT(restored.calculate(), DoubleEq(2.75));
+    restored.add(10.0);
+    EXPECT_THAT(restored.calculate(), DoubleEq(4.0));
+
+    c.add(NAN);
+    EXPECT_EQ(nan_added, headerOf(saveSnapshot(c)).flags);
+    restored.restoreSnapshot(saveSnapshot(c).data(), c.snapshotSize());
+    EXPECT_TRUE(std::isnan(restored.calculate()));
+}
+
+TEST(Snapshot, restore_rejects_malformed_snapshots)
+{
+    MedianCalculator<int> c;
+    addAll(c, {1, 2, 3, 4});
+    const auto valid = saveSnapshot(c);
+    const auto size = c.snapshotSize();
+
+    MedianCalculator<int> restored;
+    restored.add(100);
+    EXPECT_THROW(restored.restoreSnapshot(valid.data(), sizeof(SnapshotHeader) - 1), std::invalid_argument);
+    EXPECT_TRUE(std::isnan(restored.calculate())) << "calculator is reset on failure";
+    EXPECT_THROW(restored.restoreSnapshot(valid.data(), size - 1), std::invalid_argument);
+    EXPECT_THROW(restored.restoreSnapshot(valid.data(), size - sizeof(int)), std::invalid_argument);
+
+    auto snapshot = valid;
+    auto header = headerOf(valid);
+    header.magic = 0;
+    storeHeader(snapshot, header);
+    EXPECT_THROW(restored.restoreSnapshot(snapshot.data(), size), std::invalid_argument);
+
+    header = headerOf(valid);
+    header.version = current_version + 1;
+    storeHeader(snapshot, header);
+    EXPECT_THROW(restored.restoreSnapshot(snapshot.data(), size), std::invalid_argument);
+
+    header = headerOf(valid);
+    header.lowerSize = 4;
+    header.upperSize = 0;
+    storeHeader(snapshot, header);
+    EXPECT_THROW(restored.restoreSnapshot(snapshot.data(), size), std::invalid_argument);
+
+    MedianCalculator<unsigned> otherType;
+    EXPECT_THROW(otherType.restoreSnapshot(valid.data(), size), std::invalid_argument);
+    MedianCalculator<float> otherKind;
+    EXPECT_THROW(otherKind.restoreSnapshot(valid.data(), size), std::invalid_argument);
+
+    restored.restoreSnapshot(valid.data(), size);
+    EXPECT_THAT(restored.calculate(), DoubleEq(2.5));
+}
+
+TEST(Snapshot, restore_rejects_inconsistent_values)
+{
+    MedianCalculator<int> c;
+    addAll(c, {1, 2, 3, 4});
+    const auto valid = saveSnapshot(c);
+    const auto size = c.snapshotSize();
+    auto corrupt = [&](std::initializer_list<int> values) {
+        auto snapshot = valid;
+        std::memcpy(reinterpret_cast<char*>(snapshot.data()) + sizeof(SnapshotHeader), values.begin(),
+                    values.size() * sizeof(int));
+        return snapshot;
+    };
+
+    MedianCalculator<int> restored;
+    EXPECT_THROW(restored.restoreSnapshot(corrupt({3, 4, 1, 2}).data(), size), std::invalid_argument)
+        << "lower half is not a max-heap";
+    EXPECT_THROW(restored.restoreSnapshot(corrupt({2, 1, 4, 3}).data(), size), std::invalid_argument)
+        << "upper half is not a min-heap";
+    EXPECT_THROW(restored.restoreSnapshot(corrupt({4, 3, 1, 2}).data(), size), std::invalid_argument)
+        << "lower half holds values greater than the upper half";
+    EXPECT_TRUE(std::isnan(restored.calculate()));
+
+    MedianCalculator<int> single;
+    single.add(7);
+    auto snapshot = saveSnapshot(single);
+    auto header = headerOf(snapshot);
+    header.lowerSize = 0;
+    header.upperSize = 1;
+    storeHeader(snapshot, header);
+    EXPECT_THROW(restored.restoreSnapshot(snapshot.data(), single.snapshotSize()), std::invalid_argument)
+        << "lower half is empty";
+}
+
+TEST(Snapshot, file_round_trip)
+{
+    const auto path = temporaryPath("running_median_snapshot_test.bin");
+    MedianCalculator<long long> c;
+    for (long long i = 0; i < 100001; i++)
+    {
+        c.add((i * 7919) % 100003);
+    }
+    saveSnapshotFile(c, path.c_str());
+
+    MedianCalculator<long long> restored;
+    loadSnapshotFile(restored, path.c_str());
+    EXPECT_THAT(restored.calculate(), DoubleEq(c.calculate()));
+    c.add(-1);
+    restored.add(-1);
+    EXPECT_THAT(restored.calculate(), DoubleEq(c.calculate()));
+
+    MedianCalculator<int> otherType;
+    EXPECT_THROW(loadSnapshotFile(otherType, path.c_str()), std::invalid_argument);
+    std::remove(path.c_str());
+    EXPECT_THROW(loadSnapshotFile(restored, path.c_str()), std::system_error);
+}
+
+TEST(Snapshot, temporary_file_is_removed_if_saving_fails)
+{
+    // a directory cannot be replaced by the snapshot file
+    const auto path = temporaryPath("running_median_snapshot_test_directory");
+    ASSERT_EQ(0, ::mkdir(path.c_str(), 0755));
+    MedianCalculator<int> c;
+    c.add(1);
+    EXPECT_THROW(saveSnapshotFile(c, path.c_str()), std::system_error);
+    EXPECT_NE(0, ::access((path + ".tmp").c_str(), F_OK));
+    ::rmdir(path.c_str());
+}
+
+TEST(Snapshot, saving_fails_without_removing_the_previous_file_if_space_cannot_be_allocated)
+{
+    const auto path = temporaryPath("running_median_snapshot_test_no_space.bin");
+    MedianCalculator<int> previous;
+    previous.add(7);
+    saveSnapshotFile(previous, path.c_str());
+
+    MedianCalculator<int> c;
+    for (int i = 0; i < 1000; i++)
+    {
+        c.add(i);
+    }
+    // the file size limit makes allocating blocks of the temporary file fail like a full disk does
+    rlimit original;
+    ASSERT_EQ(0, ::getrlimit(RLIMIT_FSIZE, &original));
+    const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = original;
+    limited.rlim_cur = 1024;
+    ASSERT_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limited));
+    EXPECT_THROW(saveSnapshotFile(c, path.c_str()), std::system_error);
+    ::setrlimit(RLIMIT_FSIZE, &original);
+    std::signal(SIGXFSZ, handler);
+
+    EXPECT_NE(0, ::access((path + ".tmp").c_str(), F_OK));
+    MedianCalculator<int> restored;
+    loadSnapshotFile(restored, path.c_str());
+    EXPECT_THAT(restored.calculate(), DoubleEq(7));
+    std::remove(path.c_str());
+}
+
+} // anonymous namespace
@@ -0,0 +1,84 @@
+#include "median/Stats.h"
+#include "median/HeapStorage.h"
+#include "median/MedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace ::testing;
+using namespace ::tplx;
+
+using CountingCalculator = MedianCalculator<int, NewAllocator, NanPolicy::skip, CollectStats>;
+
+static_assert(sizeof(MaxHeap<int, 2, NewAllocator, NoStats>) == sizeof(details::HeapStorage<int>) + sizeof(void*),
+              "disabled statistics take no space");
+
+TEST(Stats, heap_storage_reports_reallocations_and_copied_bytes)
+{
+    details::HeapStorage<int, NewAllocator, CollectStats> storage;
+    for (int i = 0; i < 5; i++)
+    {
+        storage.push_back(i);
+    }
+    const auto stats = storage.stats().snapshot();
+    EXPECT_EQ(4U, stats.reallocations) << "capacity 1, 2, 4 and 8";
+    EXPECT_EQ((1U + 2U + 4U) * sizeof(int), stats.bytesCopied);
+}
+
+TEST(Stats, heap_reports_sift_depths)
+{
+    MaxHeap<int, 2, NewAllocator, CollectStats> heap;
+    heap.insert(1);
+    heap.insert(2);
+    heap.insert(3);
+    heap.pop();
+    const auto stats = heap.stats().snapshot();
+    EXPECT_EQ(1U, stats.siftUpDepths[0]);
+    EXPECT_EQ(2U, stats.siftUpDepths[1]);
+    EXPECT_EQ(1U, stats.siftDownDepths[0]);
+    EXPECT_EQ(0U, stats.siftDownDepths[1]);
+}
+
+TEST(Stats, median_calculator_sums_statistics_of_both_halves)
+{
+    CountingCalculator calculator;
+    for (auto value : {1, 2, 0, 5, -1, -2})
+    {
+        calculator.add(value);
+    }
+    auto stats = calculator.stats();
+    EXPECT_EQ(1U, stats.rebalances) << "only the last value moves the top of the lower half";
+    EXPECT_EQ(6U, stats.reallocations) << "capacity 1, 2 and 4 of each half";
+    std::uint64_t siftUps = 0;
+    for (auto count : stats.siftUpDepths)
+    {
+        siftUps += count;
+    }
+    EXPECT_EQ(6U, siftUps) << "the last value replaces the top of the lower half instead of being inserted";
+
+    calculator.reset();
+    EXPECT_EQ(1U, calculator.stats().rebalances) << "statistics survive reset";
+
+    std::vector<int> values(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        values[static_cast<std::size_t>(i)] = -i;
+    }
+    calculator.addRange(values.data(), values.data() + values.size());
+    calculator.addRange(values.data(), values.data() + values.size());
+    EXPECT_GT(calculator.stats().rebalances, 1U);
+}
+
+TEST(Stats, disabled_statistics_are_empty)
+{
+    MedianCalculator<int> calculator;
+    calculator.add(1);
+    calculator.add(2);
+    const auto stats = calculator.stats();
+    EXPECT_EQ(0U, stats.reallocations);
+    EXPECT_EQ(0U, stats.siftUpDepths[0]);
+}
+
+} // namespace
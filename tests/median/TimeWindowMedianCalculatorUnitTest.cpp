@@ -0,0 +1,131 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/TimeWindowMedianCalculator.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <climits>
+#include <random>
+#include <utility>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(TimeWindowMedianCalculator, median_of_empty_window_is_nan)
+{
+    TimeWindowMedianCalculator<int> c{5};
+    EXPECT_TRUE(std::isnan(c.calculate()));
+    EXPECT_TRUE(std::isnan(c.calculate(100)));
+    EXPECT_EQ(5, c.duration());
+}
+
+TEST(TimeWindowMedianCalculator, values_older_than_duration_expire)
+{
+    TimeWindowMedianCalculator<int> c{5};
+    c.add(10, 0);
+    c.add(20, 1);
+    c.add(30, 2);
+    EXPECT_THAT(c.calculate(), DoubleEq(20));
+    c.add(1, 5); // 10 expires
+    EXPECT_EQ(3U, c.size());
+    EXPECT_THAT(c.calculate(), DoubleEq(20));
+    EXPECT_THAT(c.calculate(6), DoubleEq(15.5)) << "20 expires";
+    EXPECT_THAT(c.calculate(7), DoubleEq(1)) << "30 expires";
+    EXPECT_EQ(1U, c.size());
+}
+
+TEST(TimeWindowMedianCalculator, values_with_equal_timestamps_expire_together)
+{
+    TimeWindowMedianCalculator<int> c{10};
+    c.add(1, 3);
+    c.add(2, 3);
+    c.add(3, 3);
+    c.add(4, 4);
+    EXPECT_THAT(c.calculate(12), DoubleEq(2.5));
+    EXPECT_THAT(c.calculate(13), DoubleEq(4));
+}
+
+TEST(TimeWindowMedianCalculator, quiet_period_expires_everything)
+{
+    TimeWindowMedianCalculator<int> c{5};
+    for (int i = 0; i < 100; i++)
+    {
+        c.add(i, i);
+    }
+    EXPECT_TRUE(std::isnan(c.calculate(1000)));
+    EXPECT_EQ(0U, c.size());
+    c.add(42, 1001);
+    EXPECT_THAT(c.calculate(), DoubleEq(42));
+}
+
+TEST(TimeWindowMedianCalculator, nothing_expires_before_the_earliest_timestamp)
+{
+    TimeWindowMedianCalculator<int> c{10};
+    c.add(1, LLONG_MIN);
+    c.add(2, LLONG_MIN + 3);
+    EXPECT_THAT(c.calculate(LLONG_MIN + 5), DoubleEq(1.5));
+    EXPECT_THAT(c.calculate(LLONG_MIN + 10), DoubleEq(2)) << "1 expires";
+    EXPECT_EQ(1U, c.size());
+}
+
+TEST(TimeWindowMedianCalculator, reset_restarts_calculation)
+{
+    TimeWindowMedianCalculator<int> c{100};
+    c.add(20, 1);
+    c.add(10, 2);
+    c.add(30, 3);
+    EXPECT_THAT(c.calculate(), DoubleEq(20));
+    c.reset();
+    EXPECT_TRUE(std::isnan(c.calculate()));
+    c.add(100, 0);
+    EXPECT_THAT(c.calculate(), DoubleEq(100));
+}
+
+void checkRandomlyGeneratedNumbersAndBursts(int minValue, int maxValue)
+{
+    constexpr Timestamp duration = 50;
+    TimeWindowMedianCalculator<int> c{duration};
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<> values(minValue, maxValue);
+    std::uniform_int_distribution<> gaps(0, 4);
+    std::uniform_int_distribution<> quietPeriods(0, 40);
+
+    std::vector<std::pair<Timestamp, int>> collected;
+    Timestamp now = 0;
+    for (std::size_t i = 0; i < 3000; i++)
+    {
+        // every now and then there is a longer gap making most of the window expire at once
+        now += (i % 100 == 0) ? quietPeriods(generator) : gaps(generator);
+        const auto value = values(generator);
+        c.add(value, now);
+        collected.emplace_back(now, value);
+
+        std::vector<int> window;
+        for (const auto& sample : collected)
+        {
+            if (sample.first > now - duration)
+            {
+                window.push_back(sample.second);
+            }
+        }
+        ASSERT_EQ(window.size(), c.size());
+        EXPECT_THAT(c.calculate(), DoubleEq(calculateReferenceMedianValue_sort_based(window)));
+    }
+}
+
+TEST(TimeWindowMedianCalculatorRegression, running_median_for_randomly_generated_numbers_and_bursts)
+{
+    checkRandomlyGeneratedNumbersAndBursts(-1000, 1000);
+}
+
+TEST(TimeWindowMedianCalculatorRegression, running_median_for_many_equal_numbers_and_bursts)
+{
+    // rebuilding halves after a burst has to split runs of values equal to the median
+    checkRandomlyGeneratedNumbersAndBursts(0, 3);
+}
+
+} // anonymous namespace
@@ -0,0 +1,105 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "median/WindowMedianCalculator.h"
+#include "ReferenceMedianCalculator.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace
+{
+
+using namespace ::tplx;
+using namespace ::testing;
+
+TEST(WindowMedianCalculator, median_of_empty_window_is_nan)
+{
+    EXPECT_TRUE(std::isnan(WindowMedianCalculator<int>{3}.calculate()));
+}
+
+TEST(WindowMedianCalculator, behaves_like_median_calculator_until_window_is_full)
+{
+    WindowMedianCalculator<int> c{10};
+    c.add(10);
+    EXPECT_THAT(c.calculate(), DoubleEq(10));
+    c.add(5);
+    EXPECT_THAT(c.calculate(), DoubleEq(7.5));
+    c.add(20);
+    EXPECT_THAT(c.calculate(), DoubleEq(10));
+    c.add(3);
+    EXPECT_THAT(c.calculate(), DoubleEq(7.5));
+    EXPECT_EQ(4U, c.size());
+    EXPECT_EQ(10U, c.windowSize());
+}
+
+TEST(WindowMedianCalculator, oldest_values_are_evicted)
+{
+    WindowMedianCalculator<int> c{3};
+    c.add(1);
+    c.add(2);
+    c.add(3);
+    EXPECT_THAT(c.calculate(), DoubleEq(2));
+    c.add(100); // window: 2 3 100
+    EXPECT_THAT(c.calculate(), DoubleEq(3));
+    c.add(200); // window: 3 100 200
+    EXPECT_THAT(c.calculate(), DoubleEq(100));
+    c.add(-5); // window: 100 200 -5
+    EXPECT_THAT(c.calculate(), DoubleEq(100));
+    c.add(-6); // window: 200 -5 -6
+    EXPECT_THAT(c.calculate(), DoubleEq(-5));
+    EXPECT_EQ(3U, c.size());
+}
+
+TEST(WindowMedianCalculator, window_of_single_value)
+{
+    WindowMedianCalculator<int> c{1};
+    c.add(7);
+    EXPECT_THAT(c.calculate(), DoubleEq(7));
+    c.add(-7);
+    EXPECT_THAT(c.calculate(), DoubleEq(-7));
+    EXPECT_EQ(1U, c.size());
+}
+
+TEST(WindowMedianCalculator, reset_restarts_calculation)
+{
+    WindowMedianCalculator<int> c{2};
+    c.add(20);
+    c.add(10);
+    c.add(30);
+    EXPECT_THAT(c.calculate(), DoubleEq(20));
+    c.reset();
+    EXPECT_TRUE(std::isnan(c.calculate()));
+    EXPECT_EQ(0U, c.size());
+    c.add(100);
+    EXPECT_THAT(c.calculate(), DoubleEq(100));
+}
+
+struct WindowMedianCalculatorRegression : TestWithParam<std::size_t>
+{
+};
+
+TEST_P(WindowMedianCalculatorRegression, running_median_for_randomly_generated_numbers)
+{
+    const auto windowSize = GetParam();
+    WindowMedianCalculator<int> c{windowSize};
+
+    std::mt19937 generator(static_cast<unsigned>(windowSize));
+    std::uniform_int_distribution<> distribution(-100, 100);
+
+    std::vector<int> collected;
+    for (std::size_t i = 0; i < 2000; i++)
+    {
+        const auto randomizedValue = distribution(generator);
+        c.add(randomizedValue);
+        collected.push_back(randomizedValue);
+        const auto windowBegin = collected.size() > windowSize ? collected.end() - windowSize : collected.begin();
+        std::vector<int> window(windowBegin, collected.end());
+        EXPECT_THAT(c.calculate(), DoubleEq(calculateReferenceMedianValue_sort_based(window)));
+    }
+}
+
+} // anonymous namespace
+
+INSTANTIATE_TEST_CASE_P(WindowMedianCalculatorRegressionParametrized,
+                        WindowMedianCalculatorRegression,
+                        Values(1, 2, 3, 4, 7, 16, 101, 500));
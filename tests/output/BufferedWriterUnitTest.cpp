@@ -0,0 +1,50 @@
+#include "output/BufferedWriter.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+using namespace ::tplx;
+
+TEST(BufferedWriter, output_is_passed_to_stream_on_flush)
+{
+    std::ostringstream out;
+    BufferedWriter writer{out};
+    writer.write(4.0);
+    writer.write(' ');
+    writer.write(5.5);
+    writer.write(' ');
+    EXPECT_EQ("", out.str());
+    writer.flush();
+    EXPECT_EQ("4 5.5 ", out.str());
+}
+
+TEST(BufferedWriter, output_is_flushed_upon_destruction)
+{
+    std::ostringstream out;
+    {
+        BufferedWriter writer{out};
+        writer.write(1e7);
+    }
+    EXPECT_EQ("1e+07", out.str());
+}
+
+TEST(BufferedWriter, output_exceeding_capacity_is_written_in_chunks)
+{
+    std::ostringstream out;
+    std::ostringstream expected;
+    BufferedWriter writer{out};
+    for (int i = 0; i < 100000; i++)
+    {
+        writer.write(i + 0.5);
+        writer.write(' ');
+        expected << i + 0.5 << ' ';
+    }
+    EXPECT_FALSE(out.str().empty());
+    writer.flush();
+    EXPECT_EQ(expected.str(), out.str());
+}
+
+} // anonymous namespace
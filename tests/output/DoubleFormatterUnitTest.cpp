@@ -0,0 +1,91 @@
+#include "output/DoubleFormatter.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+using namespace ::tplx;
+
+std::string formatted(double value)
+{
+    char buffer[max_formatted_double_length];
+    return std::string(buffer, formatDouble(value, buffer));
+}
+
+std::string streamed(double value)
+{
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+TEST(DoubleFormatter, formats_integers_and_halves)
+{
+    EXPECT_EQ("0", formatted(0.0));
+    EXPECT_EQ("-0", formatted(-0.0));
+    EXPECT_EQ("7", formatted(7.0));
+    EXPECT_EQ("5.5", formatted(5.5));
+    EXPECT_EQ("-0.5", formatted(-0.5));
+    EXPECT_EQ("999999", formatted(999999.0));
+    EXPECT_EQ("99999.5", formatted(99999.5));
+    EXPECT_EQ("1e+06", formatted(1000000.0));
+    EXPECT_EQ("123456", formatted(123456.5));
+    EXPECT_EQ("2.14748e+09", formatted(2147483647.0));
+    EXPECT_EQ("500000", formatted(500000.5)) << "ties are rounded to even";
+    EXPECT_EQ("500002", formatted(500001.5)) << "ties are rounded to even";
+    EXPECT_EQ("1.2e+07", formatted(12000050.0)) << "ties are rounded to even";
+    EXPECT_EQ("1.20002e+07", formatted(12000150.0)) << "ties are rounded to even";
+    EXPECT_EQ("1.20001e+07", formatted(12000050.5));
+    EXPECT_EQ("1e+06", formatted(999999.5));
+    EXPECT_EQ("1e+10", formatted(9999995000.0));
+}
+
+TEST(DoubleFormatter, is_identical_to_stream_output)
+{
+    const double special[] = {NAN,
+                              -NAN,
+                              INFINITY,
+                              -INFINITY,
+                              0.25,
+                              1e-5,
+                              1.0 / 3,
+                              999999.5,
+                              1000000.5,
+                              -123456.5,
+                              4503599627370495.5,
+                              9007199254740991.0,
+                              9007199254740992.0,
+                              1e100,
+                              std::numeric_limits<double>::max(),
+                              -std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::denorm_min()};
+    for (auto value : special)
+    {
+        EXPECT_EQ(streamed(value), formatted(value)) << value;
+    }
+
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<int> distribution(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    std::uniform_int_distribution<int> small(-3000000, 3000000);
+    std::uniform_int_distribution<long long> huge(-(1LL << 52), 1LL << 52);
+    for (int i = 0; i < 100000; i++)
+    {
+        const auto value = static_cast<double>(huge(generator)) / 2;
+        ASSERT_EQ(streamed(value), formatted(value)) << value;
+    }
+    for (int i = 0; i < 100000; i++)
+    {
+        // medians of integral values are either integers or halves
+        const auto a = (i % 2 == 0) ? distribution(generator) : small(generator);
+        const auto b = (i % 2 == 0) ? distribution(generator) : small(generator);
+        const auto value = (static_cast<double>(a) + b) / 2;
+        ASSERT_EQ(streamed(value), formatted(value)) << a << ' ' << b;
+    }
+}
+
+} // anonymous namespace
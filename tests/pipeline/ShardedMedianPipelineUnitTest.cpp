@@ -0,0 +1,101 @@
+// NOTE: STL headers are used here for generating random numbers used for regression test
+
+#include "pipeline/ShardedMedianPipeline.h"
+#include "events/EventLoop.h"
+#include "../median/ReferenceMedianCalculator.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace ::tplx;
+
+TEST(ShardedMedianPipeline, streams_are_spread_over_shards)
+{
+    std::ostringstream out;
+    ShardedMedianPipeline<int> pipeline{out, 4};
+    std::size_t perShard[4] = {};
+    for (StreamId stream = 0; stream < 4000; stream++)
+    {
+        const auto shard = pipeline.shardOf(stream);
+        ASSERT_LT(shard, 4U);
+        ++perShard[shard];
+    }
+    for (auto count : perShard)
+    {
+        EXPECT_GT(count, 800U);
+    }
+}
+
+TEST(ShardedMedianPipeline, results_are_written_in_input_order)
+{
+    std::istringstream input{"3 1:5 2:7 1:9 m 1:m 2:m 3:m 1:q 1:m 4 m"};
+    std::ostringstream out;
+    {
+        ShardedMedianPipeline<int> pipeline{out, 3};
+        runEventLoop(input, pipeline);
+    }
+    EXPECT_EQ("3 7 7 nan nan 3.5 ", out.str());
+}
+
+struct ShardedMedianPipelineTest : ::testing::TestWithParam<std::size_t>
+{
+};
+
+TEST_P(ShardedMedianPipelineTest, matches_reference_for_randomly_generated_streams)
+{
+    std::mt19937 generator(2019);
+    std::uniform_int_distribution<StreamId> streams(0, 50);
+    std::uniform_int_distribution<int> values(1, 1000);
+    std::uniform_int_distribution<int> actions(0, 9);
+
+    std::ostringstream input;
+    std::ostringstream expected;
+    std::map<StreamId, std::vector<int>> reference;
+    for (std::size_t i = 0; i < 50000; i++)
+    {
+        const auto stream = streams(generator);
+        if (stream != default_stream)
+        {
+            input << stream << ':';
+        }
+        const auto action = actions(generator);
+        if (action < 6)
+        {
+            const auto value = values(generator);
+            input << value;
+            reference[stream].push_back(value);
+        }
+        else if (action < 9)
+        {
+            input << 'm';
+            auto copy = reference[stream];
+            expected << calculateReferenceMedianValue_nth_element_based(copy) << ' ';
+        }
+        else
+        {
+            input << 'q';
+            reference[stream].clear();
+        }
+        input << ' ';
+    }
+
+    std::istringstream source{input.str()};
+    std::ostringstream out;
+    {
+        ShardedMedianPipeline<int> pipeline{out, GetParam(), 16};
+        runEventLoop(source, pipeline);
+    }
+    EXPECT_EQ(expected.str(), out.str());
+}
+
+INSTANTIATE_TEST_CASE_P(ShardedMedianPipelineTestParametrized,
+                        ShardedMedianPipelineTest,
+                        ::testing::Values(1U, 2U, 3U, 8U));
+
+} // anonymous namespace
@@ -0,0 +1,62 @@
+#include "pipeline/SpscQueue.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace
+{
+
+using namespace ::tplx;
+
+TEST(SpscQueue, capacity_is_rounded_up_to_power_of_two)
+{
+    EXPECT_EQ(2U, SpscQueue<int>{0}.capacity());
+    EXPECT_EQ(8U, SpscQueue<int>{5}.capacity());
+    EXPECT_EQ(8U, SpscQueue<int>{8}.capacity());
+}
+
+TEST(SpscQueue, items_are_removed_in_insertion_order)
+{
+    SpscQueue<int> queue{4};
+    int item = 0;
+    EXPECT_FALSE(queue.tryPop(item)) << "queue is initially empty";
+
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_TRUE(queue.tryPush(3));
+    EXPECT_TRUE(queue.tryPush(4));
+    EXPECT_FALSE(queue.tryPush(5)) << "queue is full";
+
+    EXPECT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(1, item);
+    EXPECT_TRUE(queue.tryPush(5)) << "removed item makes room for a new one";
+    for (int expected = 2; expected <= 5; expected++)
+    {
+        EXPECT_EQ(expected, queue.pop());
+    }
+    EXPECT_FALSE(queue.tryPop(item));
+}
+
+TEST(SpscQueue, passes_items_between_threads)
+{
+    constexpr long long count = 1000000;
+    SpscQueue<long long> queue{64};
+    std::thread producer{[&queue] {
+        for (long long i = 0; i < count; i++)
+        {
+            queue.push(i);
+        }
+    }};
+    long long sum = 0;
+    bool ordered = true;
+    for (long long i = 0; i < count; i++)
+    {
+        const auto item = queue.pop();
+        ordered = ordered and item == i;
+        sum += item;
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(count * (count - 1) / 2, sum);
+}
+
+} // anonymous namespace